@@ -0,0 +1,44 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+// cpp
+#include <functional>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Timing helpers shared by the benchmarks. Every benchmark prints one line per measured case,
+// GL calls go to the stubbed function table, so only the CPU side of the library is measured.
+class Benchmark {
+public:
+    // milliseconds taken by the fastest of repeats runs of function
+    static double measure(const size_t& repeats, const function<void(void)>& function);
+
+    static void report(const string& name, const double& value, const string& unit = string("ms"));
+};
+
+// one entry point per benchmark source, run in this order by main
+void benchmarkTransforms(void);
+
+void benchmarkPropagation(void);
+
+void benchmarkCulling(void);
+
+void benchmarkUniforms(void);
+
+void benchmarkRenderQueue(void);
+
+void benchmarkInstancing(void);
+
+void benchmarkVertexFormats(void);
+
+void benchmarkIndirect(void);
+
+void benchmarkDualQuaternions(void);
+
+void benchmarkJobSystem(void);
+
+void benchmarkDestroy(void);
+
+#endif // !BENCHMARK_HPP
@@ -0,0 +1,23 @@
+#include <Benchmark.hpp>
+
+// cpp
+#include <chrono>
+#include <cfloat>
+#include <algorithm>
+#include <iomanip>
+
+double Benchmark::measure(const size_t& repeats, const function<void(void)>& function) {
+    double fastest = DBL_MAX;
+
+    for (size_t i = 0; i < repeats; i++) {
+        const auto start = chrono::steady_clock::now();
+        function();
+        fastest = std::min(fastest, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    }
+
+    return fastest;
+}
+
+void Benchmark::report(const string& name, const double& value, const string& unit) {
+    cout << left << setw(64) << name << right << fixed << setprecision(3) << setw(12) << value << " " << unit << endl;
+}
@@ -0,0 +1,39 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+
+// cpp
+#include <vector>
+
+int main(int argc, char** argv) {
+    GLStub::install();
+
+    const vector<pair<string, function<void(void)>>> benchmarks = {
+        { "transforms", benchmarkTransforms },
+        { "propagation", benchmarkPropagation },
+        { "culling", benchmarkCulling },
+        { "uniforms", benchmarkUniforms },
+        { "render queue", benchmarkRenderQueue },
+        { "instancing", benchmarkInstancing },
+        { "vertex formats", benchmarkVertexFormats },
+        { "indirect", benchmarkIndirect },
+        { "dual quaternions", benchmarkDualQuaternions },
+        { "job system", benchmarkJobSystem },
+        { "destroy", benchmarkDestroy }
+    };
+
+    // names given on the command line select which benchmarks run
+    for (auto& benchmark : benchmarks) {
+        bool selected = argc < 2;
+
+        for (int i = 1; i < argc; i++) {
+            selected = selected || benchmark.first == argv[i];
+        }
+
+        if (selected) {
+            cout << "[" << benchmark.first << "]" << endl;
+            benchmark.second();
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const size_t GROUP_SIZE = 100;
+// every tenth mesh moves in the moving scenes
+static const size_t MOVING_STRIDE = 10;
+// coprime to every mesh count, so stepping by it visits each place of the grid once
+static const size_t SCATTER_STRIDE = 7919;
+// frames per measurement for the smallest scene, larger scenes run fewer so every case takes about as long
+static const size_t FRAME_COUNT = 20;
+
+// a square grid of groups on the xz plane, the camera in the middle of it looking down -z.
+// scattered groups hand their meshes out over the whole grid, so their bounds span the scene
+static void buildScene(SceneGraph& sceneGraph, const shared_ptr<Geometry>& geometry, const size_t& groupCount, const bool& scattered = false) {
+    const size_t side = (size_t)sqrt((double)groupCount);
+    const float offset = ((float)side - 1.f) * 0.5f;
+
+    const auto getPosition = [&side, &offset](const size_t& place) {
+        const size_t g = place / GROUP_SIZE;
+        const size_t i = place % GROUP_SIZE;
+        return vec3(((float)(g % side) - offset) * 20.f + (float)(i % 10) * 2.f, 0.f, ((float)(g / side) - offset) * 20.f + (float)(i / 10) * 2.f);
+    };
+
+    for (size_t g = 0; g < groupCount; g++) {
+        const shared_ptr<SceneObject> group = make_shared<SceneObject>("group", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), getPosition(g * GROUP_SIZE))));
+        sceneGraph.getRoot()->appendChild(group);
+
+        for (size_t i = 0; i < GROUP_SIZE; i++) {
+            const size_t place = scattered ? (g * GROUP_SIZE + i) * SCATTER_STRIDE % (groupCount * GROUP_SIZE) : g * GROUP_SIZE + i;
+            group->appendChild(make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), getPosition(place)))));
+        }
+    }
+}
+
+static void measureCull(const string& name, const SceneGraph& sceneGraph, const size_t& frameCount, const function<void(void)>& cull) {
+    Benchmark::report(name + ", cull per frame", Benchmark::measure(5, [&cull, &frameCount](void) {
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            cull();
+        }
+    }) / frameCount);
+
+    Benchmark::report(name + ", visible", (double)sceneGraph.getVisibleCount(), "meshes");
+    Benchmark::report(name + ", culled", (double)sceneGraph.getCulledCount(), "meshes");
+}
+
+// the traversals against the bounding volume hierarchy on the same scene
+static void benchmarkScene(const string& label, const size_t& groupCount) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    const mat4 ProjectionViewMatrix = perspective(radians(60.f), 1.f, 0.1f, 1000.f);
+    const size_t frameCount = std::max(FRAME_COUNT * 100 / groupCount, (size_t)1);
+
+    SceneGraph sceneGraph;
+    buildScene(sceneGraph, geometry, groupCount);
+
+    const auto cull = [&](void) {
+        sceneGraph.cull(ProjectionViewMatrix);
+    };
+
+    const auto cullSnapshot = [&](void) {
+        sceneGraph.cull(sceneGraph.getSnapshotBuffer()->acquire(), ProjectionViewMatrix);
+        sceneGraph.getSnapshotBuffer()->release();
+    };
+
+    measureCull(label + " meshes, pointer tree", sceneGraph, frameCount, cull);
+
+    sceneGraph.flatten();
+    measureCull(label + " meshes, flattened", sceneGraph, frameCount, cull);
+
+    sceneGraph.createSnapshotBuffer();
+    sceneGraph.publishSnapshot();
+    measureCull(label + " meshes, snapshot", sceneGraph, frameCount, cullSnapshot);
+
+    Benchmark::report(label + " meshes, bounding volume hierarchy build", Benchmark::measure(1, [&sceneGraph](void) {
+        sceneGraph.buildBoundingVolumeHierarchy();
+    }));
+    measureCull(label + " meshes, bounding volume hierarchy", sceneGraph, frameCount, cull);
+
+    // both snapshots carry the hierarchy copy
+    sceneGraph.publishSnapshot();
+    sceneGraph.publishSnapshot();
+    measureCull(label + " meshes, snapshot with bounding volume hierarchy", sceneGraph, frameCount, cullSnapshot);
+}
+
+// the same traversals when a share of the meshes moves every frame, culling refreshes bounds first
+static void benchmarkMovingScene(const string& label, const size_t& groupCount) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    const mat4 ProjectionViewMatrix = perspective(radians(60.f), 1.f, 0.1f, 1000.f);
+    const size_t frameCount = std::max(FRAME_COUNT * 100 / groupCount, (size_t)1);
+
+    SceneGraph sceneGraph;
+    buildScene(sceneGraph, geometry, groupCount);
+
+    vector<SceneObject*> moving;
+    for (auto& group : sceneGraph.getRoot()->getChildren()) {
+        for (size_t i = 0; i < group->getChildren().size(); i += MOVING_STRIDE) {
+            moving.push_back(group->getChildren()[i].get());
+        }
+    }
+
+    // meshes step back and forth so the scene stays the same over any number of frames,
+    // a step smaller than the margin of the hierarchy like most motion between two frames
+    float step = 0.1f;
+    const auto moveAndCull = [&](void) {
+        for (auto& sceneObject : moving) {
+            sceneObject->translate(step, 0.f, 0.f);
+        }
+
+        step = -step;
+        sceneGraph.cull(ProjectionViewMatrix);
+    };
+
+    measureCull(label + " meshes, 10% moving, pointer tree", sceneGraph, frameCount, moveAndCull);
+
+    sceneGraph.flatten();
+    measureCull(label + " meshes, 10% moving, flattened", sceneGraph, frameCount, moveAndCull);
+
+    sceneGraph.buildBoundingVolumeHierarchy();
+    measureCull(label + " meshes, 10% moving, bounding volume hierarchy", sceneGraph, frameCount, moveAndCull);
+}
+
+// the same meshes grouped without regard to where they are, which only the bounding volume hierarchy can prune
+static void benchmarkScatteredScene(const string& label, const size_t& groupCount) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    const mat4 ProjectionViewMatrix = perspective(radians(60.f), 1.f, 0.1f, 1000.f);
+    const size_t frameCount = std::max(FRAME_COUNT * 100 / groupCount, (size_t)1);
+
+    SceneGraph sceneGraph;
+    buildScene(sceneGraph, geometry, groupCount, true);
+
+    const auto cull = [&](void) {
+        sceneGraph.cull(ProjectionViewMatrix);
+    };
+
+    measureCull(label + " meshes, scattered, pointer tree", sceneGraph, frameCount, cull);
+
+    sceneGraph.buildBoundingVolumeHierarchy();
+    measureCull(label + " meshes, scattered, bounding volume hierarchy", sceneGraph, frameCount, cull);
+}
+
+void benchmarkCulling(void) {
+    benchmarkScene("10k", 100);
+    benchmarkScene("100k", 1000);
+    benchmarkScene("1M", 10000);
+
+    benchmarkMovingScene("10k", 100);
+    benchmarkMovingScene("100k", 1000);
+    benchmarkMovingScene("1M", 10000);
+
+    benchmarkScatteredScene("10k", 100);
+    benchmarkScatteredScene("100k", 1000);
+    benchmarkScatteredScene("1M", 10000);
+}
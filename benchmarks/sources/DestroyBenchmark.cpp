@@ -0,0 +1,98 @@
+#include <Benchmark.hpp>
+#include <SceneGraph.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t SUBTREE_SIZE = 100000;
+static const size_t SCENE_SIZE = 10000;
+static const size_t REPEATS = 3;
+
+enum Structure {
+    POINTER_TREE,
+    FLATTENED,
+    BOUNDING_VOLUME_HIERARCHY
+};
+
+// SCENE_SIZE objects that stay and a subtree of SUBTREE_SIZE objects below one group, which is taken out
+class Scene {
+public:
+    SceneGraph sceneGraph;
+    shared_ptr<SceneObject> subtree = make_shared<SceneObject>("subtree");
+
+    Scene(const Structure& structure) {
+        for (size_t i = 0; i < SCENE_SIZE; i++) {
+            sceneGraph.getRoot()->appendChild(make_shared<SceneObject>("object", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i, 0.f, 0.f)))));
+        }
+
+        sceneGraph.getRoot()->appendChild(subtree);
+
+        for (size_t i = 0; i < SUBTREE_SIZE; i++) {
+            subtree->appendChild(make_shared<SceneObject>("object", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(0.f, (float)i, 0.f)))));
+        }
+
+        if (structure == FLATTENED) {
+            sceneGraph.flatten();
+        } else if (structure == BOUNDING_VOLUME_HIERARCHY) {
+            sceneGraph.buildBoundingVolumeHierarchy();
+        }
+
+        sceneGraph.propagateTransforms();
+    }
+};
+
+// scenes are built ahead, so every run starts from the same state and only the operation is timed
+static double measureOnScenes(const Structure& structure, const function<void(Scene&)>& prepare, const function<void(Scene&)>& operation) {
+    vector<unique_ptr<Scene>> scenes;
+
+    for (size_t i = 0; i < REPEATS; i++) {
+        scenes.push_back(unique_ptr<Scene>(new Scene(structure)));
+        prepare(*scenes.back());
+    }
+
+    size_t run = 0;
+    const double time = Benchmark::measure(REPEATS, [&](void) {
+        operation(*scenes[run++]);
+    });
+
+    for (auto& scene : scenes) {
+        scene->sceneGraph.waitForReleases();
+    }
+
+    return time;
+}
+
+static void measureStructure(const string& name, const Structure& structure) {
+    const auto nothing = [](Scene&) {};
+    const auto destroy = [](Scene& scene) {
+        scene.sceneGraph.destroySceneObject(std::move(scene.subtree));
+    };
+
+    // what the frame thread paid before, the subtree leaves every structure right away
+    Benchmark::report(name + ", remove 100k subtree on the frame thread", measureOnScenes(structure, nothing, [](Scene& scene) {
+        scene.sceneGraph.getRoot()->removeChild(scene.subtree);
+    }));
+
+    Benchmark::report(name + ", destroy 100k subtree on the frame thread", measureOnScenes(structure, nothing, destroy));
+
+    // until the worker is done, the frame thread helps with the release while it waits
+    Benchmark::report(name + ", destroy 100k subtree and wait for the release", measureOnScenes(structure, nothing, [&destroy](Scene& scene) {
+        destroy(scene);
+        scene.sceneGraph.waitForReleases();
+    }));
+
+    if (structure == FLATTENED) {
+        Benchmark::report(name + ", propagation dropping the released range", measureOnScenes(structure, [&destroy](Scene& scene) {
+            destroy(scene);
+            scene.sceneGraph.waitForReleases();
+        }, [](Scene& scene) {
+            scene.sceneGraph.propagateTransforms();
+        }));
+    }
+}
+
+void benchmarkDestroy(void) {
+    measureStructure("pointer tree", POINTER_TREE);
+    measureStructure("flattened", FLATTENED);
+    measureStructure("bounding volume hierarchy", BOUNDING_VOLUME_HIERARCHY);
+}
@@ -0,0 +1,89 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+#include <WorldMatrixBuffer.hpp>
+
+// cpp
+#include <random>
+#include <vector>
+
+static const size_t TRANSFORM_COUNT = 1000000;
+static const size_t MESH_COUNT = 100000;
+
+// the kernels alone over 1M transforms, against expanding the same transforms to matrices
+static void measureKernels(void) {
+    mt19937 generator(17);
+    uniform_real_distribution<float> unit(-1.f, 1.f);
+    vector<Transform> transforms;
+    transforms.reserve(TRANSFORM_COUNT);
+
+    for (size_t i = 0; i < TRANSFORM_COUNT; i++) {
+        const fquat rotation = normalize(fquat(unit(generator), unit(generator), unit(generator), unit(generator) + 2.f));
+        const vec3 translation(unit(generator) * 100.f, unit(generator) * 100.f, unit(generator) * 100.f);
+        transforms.push_back(Transform(fdualquat(rotation, translation), vec3(1.f + unit(generator) * 0.5f)));
+    }
+
+    vector<mat4> matrices(TRANSFORM_COUNT);
+    vector<vec4> packed(TRANSFORM_COUNT * 3);
+
+    Benchmark::report("1M transforms, matrices", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < TRANSFORM_COUNT; i++) {
+            matrices[i] = transforms[i].getMatrix();
+        }
+    }));
+
+    Benchmark::report("1M transforms, dual quaternion and scale", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < TRANSFORM_COUNT; i++) {
+            packDualQuaternionScale(transforms[i].getTranslationAndRotation(), transforms[i].getScale(), &packed[i * 3]);
+        }
+    }));
+
+    Benchmark::report("1M transforms, scaled dual quaternion", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < TRANSFORM_COUNT; i++) {
+            packScaledDualQuaternion(transforms[i].getTranslationAndRotation(), transforms[i].getScale().x, &packed[i * 2]);
+        }
+    }));
+}
+
+// what a frame writes for the world matrix buffer, one object per packet of MESH_COUNT meshes
+static void measureRenderQueue(void) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(
+        vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) })
+    );
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        const vec3 position((float)(i % 100) - 50.f, (float)(i / 100 % 100) - 50.f, -100.f - (float)(i / 10000));
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    sceneGraph.draw(ProjectionViewMatrix);
+    const RenderQueue& renderQueue = sceneGraph.getRenderQueue();
+    vector<mat4> matrices(renderQueue.size());
+    vector<vec4> packed(renderQueue.size() * 3);
+
+    Benchmark::report("100k packets, write matrices", Benchmark::measure(5, [&](void) {
+        renderQueue.writeModelMatrices(matrices.data());
+    }));
+    Benchmark::report("100k packets, write dual quaternion and scale", Benchmark::measure(5, [&](void) {
+        renderQueue.writeDualQuaternions(packed.data(), false);
+    }));
+    Benchmark::report("100k packets, write scaled dual quaternion", Benchmark::measure(5, [&](void) {
+        renderQueue.writeDualQuaternions(packed.data(), true);
+    }));
+
+    Benchmark::report("matrix layout, size per object", (double)WorldMatrixBuffer::getStride(WorldMatrixBuffer::MATRIX), "bytes");
+    Benchmark::report("dual quaternion and scale layout, size per object", (double)WorldMatrixBuffer::getStride(WorldMatrixBuffer::DUAL_QUATERNION_SCALE), "bytes");
+    Benchmark::report("dual quaternion uniform scale layout, size per object", (double)WorldMatrixBuffer::getStride(WorldMatrixBuffer::DUAL_QUATERNION_UNIFORM_SCALE), "bytes");
+}
+
+void benchmarkDualQuaternions(void) {
+    measureKernels();
+    measureRenderQueue();
+}
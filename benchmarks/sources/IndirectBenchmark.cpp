@@ -0,0 +1,61 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t MESH_COUNT = 100000;
+static const size_t FRAME_COUNT = 10;
+
+// MESH_COUNT meshes of one arena in front of the camera, spread over geometryCount geometries
+static void measureArena(const string& name, const size_t& geometryCount, const bool& worldMatrixIndexing) {
+    const shared_ptr<GeometryArena> arena = make_shared<GeometryArena>(VertexFormat(), 1 << 16, 3 << 16);
+    vector<shared_ptr<Geometry>> geometries;
+
+    for (size_t i = 0; i < geometryCount; i++) {
+        const float size = 1.f + (float)i * 0.1f;
+        geometries.push_back(make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(size, 0.f, 0.f)), Vertex(vec3(0.f, size, 0.f)) }), arena));
+    }
+
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+    SceneGraph sceneGraph;
+    vector<shared_ptr<Mesh>> meshes;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        const vec3 position((float)(i % 100) - 50.f, (float)(i / 100 % 100) - 50.f, -100.f - (float)(i / 10000));
+        meshes.push_back(make_shared<Mesh>(geometries[i % geometryCount], "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position))));
+        meshes.back()->setShader(shader);
+        sceneGraph.getRoot()->appendChild(meshes.back());
+    }
+
+    sceneGraph.propagateTransforms();
+
+    // sorted packets are built once, the submit gathers the commands and hands them to the stubbed multi draw
+    RenderQueue renderQueue;
+    for (auto& mesh : meshes) {
+        mesh->enqueue(renderQueue, ProjectionViewMatrix, mesh->getWorldTransform());
+    }
+
+    renderQueue.sort();
+    renderQueue.setWorldMatrixIndexing(worldMatrixIndexing);
+
+    Benchmark::report(name + ", command build and submit per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            renderQueue.submit(ProjectionViewMatrix);
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report(name + ", commands per frame", (double)renderQueue.getCommandCount(), "commands");
+    Benchmark::report(name + ", draws per frame", (double)renderQueue.getDrawCount(), "draws");
+}
+
+void benchmarkIndirect(void) {
+    measureArena("100k arena meshes, 1 geometry", 1, false);
+    measureArena("100k arena meshes, 16 geometries", 16, false);
+    measureArena("100k arena meshes, 16 geometries, world matrix indexing", 16, true);
+}
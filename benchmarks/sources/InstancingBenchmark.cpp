@@ -0,0 +1,75 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t MESH_COUNT = 100000;
+static const size_t FRAME_COUNT = 10;
+
+// MESH_COUNT meshes in a block in front of the camera, spread over geometryCount shared geometries
+static void measureScene(const string& name, const size_t& geometryCount, const vector<string>& activeUniforms) {
+    vector<shared_ptr<Geometry>> geometries;
+
+    for (size_t i = 0; i < geometryCount; i++) {
+        const float size = 1.f + (float)i * 0.1f;
+        geometries.push_back(make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(size, 0.f, 0.f)), Vertex(vec3(0.f, size, 0.f)) })));
+    }
+
+    GLStub::setActiveUniforms(activeUniforms);
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+    SceneGraph sceneGraph;
+    vector<shared_ptr<Mesh>> meshes;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        const vec3 position((float)(i % 100) - 50.f, (float)(i / 100 % 100) - 50.f, -100.f - (float)(i / 10000));
+        meshes.push_back(make_shared<Mesh>(geometries[i % geometryCount], "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position))));
+        meshes.back()->setShader(shader);
+        sceneGraph.getRoot()->appendChild(meshes.back());
+    }
+
+    sceneGraph.propagateTransforms();
+
+    // the packets alone, as the draw of a frame builds them for the visible meshes
+    RenderQueue renderQueue;
+    Benchmark::report(name + ", packet build per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            renderQueue.clear();
+
+            for (auto& mesh : meshes) {
+                mesh->enqueue(renderQueue, ProjectionViewMatrix, mesh->getWorldTransform());
+            }
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report(name + ", packet build and sort per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            renderQueue.clear();
+
+            for (auto& mesh : meshes) {
+                mesh->enqueue(renderQueue, ProjectionViewMatrix, mesh->getWorldTransform());
+            }
+
+            renderQueue.sort();
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report(name + ", draw per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sceneGraph.draw(ProjectionViewMatrix);
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report(name + ", draws per frame", (double)sceneGraph.getRenderQueue().getDrawCount(), "draws");
+}
+
+void benchmarkInstancing(void) {
+    measureScene("100k meshes, 1 geometry, instanced", 1, { "PVM", "model", "PV" });
+    measureScene("100k meshes, 16 geometries, instanced", 16, { "PVM", "model", "PV" });
+    measureScene("100k meshes, 16 geometries, individual draws", 16, { "PVM", "model" });
+}
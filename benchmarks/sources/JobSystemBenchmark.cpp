@@ -0,0 +1,115 @@
+#include <Benchmark.hpp>
+#include <JobSystem.hpp>
+#include <Parallel.hpp>
+
+// cpp
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+static const size_t JOB_COUNT = 100000;
+static const size_t ROUND_TRIP_COUNT = 10000;
+static const size_t ELEMENT_COUNT = 1 << 22;
+
+// submitting and finishing empty jobs, what every job costs on top of its work
+static void measureSpawn(const string& name, JobSystem& jobSystem) {
+    vector<shared_ptr<JobSystem::Job>> jobs;
+    jobs.reserve(JOB_COUNT);
+
+    Benchmark::report(name + ", spawn and finish 100k empty jobs", Benchmark::measure(5, [&](void) {
+        jobs.clear();
+
+        for (size_t i = 0; i < JOB_COUNT; i++) {
+            jobs.push_back(jobSystem.run([](void) {}));
+        }
+
+        for (auto& job : jobs) {
+            jobSystem.wait(job);
+        }
+    }));
+
+    // jobs run from this thread wait in the queue of no worker, whichever thread takes them they count as injected
+    const size_t injected = jobSystem.getInjectedCount();
+    const size_t executedBefore = jobSystem.getExecutedCount();
+
+    for (size_t i = 0; i < JOB_COUNT; i++) {
+        jobs[i] = jobSystem.run([](void) {});
+    }
+
+    for (auto& job : jobs) {
+        jobSystem.wait(job);
+    }
+
+    Benchmark::report(name + ", injected jobs", 100.0 * (double)(jobSystem.getInjectedCount() - injected) / (double)(jobSystem.getExecutedCount() - executedBefore), "%");
+
+    // one job after the other, the time from run until wait returns, whichever thread got to run it
+    Benchmark::report(name + ", run and wait round trip", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < ROUND_TRIP_COUNT; i++) {
+            jobSystem.wait(jobSystem.run([](void) {}));
+        }
+    }) * 1000.0 / ROUND_TRIP_COUNT, "us");
+
+    // jobs spawned from a worker are stolen by the others and by the waiting thread
+    const size_t stolen = jobSystem.getStolenCount();
+    const size_t failed = jobSystem.getFailedStealCount();
+    const size_t executed = jobSystem.getExecutedCount();
+
+    jobSystem.wait(jobSystem.run([&jobSystem](void) {
+        vector<shared_ptr<JobSystem::Job>> children;
+        children.reserve(JOB_COUNT);
+
+        for (size_t i = 0; i < JOB_COUNT; i++) {
+            children.push_back(jobSystem.run([](void) {}));
+        }
+
+        for (auto& child : children) {
+            jobSystem.wait(child);
+        }
+    }));
+
+    const double executedJobs = (double)(jobSystem.getExecutedCount() - executed);
+    Benchmark::report(name + ", stolen jobs", 100.0 * (double)(jobSystem.getStolenCount() - stolen) / executedJobs, "%");
+    Benchmark::report(name + ", failed steals per job", (double)(jobSystem.getFailedStealCount() - failed) / executedJobs, "steals");
+}
+
+// the same loop over ELEMENT_COUNT elements for every worker count, speedup is bounded by the hardware threads
+static void measureScaling(const vector<float>& input, vector<float>& output) {
+    const size_t maxWorkerCount = std::max(getHardwareThreadCount(), (size_t)4);
+    double single = 0.0;
+
+    for (size_t workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2) {
+        JobSystem jobSystem(workerCount);
+        const double time = Benchmark::measure(5, [&](void) {
+            jobSystem.parallelFor(input.size(), [&](const size_t& begin, const size_t& end) {
+                for (size_t i = begin; i < end; i++) {
+                    output[i] = sqrt(input[i]) * sin(input[i]);
+                }
+            });
+        });
+
+        if (workerCount == 1) {
+            single = time;
+        }
+
+        const string name = "parallel for over 4M elements, workers: " + to_string(workerCount);
+        Benchmark::report(name, time);
+        Benchmark::report(name + ", speedup", single / time, "x");
+    }
+}
+
+void benchmarkJobSystem(void) {
+    for (const size_t workerCount : { (size_t)1, (size_t)3 }) {
+        JobSystem jobSystem(workerCount);
+        measureSpawn("workers: " + to_string(workerCount), jobSystem);
+    }
+
+    vector<float> input(ELEMENT_COUNT);
+    vector<float> output(ELEMENT_COUNT);
+    for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+        input[i] = (float)i * 0.001f;
+    }
+
+    measureScaling(input, output);
+    Benchmark::report("hardware threads", (double)getHardwareThreadCount(), "threads");
+}
@@ -0,0 +1,131 @@
+#include <Benchmark.hpp>
+#include <SceneGraph.hpp>
+#include <Parallel.hpp>
+
+// cpp
+#include <algorithm>
+#include <vector>
+
+static const size_t GROUP_SIZE = 256;
+// frames per measurement for the smallest scene, larger scenes run fewer so every case takes about as long
+static const size_t FRAME_COUNT = 20;
+
+// root, groupCount groups below it and GROUP_SIZE objects in every group
+static void buildScene(SceneGraph& sceneGraph, const size_t& groupCount, vector<shared_ptr<SceneObject>>& groups, vector<shared_ptr<SceneObject>>& objects) {
+    for (size_t g = 0; g < groupCount; g++) {
+        groups.push_back(make_shared<SceneObject>("group", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)g, 0.f, 0.f)))));
+        sceneGraph.getRoot()->appendChild(groups.back());
+
+        for (size_t i = 0; i < GROUP_SIZE; i++) {
+            objects.push_back(make_shared<SceneObject>("object", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(0.f, (float)i, 0.f)))));
+            groups.back()->appendChild(objects.back());
+        }
+    }
+}
+
+// the root stays clean in every case, dirty subtrees are found through the descendant flags.
+// every row runs on a job system of its own, so it uses as many threads as it reports
+static void measureThreads(const string& name, SceneGraph& sceneGraph, const size_t& frameCount, const function<void(void)>& move) {
+    const size_t maxThreadCount = std::max(getHardwareThreadCount(), (size_t)4);
+
+    Benchmark::report(name + ", threads: 1, per frame", Benchmark::measure(3, [&](void) {
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            move();
+            sceneGraph.propagateTransforms();
+        }
+    }) / frameCount);
+
+    for (size_t threadCount = 2; threadCount <= maxThreadCount; threadCount *= 2) {
+        JobSystem jobSystem(threadCount - 1);
+
+        Benchmark::report(name + ", threads: " + to_string(threadCount) + ", per frame", Benchmark::measure(3, [&](void) {
+            for (size_t frame = 0; frame < frameCount; frame++) {
+                move();
+                sceneGraph.propagateTransforms(jobSystem);
+            }
+        }) / frameCount);
+
+        if (sceneGraph.getHierarchy() != nullptr) {
+            continue;
+        }
+
+        // the top of the dirty region is resolved on the calling thread before the workers get any subtree,
+        // which bounds the speedup the way any serial part does
+        const SceneObject* root = sceneGraph.getRoot().get();
+        vector<const SceneObject*> frontier;
+        double frontierTime = 0.0;
+        double subtreeTime = 0.0;
+
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            move();
+
+            frontierTime += Benchmark::measure(1, [&](void) {
+                root->gatherFrontier(threadCount * 4, frontier);
+            });
+
+            subtreeTime += Benchmark::measure(1, [&](void) {
+                parallelFor(frontier.size(), threadCount, [&frontier](const size_t& begin, const size_t& end) {
+                    for (size_t i = begin; i < end; i++) {
+                        frontier[i]->propagateTransform();
+                    }
+                }, jobSystem);
+            });
+        }
+
+        Benchmark::report(name + ", threads: " + to_string(threadCount) + ", serial share", 100.0 * frontierTime / (frontierTime + subtreeTime), "%");
+    }
+}
+
+// the pointer tree against the flat storage on the same scene
+static void benchmarkScene(const string& label, const size_t& groupCount) {
+    SceneGraph sceneGraph;
+    vector<shared_ptr<SceneObject>> groups;
+    vector<shared_ptr<SceneObject>> objects;
+    buildScene(sceneGraph, groupCount, groups, objects);
+    sceneGraph.propagateTransforms();
+
+    const size_t frameCount = std::max(FRAME_COUNT * 64 / groupCount, (size_t)1);
+
+    const auto moveGroups = [&groups](void) {
+        for (auto& group : groups) {
+            group->translate(0.f, 0.f, 0.001f);
+        }
+    };
+
+    // one object in a hundred
+    const auto moveSome = [&objects](void) {
+        for (size_t i = 0; i < objects.size(); i += 100) {
+            objects[i]->translate(0.f, 0.f, 0.001f);
+        }
+    };
+
+    Benchmark::report(label + " scene size", (double)(1 + groupCount + groupCount * GROUP_SIZE), "nodes");
+    measureThreads(label + " pointer tree, every group moved", sceneGraph, frameCount, moveGroups);
+    measureThreads(label + " pointer tree, 1% of objects moved", sceneGraph, frameCount, moveSome);
+
+    Benchmark::report(label + " flatten", Benchmark::measure(1, [&sceneGraph](void) {
+        sceneGraph.flatten();
+    }));
+    measureThreads(label + " flattened, every group moved", sceneGraph, frameCount, moveGroups);
+    measureThreads(label + " flattened, 1% of objects moved", sceneGraph, frameCount, moveSome);
+
+    // a group leaves and comes back, its range stays behind released and it is appended again at the end of the arrays
+    Benchmark::report(label + " flattened, group removed and appended", Benchmark::measure(3, [&sceneGraph, &groups](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sceneGraph.getRoot()->removeChild(groups[frame]);
+            sceneGraph.getRoot()->appendChild(groups[frame]);
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report(label + " flattened, findNode", Benchmark::measure(3, [&sceneGraph](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sceneGraph.getHierarchy()->findNode("group");
+        }
+    }) / FRAME_COUNT);
+}
+
+void benchmarkPropagation(void) {
+    benchmarkScene("16k", 64);
+    benchmarkScene("100k", 400);
+    benchmarkScene("1M", 4000);
+}
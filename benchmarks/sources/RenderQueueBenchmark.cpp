@@ -0,0 +1,60 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t MESH_COUNT = 10000;
+static const size_t GEOMETRY_COUNT = 8;
+static const size_t FRAME_COUNT = 20;
+
+// meshes in a wall in front of the camera, cycling through the shaders and geometries in tree order
+// so that drawing in that order would bind both for every mesh
+static void measureScene(const string& name, const size_t& shaderCount, const vector<string>& activeUniforms) {
+    vector<shared_ptr<Geometry>> geometries;
+    vector<shared_ptr<Shader>> shaders;
+
+    for (size_t i = 0; i < GEOMETRY_COUNT; i++) {
+        const float size = 1.f + (float)i * 0.1f;
+        geometries.push_back(make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(size, 0.f, 0.f)), Vertex(vec3(0.f, size, 0.f)) })));
+    }
+
+    GLStub::setActiveUniforms(activeUniforms);
+
+    for (size_t i = 0; i < shaderCount; i++) {
+        shaders.push_back(make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath()));
+    }
+
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        const vec3 position((float)(i % 100) - 50.f, (float)(i / 100) - 50.f, -100.f);
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometries[i % GEOMETRY_COUNT], "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+        mesh->setShader(shaders[i % shaderCount]);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    Benchmark::report(name + ", draw per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sceneGraph.draw(ProjectionViewMatrix);
+        }
+    }) / FRAME_COUNT);
+
+    const RenderQueue& renderQueue = sceneGraph.getRenderQueue();
+    Benchmark::report(name + ", binds in tree order", (double)(2 * MESH_COUNT), "binds");
+    Benchmark::report(name + ", binds per frame", (double)renderQueue.getBindCount(), "binds");
+    Benchmark::report(name + ", binds saved per frame", (double)renderQueue.getSkippedBindCount(), "binds");
+    Benchmark::report(name + ", draws per frame", (double)renderQueue.getDrawCount(), "draws");
+}
+
+void benchmarkRenderQueue(void) {
+    measureScene("10k meshes, 4 shaders, individual draws", 4, { "PVM", "model" });
+    measureScene("10k meshes, 4 shaders, instanced draws", 4, { "PVM", "model", "PV" });
+    // more programs than the shader field of a key holds
+    measureScene("10k meshes, 5000 shaders, individual draws", 5000, { "PVM", "model" });
+}
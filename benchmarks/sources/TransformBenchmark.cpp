@@ -0,0 +1,117 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t MESH_COUNT = 10000;
+static const size_t FRAME_COUNT = 100;
+
+static Transform makeTransform(const size_t& i) {
+    return Transform(
+        fdualquat(glm::rotate(fquat(1.f, 0.f, 0.f, 0.f), radians((float)(i % 360)), vec3(0.f, 1.f, 0.f)), vec3((float)(i % 100), 0.f, -(float)(i / 100))),
+        vec3(1.f + (i % 3) * 0.5f)
+    );
+}
+
+// what a draw reads of its world transform: the depth sort key, the model matrix and the world bounds
+template <typename WorldTransform>
+static float readPerDraw(const vector<WorldTransform>& transforms) {
+    float sum = 0.f;
+
+    for (auto& transform : transforms) {
+        sum += (transform.getMatrix() * vec4(0.f, 0.f, 0.f, 1.f)).z;
+        sum += transform.getMatrix()[0][0];
+        sum += (transform.getMatrix() * vec4(1.f, 1.f, 1.f, 1.f)).x;
+    }
+
+    return sum;
+}
+
+// what a world-to-object query reads, such as a ray or a point moved into the object's space
+template <typename WorldTransform>
+static float readInversePerDraw(const vector<WorldTransform>& transforms) {
+    float sum = 0.f;
+
+    for (auto& transform : transforms) {
+        sum += (transform.getInverseMatrix() * vec4(0.f, 0.f, 0.f, 1.f)).z;
+        sum += (transform.getInverseMatrix() * vec4(1.f, 1.f, 1.f, 0.f)).x;
+    }
+
+    return sum;
+}
+
+void benchmarkTransforms(void) {
+    vector<Transform> plain;
+    vector<CachedTransform> cached;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        plain.push_back(makeTransform(i));
+        cached.push_back(makeTransform(i));
+    }
+
+    volatile float sink = 0.f;
+
+    Benchmark::report("sizeof(Transform)", (double)sizeof(Transform), "bytes");
+    Benchmark::report("sizeof(CachedTransform)", (double)sizeof(CachedTransform), "bytes");
+
+    Benchmark::report("10k draws, matrix rebuilt on every read, per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sink = sink + readPerDraw(plain);
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report("10k draws, cached matrix, per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sink = sink + readPerDraw(cached);
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report("10k inverse reads, inverse rebuilt on every read, per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sink = sink + readInversePerDraw(plain);
+        }
+    }) / FRAME_COUNT);
+
+    Benchmark::report("10k inverse reads, cached inverse, per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sink = sink + readInversePerDraw(cached);
+        }
+    }) / FRAME_COUNT);
+
+    // the whole frame against the stubbed GL, every mesh drawn on its own
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    GLStub::setActiveUniforms({ "PVM", "model" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+
+    SceneGraph sceneGraph;
+    vector<shared_ptr<Mesh>> meshes;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        meshes.push_back(make_shared<Mesh>(geometry, "mesh", makeTransform(i)));
+        meshes.back()->setShader(shader);
+        sceneGraph.getRoot()->appendChild(meshes.back());
+    }
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+
+    Benchmark::report("10k mesh scene, static, draw per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            sceneGraph.draw(ProjectionViewMatrix);
+        }
+    }) / FRAME_COUNT);
+
+    // moving meshes build their matrix once per frame instead of once per read
+    Benchmark::report("10k mesh scene, every mesh moved, draw per frame", Benchmark::measure(5, [&](void) {
+        for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+            for (auto& mesh : meshes) {
+                mesh->translate(0.f, 0.f, 0.001f);
+            }
+
+            sceneGraph.draw(ProjectionViewMatrix);
+        }
+    }) / FRAME_COUNT);
+}
@@ -0,0 +1,84 @@
+#include <Benchmark.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t MESH_COUNT = 10000;
+static const size_t CALL_COUNT = 100000;
+
+static size_t getTotalCallCount(void) {
+    size_t count = 0;
+
+    for (auto& call : GLStub::getCalls()) {
+        count += call.second;
+    }
+
+    return count;
+}
+
+// GL calls the stub recorded for one frame, after a first frame has filled the uniform shadows
+static void measureFrame(const string& name, const vector<string>& activeUniforms) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    GLStub::setActiveUniforms(activeUniforms);
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        const vec3 position((float)(i % 100) - 50.f, (float)(i / 100) - 50.f, -100.f);
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    sceneGraph.draw(ProjectionViewMatrix);
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+
+    Benchmark::report(name + ", GL calls per frame", (double)getTotalCallCount(), "calls");
+    Benchmark::report(name + ", uniform uploads per frame", (double)(GLStub::getCallCount("glUniformMatrix4fv") + GLStub::getCallCount("glUniform4fv")), "calls");
+    Benchmark::report(name + ", location queries per frame", (double)GLStub::getCallCount("glGetUniformLocation"), "calls");
+}
+
+void benchmarkUniforms(void) {
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    const GLint handle = shader->getUniformHandle("PVM");
+    vector<mat4> matrices(2, mat4(1.f));
+    matrices[1][3] = vec4(1.f, 2.f, 3.f, 1.f);
+
+    // alternating values are sent every time, repeated ones are caught by the shadow
+    Benchmark::report("setMat4 by name, changed, 100k calls", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < CALL_COUNT; i++) {
+            shader->setMat4("PVM", value_ptr(matrices[i & 1]));
+        }
+    }));
+
+    Benchmark::report("setMat4 by handle, changed, 100k calls", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < CALL_COUNT; i++) {
+            shader->setMat4(handle, value_ptr(matrices[i & 1]));
+        }
+    }));
+
+    Benchmark::report("setMat4 by handle, unchanged, 100k calls", Benchmark::measure(5, [&](void) {
+        for (size_t i = 0; i < CALL_COUNT; i++) {
+            shader->setMat4(handle, value_ptr(matrices[0]));
+        }
+    }));
+
+    shader->setMat4(handle, value_ptr(matrices[1]));
+    GLStub::reset();
+
+    for (size_t i = 0; i < CALL_COUNT; i++) {
+        shader->setMat4(handle, value_ptr(matrices[0]));
+    }
+
+    Benchmark::report("100k repeated setMat4 calls, uploads", (double)GLStub::getCallCount("glUniformMatrix4fv"), "calls");
+
+    measureFrame("10k meshes, individual draws", { "PVM", "model" });
+    measureFrame("10k meshes, instanced draws", { "PVM", "model", "PV" });
+}
@@ -0,0 +1,53 @@
+#include <Benchmark.hpp>
+#include <VertexFormat.hpp>
+
+// cpp
+#include <random>
+#include <vector>
+
+static const size_t VERTEX_COUNT = 1000000;
+
+static void measureEncode(const string& name, const VertexFormat& format, const vector<Vertex>& vertices, const BoundingSphere& bounds) {
+    vector<unsigned char> buffer;
+    const double time = Benchmark::measure(5, [&](void) {
+        format.encode(vertices, bounds, buffer);
+    });
+
+    Benchmark::report(name + ", encode 1M vertices", time);
+    Benchmark::report(name + ", encode throughput", (double)VERTEX_COUNT / time / 1000.0, "Mvertices/s");
+    Benchmark::report(name + ", size per vertex", (double)format.getStride(), "bytes");
+}
+
+void benchmarkVertexFormats(void) {
+    mt19937 generator(7);
+    uniform_real_distribution<float> unit(-1.f, 1.f);
+    uniform_real_distribution<float> positive(0.f, 1.f);
+    vector<Vertex> vertices;
+    vertices.reserve(VERTEX_COUNT);
+
+    for (size_t i = 0; i < VERTEX_COUNT; i++) {
+        const vec3 normal(unit(generator), unit(generator), unit(generator));
+
+        vertices.push_back(Vertex(
+            vec3(unit(generator), unit(generator), unit(generator)) * 10.f,
+            length(normal) > 0.f ? normalize(normal) : vec3(0.f, 0.f, 1.f),
+            vec3(positive(generator), positive(generator), positive(generator)),
+            vec2(positive(generator), positive(generator))
+        ));
+    }
+
+    const BoundingSphere bounds(vec3(0.f, 0.f, 0.f), 10.f * sqrt(3.f));
+
+    // every encoding on its own, the other attributes stay float
+    measureEncode("float", VertexFormat(), vertices, bounds);
+    measureEncode("half positions", VertexFormat(VertexFormat::POSITION_HALF), vertices, bounds);
+    measureEncode("snorm16 positions", VertexFormat(VertexFormat::POSITION_SNORM16), vertices, bounds);
+    measureEncode("octahedral normals", VertexFormat(VertexFormat::POSITION_FLOAT, VertexFormat::NORMAL_OCTAHEDRAL_SNORM16), vertices, bounds);
+    measureEncode(
+        "half coordinates",
+        VertexFormat(VertexFormat::POSITION_FLOAT, VertexFormat::NORMAL_FLOAT, VertexFormat::COLOR_FLOAT, VertexFormat::TEXCOORD_HALF),
+        vertices,
+        bounds
+    );
+    measureEncode("compact", VertexFormat::compact(), vertices, bounds);
+}
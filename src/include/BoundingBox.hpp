@@ -0,0 +1,42 @@
+#ifndef BOUNDING_BOX_HPP
+#define BOUNDING_BOX_HPP
+
+#include <BoundingSphere.hpp>
+
+class BoundingBox {
+private:
+    vec3 minimum = vec3(0.f, 0.f, 0.f);
+    vec3 maximum = vec3(0.f, 0.f, 0.f);
+
+public:
+    BoundingBox(const vec3& minimum = vec3(0.f, 0.f, 0.f), const vec3& maximum = vec3(0.f, 0.f, 0.f));
+
+    BoundingBox(const BoundingSphere& boundingSphere);
+
+    BoundingBox(const BoundingBox& boundingBox);
+
+    BoundingBox& operator=(const BoundingBox& other) noexcept;
+
+    BoundingBox merge(const BoundingBox& other) const noexcept;
+
+    BoundingBox expand(const float& margin) const noexcept;
+
+    bool contains(const BoundingBox& other) const noexcept;
+
+    bool intersects(const BoundingBox& other) const noexcept;
+
+    // slab test, on a hit distance holds where the ray enters the box
+    bool intersects(const vec3& origin, const vec3& inverseDirection, const float& maxDistance, float& distance) const noexcept;
+
+    float getSurfaceArea(void) const noexcept;
+
+    vec3 getCenter(void) const noexcept;
+
+    const vec3& getMinimum(void) const noexcept;
+
+    const vec3& getMaximum(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const BoundingBox& boundingBox);
+
+#endif // !BOUNDING_BOX_HPP
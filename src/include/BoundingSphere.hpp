@@ -0,0 +1,39 @@
+#ifndef BOUNDING_SPHERE_HPP
+#define BOUNDING_SPHERE_HPP
+
+#include <vector>
+
+#include <Transform.hpp>
+
+class Vertex;
+
+class BoundingSphere {
+private:
+    vec3 center = vec3(0.f, 0.f, 0.f);
+    float radius = 0.f;
+
+public:
+    BoundingSphere(const vec3& center = vec3(0.f, 0.f, 0.f), const float& radius = 0.f);
+
+    BoundingSphere(const vector<Vertex>& vertices);
+
+    BoundingSphere(const BoundingSphere& boundingSphere);
+
+    BoundingSphere& operator=(const BoundingSphere& other) noexcept;
+
+    BoundingSphere transform(const Transform& transform) const noexcept;
+
+    BoundingSphere transform(const CachedTransform& transform) const noexcept;
+
+    BoundingSphere transform(const mat4& matrix, const vec3& scale) const noexcept;
+
+    BoundingSphere merge(const BoundingSphere& other) const noexcept;
+
+    const vec3& getCenter(void) const noexcept;
+
+    const float& getRadius(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const BoundingSphere& boundingSphere);
+
+#endif // !BOUNDING_SPHERE_HPP
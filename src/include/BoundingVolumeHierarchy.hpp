@@ -0,0 +1,152 @@
+#ifndef BOUNDING_VOLUME_HIERARCHY_HPP
+#define BOUNDING_VOLUME_HIERARCHY_HPP
+
+// cpp
+#include <atomic>
+
+#include <SceneObject.hpp>
+#include <Frustum.hpp>
+
+// Dynamic AABB tree over the bounded scene objects of a scene graph.
+// Leaves hold a box enlarged by a margin so small moves do not touch the tree, objects that leave
+// their box are reinserted with rotations keeping the tree balanced, and the whole tree is rebuilt
+// top down with a binned surface area heuristic once its total surface area degrades too far.
+// Objects added all at once, such as a whole scene, are built the same way instead of inserted one by one.
+// Every bounded leaf keeps the exact world space bounding sphere of its object as of the last update.
+// Moves are reported by objects as their world transforms are rebuilt, possibly on several propagation threads,
+// and picked up by update, which the owning scene graph runs when propagating transforms.
+// Objects without bounds get a leaf kept out of the tree, so a frustum query plus queryUnbounded
+// lists everything a frame may draw without walking the scene.
+class BoundingVolumeHierarchy {
+    friend class SceneSnapshotBuffer;
+
+public:
+    static const size_t NULL_NODE = ~size_t(0);
+
+private:
+    class Node {
+    public:
+        BoundingBox boundingBox;
+        SceneObject* sceneObject = nullptr;
+        size_t parent = NULL_NODE;
+        size_t left = NULL_NODE;
+        size_t right = NULL_NODE;
+        int height = 0;
+        bool moved = false;
+        // leaves of objects without bounds are not in the tree, their parent is their position in unboundedLeaves
+        bool bounded = true;
+        bool logged = false;
+
+        bool isLeaf(void) const noexcept;
+    };
+
+    // a leaf with a copy of its box, building top down partitions these instead of reaching into the nodes
+    class BuildLeaf {
+    public:
+        vec3 minimum;
+        vec3 maximum;
+        size_t leaf;
+    };
+
+    // split candidates when building top down
+    static const size_t BIN_COUNT = 16;
+
+    vector<Node> nodes;
+    // world space bounds of the object of every bounded leaf, apart from the nodes so queries stay compact
+    vector<BoundingSphere> worldBounds;
+    size_t root = NULL_NODE;
+    size_t freeList = NULL_NODE;
+    // bounded leaves only
+    size_t leafCount = 0;
+    vector<size_t> unboundedLeaves;
+    size_t reinsertCount = 0;
+    // one entry per node, a leaf is listed at most once between updates
+    vector<size_t> movedLeaves;
+    atomic<size_t> movedCount;
+    float margin = 0.5f;
+    float rebuildDegradation = 1.5f;
+    float rebuiltAreaRatio = 1.f;
+    // nodes whose box or children changed since a snapshot buffer last copied them, while tracking.
+    // one entry per node, a node is listed at most once between copies
+    bool tracking = false;
+    vector<size_t> changedNodes;
+    size_t changedCount = 0;
+
+    size_t allocateNode(void);
+
+    void logChange(const size_t& node) noexcept;
+
+    void freeNode(const size_t& node) noexcept;
+
+    // allocates the leaf of sceneObject and keeps it out of the tree
+    size_t createLeaf(SceneObject* sceneObject);
+
+    void setWorldBounds(const size_t& leaf, const BoundingSphere& boundingSphere) noexcept;
+
+    void insertLeaf(const size_t& leaf);
+
+    void removeLeaf(const size_t& leaf) noexcept;
+
+    void appendUnbounded(const size_t& leaf);
+
+    void removeUnbounded(const size_t& leaf) noexcept;
+
+    size_t balance(const size_t& node) noexcept;
+
+    // splits at the cheapest of BIN_COUNT planes across the widest axis, nodes are allocated parent first so a subtree stays close together
+    size_t buildTopDown(vector<BuildLeaf>& leaves, const size_t& begin, const size_t& end);
+
+    BoundingBox getFatBoundingBox(const BoundingSphere& boundingSphere) const noexcept;
+
+public:
+    // margin enlarges leaf boxes by a fraction of the object radius, the tree is rebuilt once its
+    // area ratio grows past rebuildDegradation times the ratio measured after the last rebuild
+    BoundingVolumeHierarchy(const float& margin = 0.5f, const float& rebuildDegradation = 1.5f);
+
+    BoundingVolumeHierarchy(const BoundingVolumeHierarchy& boundingVolumeHierarchy) = delete;
+
+    ~BoundingVolumeHierarchy(void);
+
+    BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy& other) = delete;
+
+    void insert(SceneObject* sceneObject);
+
+    // adds every object and builds the tree once, instead of inserting them one by one
+    void insert(const vector<SceneObject*>& sceneObjects);
+
+    void erase(SceneObject* sceneObject) noexcept;
+
+    void markMoved(const size_t& leaf) noexcept;
+
+    void update(void);
+
+    void rebuild(void);
+
+    void query(const BoundingBox& boundingBox, vector<const SceneObject*>& sceneObjects) const;
+
+    void query(const Frustum& frustum, vector<const SceneObject*>& sceneObjects) const;
+
+    // the same with the leaves, whose objects and world bounds are looked up by getSceneObject and getWorldBounds
+    void query(const Frustum& frustum, vector<size_t>& leaves) const;
+
+    // objects without bounds, which every query leaves out
+    void queryUnbounded(vector<const SceneObject*>& sceneObjects) const;
+
+    const SceneObject* raycast(const vec3& origin, const vec3& direction, const float& maxDistance, float& distance) const noexcept;
+
+    const SceneObject* getSceneObject(const size_t& leaf) const noexcept;
+
+    const BoundingSphere& getWorldBounds(const size_t& leaf) const noexcept;
+
+    // records changed nodes for a snapshot buffer to copy, every live node counts as changed when enabled
+    void setChangeTracking(const bool& tracking);
+
+    // bounded objects, the ones in the tree
+    size_t size(void) const noexcept;
+
+    int getHeight(void) const noexcept;
+
+    float getAreaRatio(void) const noexcept;
+};
+
+#endif // !BOUNDING_VOLUME_HIERARCHY_HPP
@@ -8,9 +8,15 @@ private:
     vec3 eyePosition = vec3(0.f, 0.f, 5.f);
     vec3 lookAtPosition = vec3(0.f, 0.f, 0.f);
     vec3 upVector = vec3(0.f, 1.f, 0.f);
-    mat4 cameraMatrix = lookAt(eyePosition, lookAtPosition, upVector);
+    mutable mat4 cameraMatrix = lookAt(eyePosition, lookAtPosition, upVector);
+    mutable bool cameraMatrixDirty = true;
 
-    void updateCameraMatrix(void) noexcept;
+    void updateCameraMatrix(void) const noexcept;
+
+protected:
+    void worldTransformChanged(void) const noexcept override;
+
+    bool isWorldTransformObserved(void) const noexcept override;
 
 public:
     Camera(
@@ -29,8 +35,6 @@ public:
 
     Camera& operator=(Camera&& camera) noexcept;
 
-    void update(const Transform& newTransform) override;
-
     const vec3& getEyePosition(void) const noexcept;
 
     Camera& setEyePosition(const vec3& eyePosition) noexcept;
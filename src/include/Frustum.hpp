@@ -0,0 +1,41 @@
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+#include <BoundingBox.hpp>
+
+class Frustum {
+private:
+    // left, right, bottom, top, near, far; normals point inwards
+    vec4 planes[6];
+
+public:
+    Frustum(const mat4& ProjectionViewMatrix = mat4(1.f));
+
+    Frustum(const Frustum& frustum);
+
+    Frustum& operator=(const Frustum& other) noexcept;
+
+    bool intersects(const BoundingSphere& boundingSphere) const noexcept;
+
+    bool intersects(const BoundingBox& boundingBox) const noexcept;
+
+    // whether the box lies wholly inside
+    bool contains(const BoundingBox& boundingBox) const noexcept;
+
+    // tests count spheres laid out as separate coordinate arrays, four at a time where SSE is available.
+    // visible[i] is set to 1 for spheres touching the frustum and 0 otherwise, the visible count is returned.
+    size_t intersects(
+        const float* centerX,
+        const float* centerY,
+        const float* centerZ,
+        const float* radius,
+        const size_t& count,
+        unsigned char* visible
+    ) const noexcept;
+
+    const vec4& getPlane(const size_t& index) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const Frustum& frustum);
+
+#endif // !FRUSTUM_HPP
@@ -0,0 +1,69 @@
+#ifndef GL_DELETION_QUEUE_HPP
+#define GL_DELETION_QUEUE_HPP
+
+// cpp
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <iostream>
+
+#include <glad\glad.h>
+
+using namespace std;
+
+// GL objects released by their owners, deleted later by the GL thread in batches, several names per
+// glDelete call. Destructors of GL resources only queue their names and never query GL state, so they
+// may run on any thread. SceneGraph::draw flushes the shared queue at frame end, applications drawing
+// without it call flush themselves. Threads destroying scene objects in the background set deferring,
+// which also routes other GL thread work, such as returning arena ranges, through the queue.
+class GLDeletionQueue {
+private:
+    mutable mutex queueMutex;
+    vector<GLuint> buffers;
+    vector<GLuint> vertexArrays;
+    vector<GLuint> programs;
+    // other work that has to happen on the GL thread, such as returning arena ranges
+    vector<function<void(void)>> tasks;
+    size_t freedCount = 0;
+    size_t flushCount = 0;
+
+public:
+    GLDeletionQueue(void) = default;
+
+    GLDeletionQueue(const GLDeletionQueue& glDeletionQueue) = delete;
+
+    GLDeletionQueue& operator=(const GLDeletionQueue& other) = delete;
+
+    void deleteBuffers(const GLsizei& count, const GLuint* names);
+
+    void deleteVertexArrays(const GLsizei& count, const GLuint* names);
+
+    void deleteProgram(const GLuint& program);
+
+    void defer(const function<void(void)>& task);
+
+    // on the GL thread, one glDelete call per kind of object followed by the deferred tasks,
+    // returns how many objects and tasks were processed
+    size_t flush(void);
+
+    bool empty(void) const noexcept;
+
+    // names and tasks waiting for the next flush
+    size_t getPendingCount(void) const noexcept;
+
+    // names deleted by every flush so far
+    size_t getFreedCount(void) const noexcept;
+
+    // flushes that deleted anything
+    size_t getFlushCount(void) const noexcept;
+
+    static GLDeletionQueue& getShared(void);
+
+    static bool isDeferring(void) noexcept;
+
+    static void setDeferring(const bool& deferring) noexcept;
+};
+
+ostream& operator<< (ostream& out, const GLDeletionQueue& glDeletionQueue);
+
+#endif // !GL_DELETION_QUEUE_HPP
@@ -0,0 +1,141 @@
+#ifndef GEOMETRY_HPP
+#define GEOMETRY_HPP
+
+#include <memory>
+
+#include <GeometryArena.hpp>
+
+// Indexed triangles uploaded once and drawn by any number of meshes through a shared_ptr.
+// Attribute locations 0 to 3 hold the vertex in the layout of its format, 4 to 7 the per instance
+// model matrix of instanced draws. Model matrices are multiplied by getPositionDecode before use.
+// Geometry either owns its buffers or lives in a GeometryArena shared with other geometry.
+class Geometry {
+public:
+    // what stays in memory once the buffers are uploaded, positions and indices are enough for picking
+    enum Retention : unsigned char {
+        KEEP_VERTICES,
+        KEEP_POSITIONS,
+        DISCARD_VERTICES
+    };
+
+private:
+    static Retention defaultRetention;
+
+    GLuint VBO = 0;
+    GLuint VAO = 0;
+    GLuint EBO = 0;
+    GLuint instanceVBO = 0;
+    shared_ptr<GeometryArena> arena = nullptr;
+    size_t allocation = GeometryArena::NULL_ALLOCATION;
+    GLenum indexType = GL_UNSIGNED_INT;
+    // counts of what was uploaded, the CPU copies may be gone
+    GLsizei vertexCount = 0;
+    GLsizei indexCount = 0;
+    Retention retention = KEEP_VERTICES;
+    VertexFormat format;
+    vector<mat4> instanceModels;
+    vector<Vertex> vertices;
+    vector<vec3> positions;
+    vector<GLuint> indices;
+    BoundingSphere boundingSphere;
+
+    void initialize(void) noexcept;
+
+    void initializeInstancing(void) noexcept;
+
+    void deallocate(void) noexcept;
+
+    void applyRetention(void);
+
+public:
+    // triangle soup, identical vertices are welded into an index buffer
+    Geometry(
+        vector<Vertex>&& vertices,
+        const Retention& retention = getDefaultRetention(),
+        const VertexFormat& format = VertexFormat()
+    );
+
+    Geometry(
+        vector<Vertex>&& vertices,
+        vector<GLuint>&& indices,
+        const Retention& retention = getDefaultRetention(),
+        const VertexFormat& format = VertexFormat()
+    );
+
+    // the format is the one of the arena
+    Geometry(vector<Vertex>&& vertices, const shared_ptr<GeometryArena>& arena, const Retention& retention = getDefaultRetention());
+
+    Geometry(
+        vector<Vertex>&& vertices,
+        vector<GLuint>&& indices,
+        const shared_ptr<GeometryArena>& arena,
+        const Retention& retention = getDefaultRetention()
+    );
+
+    Geometry(const Geometry& geometry) = delete;
+
+    ~Geometry(void);
+
+    Geometry& operator=(const Geometry& other) = delete;
+
+    // both expect the vertex array of this geometry to be bound
+    void draw(void) const noexcept;
+
+    void drawInstanced(const vector<mat4>& models);
+
+    // instances whose matrices follow each other in the world matrix buffer from firstObjectIndex on
+    void drawObjects(const GLuint& firstObjectIndex, const GLsizei& objectCount) const noexcept;
+
+    // commands may address any geometry sharing this geometry's arena block
+    void drawIndirect(const vector<DrawElementsIndirectCommand>& commands, const vector<mat4>& models);
+
+    // false for geometry outside of an arena, which cannot be drawn indirectly
+    bool getDrawCommand(DrawElementsIndirectCommand& command) const noexcept;
+
+    // empty unless the vertices are kept
+    const vector<Vertex>& getVertices(void) const noexcept;
+
+    // empty unless only the positions are kept
+    const vector<vec3>& getPositions(void) const noexcept;
+
+    // empty once the vertices are discarded
+    const vector<GLuint>& getIndices(void) const noexcept;
+
+    const GLsizei& getVertexCount(void) const noexcept;
+
+    const GLsizei& getIndexCount(void) const noexcept;
+
+    const Retention& getRetention(void) const noexcept;
+
+    const BoundingSphere& getBoundingSphere(void) const noexcept;
+
+    const VertexFormat& getFormat(void) const noexcept;
+
+    // maps quantized positions back to model space, identity for float positions
+    mat4 getPositionDecode(void) const noexcept;
+
+    // model matrix to upload for a world matrix
+    mat4 decodeModel(const mat4& world) const noexcept;
+
+    // decodeModel for a world transform, the decode is a translation and a uniform scale and folds into both
+    void decodeDualQuaternion(const Transform& world, fdualquat& translationAndRotation, vec3& scale) const noexcept;
+
+    const shared_ptr<GeometryArena>& getArena(void) const noexcept;
+
+    const GLuint& getVBO(void) const noexcept;
+
+    const GLuint& getVAO(void) const noexcept;
+
+    const GLuint& getEBO(void) const noexcept;
+
+    const GLenum& getIndexType(void) const noexcept;
+
+    // used by geometry created without an explicit retention
+    static const Retention& getDefaultRetention(void) noexcept;
+
+    static void setDefaultRetention(const Retention& retention) noexcept;
+};
+
+ostream& operator<< (ostream& out, const Geometry& geometry);
+
+#endif // !GEOMETRY_HPP
@@ -0,0 +1,137 @@
+#ifndef GEOMETRY_ARENA_HPP
+#define GEOMETRY_ARENA_HPP
+
+#include <map>
+
+#include <VertexFormat.hpp>
+
+// Layout read by glMultiDrawElementsIndirect, baseInstance selects the first model matrix of the draw.
+class DrawElementsIndirectCommand {
+public:
+    GLuint count = 0;
+    GLuint instanceCount = 0;
+    GLuint firstIndex = 0;
+    GLint baseVertex = 0;
+    GLuint baseInstance = 0;
+};
+
+// Vertex and index storage shared by every geometry of one vertex format.
+// Geometry is sub-allocated from a few large blocks, each with one vertex buffer, one 32 bit index
+// buffer and one vertex array, so draws of different geometry in a block need no rebinding and
+// address their data by first index and base vertex. Allocations are tracked by handles, which
+// stay valid while defragment moves their data.
+class GeometryArena {
+public:
+    static const size_t NULL_ALLOCATION = ~size_t(0);
+
+private:
+    // first fit over free ranges kept ordered by offset, neighbours are merged on free
+    class FreeList {
+    public:
+        map<size_t, size_t> ranges;
+        size_t capacity = 0;
+        size_t used = 0;
+
+        FreeList(const size_t& capacity = 0);
+
+        bool allocate(const size_t& size, size_t& offset);
+
+        void free(const size_t& offset, const size_t& size);
+
+        size_t getLargestRange(void) const noexcept;
+    };
+
+    class Block {
+    public:
+        GLuint VAO = 0;
+        GLuint VBO = 0;
+        GLuint EBO = 0;
+        GLuint instanceVBO = 0;
+        FreeList vertexRanges;
+        FreeList indexRanges;
+    };
+
+    class Allocation {
+    public:
+        size_t block = 0;
+        size_t firstVertex = 0;
+        size_t vertexCount = 0;
+        size_t firstIndex = 0;
+        size_t indexCount = 0;
+        bool live = false;
+    };
+
+    VertexFormat format;
+    size_t blockVertexCapacity = 0;
+    size_t blockIndexCapacity = 0;
+    vector<Block> blocks;
+    vector<Allocation> allocations;
+    vector<size_t> freeAllocations;
+    GLuint indirectBuffer = 0;
+
+    size_t createBlock(const size_t& vertexCapacity, const size_t& indexCapacity);
+
+    void bindBlockBuffers(const Block& block) const noexcept;
+
+public:
+    GeometryArena(const VertexFormat& format = VertexFormat(), const size_t& blockVertexCapacity = 1 << 20, const size_t& blockIndexCapacity = 3 << 20);
+
+    GeometryArena(const GeometryArena& geometryArena) = delete;
+
+    ~GeometryArena(void);
+
+    GeometryArena& operator=(const GeometryArena& other) = delete;
+
+    // vertexData holds vertexCount vertices encoded in the arena format, indices count from the first of them
+    size_t allocate(const void* vertexData, const size_t& vertexCount, const GLuint* indices, const size_t& indexCount);
+
+    void free(const size_t& allocation) noexcept;
+
+    // packs the live allocations of every fragmented block to its front, returns the bytes copied
+    size_t defragment(void);
+
+    // both expect the vertex array of the allocation to be bound
+    void draw(const size_t& allocation) const noexcept;
+
+    void drawInstanced(const size_t& allocation, const GLsizei& instanceCount) const noexcept;
+
+    void drawObjects(const size_t& allocation, const GLuint& baseInstance, const GLsizei& instanceCount) const noexcept;
+
+    // one call for every command, which may address any allocation of the same block as allocation.
+    // without models the commands index matrices that are already bound elsewhere
+    void drawIndirect(const size_t& allocation, const vector<DrawElementsIndirectCommand>& commands, const vector<mat4>& models);
+
+    DrawElementsIndirectCommand getDrawCommand(const size_t& allocation) const noexcept;
+
+    const VertexFormat& getFormat(void) const noexcept;
+
+    const GLuint& getVAO(const size_t& allocation) const noexcept;
+
+    const GLuint& getVBO(const size_t& allocation) const noexcept;
+
+    const GLuint& getEBO(const size_t& allocation) const noexcept;
+
+    // per instance model matrices of the allocation's block, already set up in its vertex array
+    const GLuint& getInstanceVBO(const size_t& allocation) const noexcept;
+
+    size_t getBlockCount(void) const noexcept;
+
+    size_t getAllocationCount(void) const noexcept;
+
+    size_t getUsedVertexCount(void) const noexcept;
+
+    size_t getVertexCapacity(void) const noexcept;
+
+    size_t getUsedIndexCount(void) const noexcept;
+
+    size_t getIndexCapacity(void) const noexcept;
+
+    // free vertex and index ranges over all blocks, more than one per block means fragmentation
+    size_t getFreeRangeCount(void) const noexcept;
+
+    size_t getLargestFreeVertexRange(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const GeometryArena& geometryArena);
+
+#endif // !GEOMETRY_ARENA_HPP
@@ -0,0 +1,39 @@
+#ifndef GEOMETRY_CACHE_HPP
+#define GEOMETRY_CACHE_HPP
+
+#include <functional>
+#include <unordered_map>
+
+#include <Geometry.hpp>
+
+// Geometry uploaded once per key, typically the path of the model it was loaded from.
+// Entries do not keep their geometry alive, it is freed with the last mesh drawing it.
+class GeometryCache {
+private:
+    unordered_map<string, weak_ptr<Geometry>> geometries;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+
+public:
+    // returns the live geometry stored under key, or stores and returns what create makes
+    shared_ptr<Geometry> load(const string& key, const function<shared_ptr<Geometry>(void)>& create);
+
+    shared_ptr<Geometry> find(const string& key) const noexcept;
+
+    void insert(const string& key, const shared_ptr<Geometry>& geometry);
+
+    bool erase(const string& key) noexcept;
+
+    // drops the entries whose geometry is gone and returns how many were dropped
+    size_t prune(void) noexcept;
+
+    size_t size(void) const noexcept;
+
+    const size_t& getHitCount(void) const noexcept;
+
+    const size_t& getMissCount(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const GeometryCache& geometryCache);
+
+#endif // !GEOMETRY_CACHE_HPP
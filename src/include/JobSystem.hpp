@@ -0,0 +1,128 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+// cpp
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <iostream>
+
+using namespace std;
+
+// Worker threads running jobs from one deque each. Workers push and pop their own jobs at the back and
+// steal from the front of the others when they run dry. Jobs submitted from other threads go to one more
+// deque that every thread takes from. Jobs may depend on other jobs and only become runnable once those
+// finished. Jobs on the main lane only run on the thread that created the job system, in runMainThreadJobs
+// or while it waits, which is where GL work belongs.
+class JobSystem {
+public:
+    enum Lane {
+        WORKER,
+        MAIN_THREAD
+    };
+
+    class Job {
+    public:
+        function<void(void)> task;
+        Lane lane = WORKER;
+        // dependencies still running, plus one while the job is being submitted
+        atomic<size_t> pendingCount;
+        mutex continuationMutex;
+        vector<shared_ptr<Job>> continuations;
+        atomic<bool> finished;
+
+        Job(void);
+    };
+
+private:
+    // one per worker, and one more for jobs submitted from threads that are no worker
+    class Queue {
+    public:
+        mutex queueMutex;
+        deque<shared_ptr<Job>> jobs;
+    };
+
+    vector<thread> workers;
+    vector<unique_ptr<Queue>> queues;
+    Queue mainThreadQueue;
+    thread::id mainThreadId;
+
+    atomic<size_t> queuedCount;
+    atomic<size_t> sleepingCount;
+    mutex sleepMutex;
+    condition_variable wakeUp;
+    // threads in wait with nothing to help with, woken when a job finishes or is queued
+    atomic<size_t> waitingCount;
+    condition_variable jobDone;
+    atomic<bool> stopping;
+
+    atomic<size_t> executedCount;
+    atomic<size_t> stolenCount;
+    atomic<size_t> injectedCount;
+    atomic<size_t> failedStealCount;
+
+    void work(const size_t& worker);
+
+    void schedule(const shared_ptr<Job>& job);
+
+    void finish(const shared_ptr<Job>& job);
+
+    // wakes the threads blocked in wait, sleepMutex orders it after their last check
+    void notifyWaiting(void);
+
+    shared_ptr<Job> take(const size_t& queue) noexcept;
+
+    // runs one runnable job if there is any, false otherwise
+    bool runOne(const size_t& queue, const bool& mainThread);
+
+    size_t getQueueIndex(void) const noexcept;
+
+public:
+    JobSystem(const size_t& workerCount = thread::hardware_concurrency() > 1 ? thread::hardware_concurrency() - 1 : 1);
+
+    JobSystem(const JobSystem& jobSystem) = delete;
+
+    // runs the jobs still queued or waiting on dependencies before the workers stop,
+    // main lane jobs among them on the destroying thread
+    ~JobSystem(void);
+
+    JobSystem& operator=(const JobSystem& other) = delete;
+
+    // the job runs once every dependency finished
+    shared_ptr<Job> run(const function<void(void)>& task, const vector<shared_ptr<Job>>& dependencies = {}, const Lane& lane = WORKER);
+
+    // runs other jobs until job finished, main lane jobs too when called on the main thread.
+    // blocks while there is nothing to run instead of spinning
+    void wait(const shared_ptr<Job>& job);
+
+    // body receives the half open range [begin, end) of one chunk at a time, the calling thread takes part.
+    // chunkCount of 0 picks several chunks per thread so that uneven chunks even out
+    void parallelFor(const size_t& count, const function<void(const size_t&, const size_t&)>& body, const size_t& chunkCount = 0);
+
+    // runs the queued main lane jobs and returns how many ran, only on the main thread
+    size_t runMainThreadJobs(void);
+
+    size_t getWorkerCount(void) const noexcept;
+
+    size_t getExecutedCount(void) const noexcept;
+
+    // jobs taken from the deque of another worker
+    size_t getStolenCount(void) const noexcept;
+
+    // jobs taken from the deque of jobs submitted outside the workers, by any thread
+    size_t getInjectedCount(void) const noexcept;
+
+    size_t getFailedStealCount(void) const noexcept;
+
+    // process wide job system, created with the first call on the thread that will be its main thread
+    static JobSystem& getShared(void);
+};
+
+ostream& operator<< (ostream& out, const JobSystem& jobSystem);
+
+#endif // !JOB_SYSTEM_HPP
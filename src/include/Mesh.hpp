@@ -3,41 +3,87 @@
 
 #include <SceneObject.hpp>
 #include <Shader.hpp>
+#include <RenderQueue.hpp>
+#include <Geometry.hpp>
 
 #include <glm\gtc\type_ptr.hpp>
 
 class Mesh : public SceneObject {
 private:
-    GLuint VBO = 0;
-    GLuint VAO = 0;
+    shared_ptr<Geometry> geometry = nullptr;
     shared_ptr<Shader> shader = nullptr;
-    vector<Vertex> vertices;
-
-    void initialize(void) noexcept;
-
-    void deallocate(void) noexcept;
+    GLint PVMHandle = -1;
+    GLint modelHandle = -1;
+    // shaders with a "PV" uniform take the model matrix as an instanced attribute
+    GLint PVHandle = -1;
 
 public:
-    Mesh(vector<Vertex>&& vertices, const string& name = string(""), const Transform& transform = Transform());
-
-    Mesh(const Mesh& mesh) = delete;
+    // triangle soup, identical vertices are welded into an index buffer
+    Mesh(
+        vector<Vertex>&& vertices,
+        const string& name = string(""),
+        const Transform& transform = Transform(),
+        const Geometry::Retention& retention = Geometry::getDefaultRetention()
+    );
+
+    Mesh(
+        vector<Vertex>&& vertices,
+        vector<GLuint>&& indices,
+        const string& name = string(""),
+        const Transform& transform = Transform(),
+        const Geometry::Retention& retention = Geometry::getDefaultRetention()
+    );
+
+    Mesh(const shared_ptr<Geometry>& geometry, const string& name = string(""), const Transform& transform = Transform());
+
+    // copies place the same geometry again without its children, nothing is uploaded
+    Mesh(const Mesh& mesh);
     
     Mesh(Mesh&& mesh);
 
-    ~Mesh(void);
-
-    Mesh& operator=(const Mesh& other) noexcept = delete;
+    Mesh& operator=(const Mesh& other) noexcept;
 
     Mesh& operator=(Mesh&& other) noexcept;
 
-    void draw(const mat4& ProjectionViewMatrix) const override;
+    void render(const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const override;
+
+    void enqueue(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const override;
+
+    void submit(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const override;
+
+    void submitInstances(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const vector<mat4>& models) const override;
+
+    bool getIndirectDraw(const CachedTransform& worldTransform, DrawElementsIndirectCommand& command, mat4& model) const override;
+
+    void submitIndirect(
+        RenderQueue& renderQueue,
+        const mat4& ProjectionViewMatrix,
+        const vector<DrawElementsIndirectCommand>& commands,
+        const vector<mat4>& models
+    ) const override;
+
+    void submitObjects(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const GLuint& firstObjectIndex, const GLsizei& objectCount) const override;
+
+    mat4 getModelMatrix(const CachedTransform& worldTransform) const noexcept override;
+
+    void getModelDualQuaternion(const CachedTransform& worldTransform, fdualquat& translationAndRotation, vec3& scale) const noexcept override;
+
+    bool getBoundingSphere(BoundingSphere& boundingSphere) const noexcept override;
+
+    const shared_ptr<Geometry>& getGeometry(void) const noexcept;
 
     const vector<Vertex>& getVertices(void) const noexcept;
     
+    const vector<GLuint>& getIndices(void) const noexcept;
+
     const GLuint& getVBO(void) const noexcept;
     
     const GLuint& getVAO(void) const noexcept;
 
+    const GLuint& getEBO(void) const noexcept;
+
+    const GLenum& getIndexType(void) const noexcept;
+
     const shared_ptr<Shader>& getShader(void) const noexcept;
 
     void setShader(const shared_ptr<Shader>& shader) noexcept;
@@ -0,0 +1,24 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+// cpp
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+#include <JobSystem.hpp>
+
+using namespace std;
+
+// Runs body over [0, count) split into chunks for threadCount threads, the calling thread included.
+// body receives the half open range [begin, end) of one chunk at a time. Chunks run on the workers of
+// JobSystem::getShared, so no threads are started per call and threadCount only sets the chunking.
+void parallelFor(const size_t& count, const size_t& threadCount, const function<void(const size_t&, const size_t&)>& body);
+
+// the same on the workers of jobSystem
+void parallelFor(const size_t& count, const size_t& threadCount, const function<void(const size_t&, const size_t&)>& body, JobSystem& jobSystem);
+
+size_t getHardwareThreadCount(void) noexcept;
+
+#endif // !PARALLEL_HPP
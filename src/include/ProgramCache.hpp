@@ -0,0 +1,57 @@
+#ifndef PROGRAM_CACHE_HPP
+#define PROGRAM_CACHE_HPP
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include <glad\glad.h>
+
+using namespace std;
+
+// Linked program binaries kept on disk between launches, one file per program in directory.
+// Files are named after a hash of the shader sources and of the GL vendor, renderer and version strings,
+// so a driver update misses instead of loading a binary the driver rejects. Needs a current context.
+class ProgramCache {
+private:
+    string directory;
+    string driver;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    size_t rejectedCount = 0;
+    double loadMilliseconds = 0.0;
+    double compileMilliseconds = 0.0;
+    double savedMilliseconds = 0.0;
+
+    string getPath(const vector<string>& sources) const;
+
+public:
+    ProgramCache(const string& directory);
+
+    // loads the binary stored for sources into program, false if there is none or the driver rejects it
+    bool load(const vector<string>& sources, const GLuint& program);
+
+    // stores the binary of a program linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT, along with the time
+    // compiling and linking took, which later hits report as saved
+    void store(const vector<string>& sources, const GLuint& program, const double& compileMilliseconds);
+
+    const string& getDirectory(void) const noexcept;
+
+    const size_t& getHitCount(void) const noexcept;
+
+    const size_t& getMissCount(void) const noexcept;
+
+    // binaries found on disk but refused by glProgramBinary, also counted as misses
+    const size_t& getRejectedCount(void) const noexcept;
+
+    const double& getLoadMilliseconds(void) const noexcept;
+
+    const double& getCompileMilliseconds(void) const noexcept;
+
+    // compile time stored with every hit binary, minus the time spent loading them
+    const double& getSavedMilliseconds(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const ProgramCache& programCache);
+
+#endif // !PROGRAM_CACHE_HPP
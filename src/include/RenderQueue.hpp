@@ -0,0 +1,137 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <SceneObject.hpp>
+#include <Shader.hpp>
+#include <GeometryArena.hpp>
+
+// Draw packets collected from the visible objects of a frame, sorted by a 64 bit key and
+// submitted in key order. Binds are tracked while submitting so that neighbouring packets
+// sharing a program or vertex array do not bind it again, and neighbouring packets with the
+// same state and batch are handed to the first object as one list of model matrices, or as one
+// list of indirect draw commands when the objects of the batch can be drawn indirectly.
+// Key layout from the most significant bit: pass, shader, material, vertex array, geometry, depth.
+// Geometry sits above depth so that draws of one geometry in an arena stay next to each other and
+// become one indirect command, whatever their depth. Programs, vertex arrays and geometry go into
+// keys as indices dense per frame, handed out by the queue.
+class RenderQueue {
+public:
+    static const unsigned PASS_BITS = 4;
+    static const unsigned SHADER_BITS = 10;
+    static const unsigned MATERIAL_BITS = 10;
+    static const unsigned VERTEX_ARRAY_BITS = 12;
+    static const unsigned GEOMETRY_BITS = 12;
+    static const unsigned DEPTH_BITS = 16;
+
+private:
+    class DrawPacket {
+    public:
+        uint64_t key = 0;
+        const SceneObject* sceneObject = nullptr;
+        const CachedTransform* worldTransform = nullptr;
+        // packets may only be drawn together when they point to the same batch
+        const void* batch = nullptr;
+        // the real state, indices in the key wrap once a frame uses more programs or vertex arrays than fit
+        GLuint program = 0;
+        GLuint vertexArray = 0;
+    };
+
+    vector<DrawPacket> packets;
+    vector<DrawPacket> sortBuffer;
+    vector<mat4> instanceModels;
+    vector<DrawElementsIndirectCommand> drawCommands;
+    unordered_map<GLuint, unsigned> programIndices;
+    unordered_map<GLuint, unsigned> vertexArrayIndices;
+    unordered_map<const void*, unsigned> geometryIndices;
+    // the last lookups, neighbouring objects mostly share their state
+    pair<GLuint, unsigned> lastProgramIndex = make_pair(0u, ~0u);
+    pair<GLuint, unsigned> lastVertexArrayIndex = make_pair(0u, ~0u);
+    pair<const void*, unsigned> lastGeometryIndex = make_pair((const void*)nullptr, ~0u);
+    GLuint boundProgram = 0;
+    GLuint boundVertexArray = 0;
+    size_t bindCount = 0;
+    size_t skippedBindCount = 0;
+    size_t drawCount = 0;
+    size_t commandCount = 0;
+    bool worldMatrixIndexing = false;
+
+    void submitBatch(const mat4& ProjectionViewMatrix, const size_t& begin, const size_t& end);
+
+    // draws the gathered indirect commands through the object of packet first
+    void submitCommands(const mat4& ProjectionViewMatrix, const size_t& first);
+
+    // draws one packet of an instancing batch that cannot be drawn indirectly
+    void submitSingle(const mat4& ProjectionViewMatrix, const size_t& packet);
+
+public:
+    // shader, vertexArray and geometry are the indices from getProgramIndex, getVertexArrayIndex and getGeometryIndex
+    static uint64_t makeKey(
+        const unsigned& pass,
+        const unsigned& shader,
+        const unsigned& material,
+        const unsigned& vertexArray,
+        const unsigned& geometry,
+        const float& depth
+    ) noexcept;
+
+    // forgets the packets and the indices handed out for them
+    void clear(void) noexcept;
+
+    // indices in order of first use this frame
+    unsigned getProgramIndex(const GLuint& program);
+
+    unsigned getVertexArrayIndex(const GLuint& vertexArray);
+
+    unsigned getGeometryIndex(const void* geometry);
+
+    void push(
+        const uint64_t& key,
+        const SceneObject* sceneObject,
+        const CachedTransform* worldTransform,
+        const void* batch = nullptr,
+        const GLuint& program = 0,
+        const GLuint& vertexArray = 0
+    );
+
+    void sort(void);
+
+    void submit(const mat4& ProjectionViewMatrix);
+
+    void useProgram(const Shader& shader);
+
+    void bindVertexArray(const GLuint& vertexArray);
+
+    // forgets the tracked binds after GL state was changed behind the queue's back
+    void resetBindings(void) noexcept;
+
+    // the model matrix of every packet in sorted order, the position of a packet is its object index
+    void writeModelMatrices(mat4* models) const noexcept;
+
+    // the same transforms packed as dual quaternions, three vec4 per packet or two with uniformScale
+    void writeDualQuaternions(vec4* packed, const bool& uniformScale) const noexcept;
+
+    // when set, instancing batches read their model matrices from the world matrix buffer by object index
+    // instead of uploading instance matrices, which requires writeModelMatrices after sort
+    void setWorldMatrixIndexing(const bool& worldMatrixIndexing) noexcept;
+
+    const bool& isWorldMatrixIndexing(void) const noexcept;
+
+    size_t size(void) const noexcept;
+
+    // counters of the last submit
+    const size_t& getBindCount(void) const noexcept;
+
+    const size_t& getSkippedBindCount(void) const noexcept;
+
+    const size_t& getDrawCount(void) const noexcept;
+
+    // indirect commands written by the last submit, each covering one or more instances
+    const size_t& getCommandCount(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const RenderQueue& renderQueue);
+
+#endif // !RENDER_QUEUE_HPP
@@ -0,0 +1,73 @@
+#ifndef SCENE_COMMAND_QUEUE_HPP
+#define SCENE_COMMAND_QUEUE_HPP
+
+// cpp
+#include <atomic>
+
+#include <SceneObject.hpp>
+
+// Structural edits recorded by any thread and applied together at a sync point chosen by the thread
+// that owns the scene, so traversals never see children vectors change underneath them. Recording
+// is a single compare and swap. Commands recorded by one thread are applied in the order they were recorded.
+class SceneCommandQueue {
+public:
+    enum Type {
+        APPEND_CHILD,
+        REMOVE_CHILD,
+        REPARENT,
+        RENAME,
+        SET_TRANSFORM
+    };
+
+private:
+    class Command {
+    public:
+        Type type;
+        shared_ptr<SceneObject> sceneObject;
+        shared_ptr<SceneObject> parent;
+        string name;
+        Transform transform;
+        Command* next = nullptr;
+
+        Command(const Type& type, const shared_ptr<SceneObject>& sceneObject);
+    };
+
+    // newest first, apply reverses it
+    atomic<Command*> head;
+    size_t appliedCount = 0;
+
+    void push(Command* command) noexcept;
+
+public:
+    SceneCommandQueue(void);
+
+    SceneCommandQueue(const SceneCommandQueue& sceneCommandQueue) = delete;
+
+    ~SceneCommandQueue(void);
+
+    SceneCommandQueue& operator=(const SceneCommandQueue& other) = delete;
+
+    void appendChild(const shared_ptr<SceneObject>& parent, const shared_ptr<SceneObject>& child);
+
+    void removeChild(const shared_ptr<SceneObject>& parent, const shared_ptr<SceneObject>& child);
+
+    // a null parent detaches the object from its current parent
+    void reparent(const shared_ptr<SceneObject>& sceneObject, const shared_ptr<SceneObject>& parent);
+
+    void rename(const shared_ptr<SceneObject>& sceneObject, const string& name);
+
+    // world space, as SceneObject::setTransform
+    void setTransform(const shared_ptr<SceneObject>& sceneObject, const Transform& transform);
+
+    // applies and drops every command recorded so far and returns how many, on the thread owning the scene
+    size_t apply(void);
+
+    bool empty(void) const noexcept;
+
+    // commands applied over the lifetime of the queue
+    const size_t& getAppliedCount(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const SceneCommandQueue& sceneCommandQueue);
+
+#endif // !SCENE_COMMAND_QUEUE_HPP
@@ -1,22 +1,151 @@
 #ifndef SCENE_GRAPH_HPP
 #define SCENE_GRAPH_HPP
 
-#include <SceneObject.hpp>
+#include <SceneHierarchy.hpp>
+#include <SceneIndex.hpp>
+#include <Frustum.hpp>
+#include <RenderQueue.hpp>
+#include <WorldMatrixBuffer.hpp>
+#include <SceneCommandQueue.hpp>
+#include <SceneSnapshot.hpp>
+#include <JobSystem.hpp>
 
 class SceneGraph {
 private:
     shared_ptr<SceneObject> root = nullptr;
+    // when set, transforms and traversal come from the flat storage instead of the pointer tree.
+    // it follows edits made through the scene objects, so it is built once by flatten
+    shared_ptr<SceneHierarchy> hierarchy = nullptr;
+    shared_ptr<SceneIndex> index = nullptr;
+    shared_ptr<BoundingVolumeHierarchy> boundingVolumeHierarchy = nullptr;
 
-    shared_ptr<SceneObject> getSceneObject(const string& name, const shared_ptr<SceneObject>& sceneObject) const noexcept;
+    // culling state of the last frame, the buffers are kept to avoid reallocating every frame
+    mutable vector<pair<const SceneObject*, const CachedTransform*>> candidates;
+    mutable vector<pair<const SceneObject*, const CachedTransform*>> visibleObjects;
+    mutable vector<float> centerX;
+    mutable vector<float> centerY;
+    mutable vector<float> centerZ;
+    mutable vector<float> radius;
+    mutable vector<unsigned char> visibility;
+    // what a bounding volume hierarchy query returned, objects or snapshot slots
+    mutable vector<const SceneObject*> queriedObjects;
+    mutable vector<size_t> queriedLeaves;
+    mutable vector<size_t> queriedSlots;
+    mutable size_t visibleCount = 0;
+    mutable size_t culledCount = 0;
+    mutable size_t prunedCount = 0;
+    mutable RenderQueue renderQueue;
+    // when set, model matrices of visible objects are uploaded once per frame and drawn by object index
+    shared_ptr<WorldMatrixBuffer> worldMatrixBuffer = nullptr;
+    // structural edits from other threads, applied by applyCommands
+    SceneCommandQueue commandQueue;
+    // when set, the simulation publishes snapshots that a render thread draws
+    shared_ptr<SceneSnapshotBuffer> snapshotBuffer = nullptr;
+    // background releases run one after the other, the last one handed to the job system
+    mutable shared_ptr<JobSystem::Job> lastRelease = nullptr;
+
+    // runs release on a worker once the releases before it are done
+    void releaseInBackground(const function<void(void)>& release) const;
+
+    // unregisters destroyed subtrees from the index and the structures kept along with it, on the thread
+    // editing the scene, and hands the references the index held to a worker
+    void releaseIndexNodes(void) const;
+
+    // drops released hierarchy ranges and moves misplaced ones in place once they make up a quarter of the nodes,
+    // which keeps the pass over the arrays at a constant cost per edited node, and hands their scene objects to a worker
+    void releaseHierarchyNodes(void) const;
+
+    // objects referenced from outside the scene, which outlive it. owners is the count of references
+    // the scene holds through the parent of sceneObject or through the root
+    void findSurvivors(const shared_ptr<SceneObject>& sceneObject, const long& owners, vector<shared_ptr<SceneObject>>& survivors) const;
+
+    // on this thread alone without a job system
+    void propagateTransforms(const size_t& threadCount, JobSystem* jobSystem) const;
+
+    void gatherCandidates(const SceneObject* sceneObject, const Frustum& frustum) const;
+
+    void gatherCandidates(const SceneHierarchy& sceneHierarchy, const Frustum& frustum) const;
+
+    // whether sceneObject or one of its ancestors is released or rejected as a whole branch
+    bool isPruned(const SceneObject* sceneObject, const Frustum& frustum) const noexcept;
+
+    void addCandidate(const SceneObject* sceneObject, const CachedTransform* worldTransform) const;
+
+    // a null world transform is looked up from the object once it passes the test
+    void addCandidate(const SceneObject* sceneObject, const CachedTransform* worldTransform, const BoundingSphere& worldBounds) const;
+
+    void clearCandidates(void) const noexcept;
+
+    const vector<pair<const SceneObject*, const CachedTransform*>>& testCandidates(const Frustum& frustum) const;
+
+    void drawVisible(const mat4& ProjectionViewMatrix, const vector<pair<const SceneObject*, const CachedTransform*>>& visible) const;
 
 public:
     SceneGraph(const shared_ptr<SceneObject>& root = make_shared<SceneObject>(string("World")));
 
+    // the objects, and the structures referring to them, are released in the background.
+    // objects still referenced elsewhere are detached from the scene on this thread first
+    ~SceneGraph(void);
+
+    // unlinks sceneObject from its parent, where the last sibling takes its place, and flags its subtree as released.
+    // lookups, culling and the hierarchy skip the subtree from then on. the next propagation unregisters it and
+    // hands it to a worker of the shared job system, so the destructors of the subtree run there once no other
+    // reference is left. GL objects they free are deleted by the next draw. the subtree must not be used again
+    void destroySceneObject(shared_ptr<SceneObject> sceneObject);
+
+    // unregisters the subtrees destroyed so far and waits for the background releases, helping with them on this thread
+    void waitForReleases(void) const;
+
+    // the sync point for edits recorded into getCommandQueue, call it between frames on the thread drawing the scene
+    size_t applyCommands(void);
+
+    SceneCommandQueue& getCommandQueue(void) noexcept;
+
+    // threadCount above 1 splits the work between the workers of the shared job system and this thread
+    void propagateTransforms(const size_t& threadCount = 1) const;
+
+    // splits the work between the workers of jobSystem and this thread
+    void propagateTransforms(JobSystem& jobSystem) const;
+
     void draw(const mat4& ProjectionViewMatrix) const noexcept;
 
-    shared_ptr<SceneObject> getSceneObject(const string& name) const noexcept;
+    const vector<pair<const SceneObject*, const CachedTransform*>>& cull(const mat4& ProjectionViewMatrix) const;
+
+    // draws and culls what a snapshot holds instead of the live objects, on the render thread
+    void draw(const SceneSnapshot& snapshot, const mat4& ProjectionViewMatrix) const noexcept;
+
+    const vector<pair<const SceneObject*, const CachedTransform*>>& cull(const SceneSnapshot& snapshot, const mat4& ProjectionViewMatrix) const;
+
+    const shared_ptr<SceneObject>& getSceneObject(const string& name) const noexcept;
 
     const shared_ptr<SceneObject>& getRoot(void) const noexcept;
+
+    void flatten(void);
+
+    const shared_ptr<SceneHierarchy>& getHierarchy(void) const noexcept;
+
+    // culling walks the scene tree unless this is called. the tree only prunes as well as objects are grouped by place,
+    // the hierarchy prunes by place alone and is worth building when groups are spread out or snapshots are culled
+    void buildBoundingVolumeHierarchy(void);
+
+    const shared_ptr<BoundingVolumeHierarchy>& getBoundingVolumeHierarchy(void) const noexcept;
+
+    const size_t& getVisibleCount(void) const noexcept;
+
+    const size_t& getCulledCount(void) const noexcept;
+
+    const RenderQueue& getRenderQueue(void) const noexcept;
+
+    void createWorldMatrixBuffer(const WorldMatrixBuffer::Layout& layout = WorldMatrixBuffer::MATRIX);
+
+    const shared_ptr<WorldMatrixBuffer>& getWorldMatrixBuffer(void) const noexcept;
+
+    void createSnapshotBuffer(void);
+
+    // propagates first, so descendants of edited objects are rebuilt and reported to the snapshot buffer
+    void publishSnapshot(void);
+
+    const shared_ptr<SceneSnapshotBuffer>& getSnapshotBuffer(void) const noexcept;
 };
 
 ostream& operator<< (ostream& out, const SceneGraph& sceneGraph);
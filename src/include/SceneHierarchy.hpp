@@ -0,0 +1,183 @@
+#ifndef SCENE_HIERARCHY_HPP
+#define SCENE_HIERARCHY_HPP
+
+#include <SceneObject.hpp>
+
+// Flat storage for a scene: per-node data lives in parallel arrays in depth first pre-order, so every
+// parent precedes its children, which turns transform propagation into a single linear pass, and every
+// subtree is the contiguous range of subtreeSizes nodes starting at its root.
+// Once a tree is flattened the hierarchy owns the transforms of its nodes: scene objects keep a
+// back-pointer to their node, read their transforms from the arrays and write local transforms
+// into them, and appending or removing children adds or removes the matching nodes.
+// Edits never renumber the nodes behind them: removed ranges stay behind as released ranges without
+// scene objects, and a subtree appended to a range other nodes follow goes to the end of the arrays,
+// away from its parent, where it stays a misplaced range of its own. compact drops the former and moves
+// the latter in place in one pass, so edits cost the size of the edited subtree instead of the whole scene.
+// A node whose scene object has a parent outside the hierarchy follows the world transform of that parent.
+class SceneHierarchy {
+    friend class SceneObject;
+
+public:
+    static const size_t NO_PARENT = ~size_t(0);
+
+    // levels narrower than this are not worth handing to other threads
+    static const size_t MIN_PARALLEL_LEVEL_SIZE = 1024;
+
+    enum Flags : unsigned char {
+        DIRTY = 1 << 0,
+        // set on the first node of a released range only
+        RELEASED = 1 << 1,
+        // rebuilt by the running propagation pass, whose scene object is told once the pass is done
+        CHANGED = 1 << 2,
+        // the scene object observes its world transform, the passes leave the others alone
+        OBSERVED = 1 << 3
+    };
+
+private:
+    vector<Transform> localTransforms;
+    // world transforms are resolved lazily. a node is rebuilt when it is dirty or when the version of its
+    // parent differs from the one it was built from, the same way scene objects outside a hierarchy are
+    mutable vector<CachedTransform> worldTransforms;
+    mutable vector<size_t> worldVersions;
+    mutable vector<size_t> parentVersions;
+    mutable vector<size_t> checkedEpochs;
+    vector<size_t> parents;
+    // node count of the subtree starting at every node, the node included
+    vector<size_t> subtreeSizes;
+    mutable vector<unsigned char> flags;
+    vector<shared_ptr<SceneObject>> sceneObjects;
+    // name lookup for findNode when set, scanned otherwise
+    const SceneIndex* index = nullptr;
+
+    // nodes released or removed since the last compact, which traversal skips until compact drops them.
+    // a range released inside another one is counted twice, so this is an upper bound
+    size_t releasedCount = 0;
+    // nodes appended away from the range of their parent since the last compact, removed ones included
+    size_t misplacedCount = 0;
+    // scene objects of dropped released nodes, no longer referring to this hierarchy, until takeReleased
+    vector<shared_ptr<SceneObject>> releasedObjects;
+
+    // node indices grouped by depth, rebuilt lazily after structural changes
+    vector<size_t> levelNodes;
+    vector<size_t> levelOffsets;
+    bool levelsDirty = true;
+
+    // edit epoch of the last full pass, a pass is skipped while no transform was edited since
+    size_t propagatedEpoch = 0;
+
+    void buildLevels(void);
+
+    // inserts a subtree given in pre-order at the end of the range of parent, or of the arrays when other nodes follow it.
+    // subtreeParents index into subtree, NO_PARENT for its root. the scene objects are moved out of subtree
+    size_t insertNodes(vector<shared_ptr<SceneObject>>& subtree, const vector<size_t>& subtreeParents, const size_t& parent);
+
+    // true when the node was rebuilt. its scene object is left to the caller to tell
+    bool propagateNode(const size_t& index, const size_t& epoch) const noexcept;
+
+    // tells the observing scene objects of the nodes rebuilt by a pass, after it so the pass itself stays within the arrays
+    void notifyChanged(void) const noexcept;
+
+    // compact for misplaced nodes, which rebuilds the pre-order instead of closing gaps
+    void reorder(void);
+
+    // the first nodes of the range of sceneObject and of the misplaced ranges below it
+    void gatherRanges(const SceneObject* sceneObject, vector<size_t>& firsts) const;
+
+    // hands the transforms of a node back to its scene object, which stops referring to this hierarchy
+    void detachNode(const size_t& index) noexcept;
+
+    // moves the scene objects of the released range starting at index to releasedObjects, returns its end
+    size_t dropReleased(const size_t& index);
+
+    void markDirty(const size_t& index) noexcept;
+
+    bool isDirty(const size_t& index) const noexcept;
+
+    bool isStale(const size_t& index, const size_t& parentVersion) const noexcept;
+
+    const size_t& getWorldTransformVersion(const size_t& index) const noexcept;
+
+    void storeLocalTransform(const size_t& index, const Transform& localTransform) noexcept;
+
+    void setObserved(const size_t& index, const bool& observed) noexcept;
+
+public:
+    SceneHierarchy(void) = default;
+
+    SceneHierarchy(const shared_ptr<SceneObject>& root);
+
+    SceneHierarchy(const SceneHierarchy& sceneHierarchy) = delete;
+
+    ~SceneHierarchy(void);
+
+    SceneHierarchy& operator=(const SceneHierarchy& other) = delete;
+
+    void build(const shared_ptr<SceneObject>& root);
+
+    void clear(void) noexcept;
+
+    // a scene object belongs to one hierarchy at a time, appending it takes it out of any other one
+    size_t appendNode(const shared_ptr<SceneObject>& sceneObject, const size_t& parent = NO_PARENT);
+
+    // appends sceneObject and its descendants in depth first pre-order
+    size_t appendSubtree(const shared_ptr<SceneObject>& sceneObject, const size_t& parent = NO_PARENT);
+
+    // removes the node together with its subtree. the scene objects are let go at once,
+    // their nodes stay behind as a released range until compact
+    void removeNode(const size_t& index);
+
+    // marks the node and its subtree as released without moving anything, and flags their scene objects as released.
+    // traversals skip the range, which stays in place until compact drops it together with every other released range
+    void releaseNode(const size_t& index);
+
+    // whether a released range starts at the node
+    bool isReleased(const size_t& index) const noexcept;
+
+    // whether a misplaced range starts at the node, which the range of its parent does not hold
+    bool isMisplaced(const size_t& index) const noexcept;
+
+    const size_t& getReleasedCount(void) const noexcept;
+
+    const size_t& getMisplacedCount(void) const noexcept;
+
+    // drops every released range and moves misplaced nodes behind their parents in one pass over the arrays
+    void compact(void);
+
+    // hands over the scene objects of dropped released nodes, so the caller decides where they are destroyed
+    vector<shared_ptr<SceneObject>> takeReleased(void) noexcept;
+
+    void propagateTransforms(void) noexcept;
+
+    // levels wide enough are split between threadCount threads, the workers of jobSystem and the calling one
+    void propagateTransforms(const size_t& threadCount, JobSystem& jobSystem);
+
+    void draw(const mat4& ProjectionViewMatrix) const noexcept;
+
+    // goes through the index when one is set. with several namesakes the index decides which one is found
+    size_t findNode(const string& name) const noexcept;
+
+    void setIndex(const SceneIndex* index) noexcept;
+
+    shared_ptr<SceneObject> getSceneObject(const string& name) const noexcept;
+
+    // nodes of released ranges included, the scene objects of removed ones are null
+    size_t size(void) const noexcept;
+
+    const shared_ptr<SceneObject>& getSceneObject(const size_t& index) const noexcept;
+
+    const size_t& getParent(const size_t& index) const noexcept;
+
+    // the subtree of a node ends at index + getSubtreeSize(index), apart from the misplaced ranges below it
+    const size_t& getSubtreeSize(const size_t& index) const noexcept;
+
+    const Transform& getLocalTransform(const size_t& index) const noexcept;
+
+    // the same as setting it on the scene object of the node
+    void setLocalTransform(const size_t& index, const Transform& localTransform) noexcept;
+
+    const CachedTransform& getWorldTransform(const size_t& index) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const SceneHierarchy& sceneHierarchy);
+
+#endif // !SCENE_HIERARCHY_HPP
@@ -0,0 +1,72 @@
+#ifndef SCENE_INDEX_HPP
+#define SCENE_INDEX_HPP
+
+// cpp
+#include <unordered_map>
+
+#include <BoundingVolumeHierarchy.hpp>
+#include <SceneSnapshot.hpp>
+
+// Name lookup for every scene object below a registered root.
+// Scene objects keep it up to date as they are renamed, appended or removed.
+// When several objects share a name the one registered first is returned.
+// Subtrees destroyed through SceneGraph::destroySceneObject stay registered, flagged as released, until the
+// thread editing the scene flushes them. Lookups pass over flagged objects, so they never walk up the tree.
+class SceneIndex {
+private:
+    unordered_map<string, vector<shared_ptr<SceneObject>>> sceneObjects;
+    // registered objects are kept in this hierarchy as well when set
+    BoundingVolumeHierarchy* boundingVolumeHierarchy = nullptr;
+    SceneSnapshotBuffer* snapshotBuffer = nullptr;
+
+    // roots of released subtrees waiting for flushReleases
+    vector<shared_ptr<SceneObject>> pendingReleases;
+
+    void insertNode(const shared_ptr<SceneObject>& sceneObject);
+
+    void eraseNode(const SceneObject* sceneObject, const string& name) noexcept;
+
+    // erases the nodes registered here, without their descendants, and moves the references the index held to erased
+    void eraseNodes(const vector<SceneObject*>& nodes, vector<shared_ptr<SceneObject>>& erased) noexcept;
+
+    static void gatherSubtree(SceneObject* sceneObject, vector<SceneObject*>& sceneObjects);
+
+public:
+    SceneIndex(void) = default;
+
+    SceneIndex(const SceneIndex& sceneIndex) = delete;
+
+    ~SceneIndex(void);
+
+    SceneIndex& operator=(const SceneIndex& other) = delete;
+
+    void insert(const shared_ptr<SceneObject>& sceneObject);
+
+    void erase(const shared_ptr<SceneObject>& sceneObject) noexcept;
+
+    // erases several subtrees at once. namesakes are filtered once per name instead of searched once per object
+    void erase(const vector<shared_ptr<SceneObject>>& sceneObjects) noexcept;
+
+    void rename(const SceneObject* sceneObject, const string& oldName, const string& newName);
+
+    // released namesakes are passed over
+    const shared_ptr<SceneObject>& find(const string& name) const noexcept;
+
+    size_t size(void) const noexcept;
+
+    void setBoundingVolumeHierarchy(BoundingVolumeHierarchy* boundingVolumeHierarchy);
+
+    void setSnapshotBuffer(SceneSnapshotBuffer* snapshotBuffer);
+
+    // queues a subtree whose objects are flagged as released, it stays registered until flushReleases
+    void release(shared_ptr<SceneObject> sceneObject);
+
+    // unregisters the queued subtrees from this index, the bounding volume hierarchy and the snapshot buffer.
+    // the references held to them are moved to released, so the caller decides where they are destroyed
+    void flushReleases(vector<shared_ptr<SceneObject>>& released);
+
+    // whether released subtrees are still registered
+    bool isReleasing(void) const noexcept;
+};
+
+#endif // !SCENE_INDEX_HPP
@@ -5,16 +5,120 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <atomic>
 
-#include <Transform.hpp>
+#include <glad\glad.h>
+
+#include <BoundingSphere.hpp>
 
 using namespace std;
 
+class SceneIndex;
+class SceneHierarchy;
+class BoundingVolumeHierarchy;
+class SceneSnapshotBuffer;
+class SceneGraph;
+class RenderQueue;
+class DrawElementsIndirectCommand;
+class JobSystem;
+
 class SceneObject {
+    friend class SceneIndex;
+    friend class SceneHierarchy;
+    friend class BoundingVolumeHierarchy;
+    friend class SceneSnapshotBuffer;
+    friend class SceneGraph;
+
 protected:
-    Transform transform = Transform();
+    // transform relative to the parent, and the cached world transform derived from it along with its matrix.
+    // an edit only marks the edited node. every rebuild of a world transform bumps its version, and a node
+    // whose parent version differs from the one it was built from is rebuilt when it is read next.
+    // while the object is a node of a flattened hierarchy the hierarchy holds all of this instead
+    Transform localTransform = Transform();
+    mutable CachedTransform worldTransform = CachedTransform();
+    mutable bool worldTransformDirty = false;
+    mutable size_t worldTransformVersion = 0;
+    mutable size_t parentTransformVersion = 0;
+    // epoch at which the world transform was last found current, reads in the same epoch return it right away
+    mutable size_t checkedTransformEpoch = 0;
+    // set on every ancestor of a dirty node and on nodes rebuilt since the last propagation, so propagation
+    // finds stale subtrees below a clean root. a flagged node implies a flagged parent
+    mutable bool descendantTransformDirty = false;
+    SceneObject* parent = nullptr;
+    // position of this object among the children of its parent
+    size_t childIndex = 0;
     vector<shared_ptr<SceneObject>> children;
+    // set on every object of a subtree destroyed through SceneGraph::destroySceneObject. lookups and culling
+    // skip it until its registrations are flushed, and its destructor tears the subtree down as it is.
+    // kept next to the children, which marking the subtree reads as well
+    bool released = false;
     string name = string("");
+    // node holding this object in a flattened hierarchy, if any
+    SceneHierarchy* hierarchy = nullptr;
+    size_t hierarchyNode = ~size_t(0);
+    // name index of the scene graph this object belongs to, if any
+    SceneIndex* index = nullptr;
+    // world space bounds of every bounded object in this subtree.
+    // dirty bounds imply dirty bounds on every ancestor, so only the dirty path is refit. bounds built from an older
+    // version of the world transform of their node are refit as well, and nodes resolve their world transform
+    // before handing out their bounds
+    mutable BoundingSphere subtreeBounds = BoundingSphere();
+    mutable size_t subtreeBoundedCount = 0;
+    mutable bool subtreeBoundsDirty = true;
+    mutable size_t subtreeBoundsVersion = 0;
+    // leaf holding this object in the bounding volume hierarchy of its scene graph, if any
+    BoundingVolumeHierarchy* boundingVolumeHierarchy = nullptr;
+    size_t boundingVolumeLeaf = ~size_t(0);
+    // slot of this object in the snapshots published for a render thread, if any
+    SceneSnapshotBuffer* snapshotBuffer = nullptr;
+    size_t snapshotSlot = ~size_t(0);
+
+    // bumped by every edit to a transform or to the structure of any scene, which invalidates all checked epochs
+    static atomic<size_t> transformEpoch;
+
+    void markTransformDirty(void) noexcept;
+
+    bool isTransformDirty(void) const noexcept;
+
+    // whether propagation below a parent whose world transform has parentVersion has to visit this node
+    bool needsPropagation(const size_t& parentVersion) const noexcept;
+
+    void resolveWorldTransform(void) const noexcept;
+
+    // version of the world transform returned by the last getWorldTransform
+    const size_t& getWorldTransformVersion(void) const noexcept;
+
+    // called whenever the world transform is rebuilt, possibly on a propagation thread
+    virtual void worldTransformChanged(void) const noexcept;
+
+    // whether worldTransformChanged does more than flag the descendants for propagation. the passes of a
+    // flattened hierarchy only call it on objects for which this holds
+    virtual bool isWorldTransformObserved(void) const noexcept;
+
+    // tells the hierarchy holding this object that isWorldTransformObserved may have changed
+    void observersChanged(void) noexcept;
+
+    // stores the local transform wherever it lives, without invalidating anything
+    void storeLocalTransform(const Transform& localTransform) noexcept;
+
+    void markBoundsDirty(void) noexcept;
+
+    void markDescendantTransformDirty(void) noexcept;
+
+    void invalidateTransform(void) noexcept;
+
+    void refitSubtreeBounds(void) const noexcept;
+
+    bool isSubtreeBoundsDirty(void) const noexcept;
+
+    void setParent(SceneObject* parent) noexcept;
+
+    void adoptChildren(void) noexcept;
+
+    void releaseChildren(void) noexcept;
+
+    // flags this object and its descendants as released
+    void markReleased(void) noexcept;
 
 public:
     SceneObject(const string& name = string(""), const Transform& transform = Transform());
@@ -33,16 +137,71 @@ public:
 
     virtual void draw(const mat4& ProjectionViewMatrix) const;
 
+    virtual void render(const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const;
+
+    // queued drawing, objects push draw packets and are called back in key order to draw them
+    virtual void enqueue(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const;
+
+    virtual void submit(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const;
+
+    // draws every packet of an instancing batch this object heads, one model matrix per packet
+    virtual void submitInstances(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const vector<mat4>& models) const;
+
+    // objects of a batch that can be drawn indirectly describe their draw and its model matrix,
+    // the first object of the batch then submits every command in one call
+    virtual bool getIndirectDraw(const CachedTransform& worldTransform, DrawElementsIndirectCommand& command, mat4& model) const;
+
+    virtual void submitIndirect(
+        RenderQueue& renderQueue,
+        const mat4& ProjectionViewMatrix,
+        const vector<DrawElementsIndirectCommand>& commands,
+        const vector<mat4>& models
+    ) const;
+
+    // draws objectCount packets of an instancing batch whose model matrices are already in the world matrix buffer,
+    // starting at firstObjectIndex
+    virtual void submitObjects(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const GLuint& firstObjectIndex, const GLsizei& objectCount) const;
+
+    // matrix placed in the world matrix buffer for this object
+    virtual mat4 getModelMatrix(const CachedTransform& worldTransform) const noexcept;
+
+    // the same transform for dual quaternion layouts of the world matrix buffer
+    virtual void getModelDualQuaternion(const CachedTransform& worldTransform, fdualquat& translationAndRotation, vec3& scale) const noexcept;
+
+    virtual bool getBoundingSphere(BoundingSphere& boundingSphere) const noexcept;
+
+    bool getSubtreeBounds(BoundingSphere& boundingSphere) const noexcept;
+
+    size_t getSubtreeBoundedCount(void) const noexcept;
+
     virtual void translate(const float& tX, const float& tY, const float& tZ) noexcept;
 
     virtual void rotate(const float& degreesX, const float& degreesY, const float& degreesZ) noexcept;
 
     virtual void orbit(const float& degreesX, const float& degreesY, const float& degreesZ) noexcept;
 
+    void propagateTransform(void) const noexcept;
+
+    // hands the dirty subtrees below the frontier to the workers of jobSystem
+    void propagateTransform(const size_t& threadCount, JobSystem& jobSystem) const;
+
+    // the serial part of propagating on several threads: resolves the top of the dirty region on this thread
+    // until frontier holds at least width subtrees needing work, or none is left. their parents are clean by then
+    void gatherFrontier(const size_t& width, vector<const SceneObject*>& frontier) const;
+
     const Transform& getTransform(void) const noexcept;
 
+    // the world transform together with its matrix, built once per change instead of on every read
+    const CachedTransform& getWorldTransform(void) const noexcept;
+
     void setTransform(const Transform& transform) noexcept;
 
+    const Transform& getLocalTransform(void) const noexcept;
+
+    void setLocalTransform(const Transform& localTransform) noexcept;
+
+    SceneObject* getParent(void) const noexcept;
+
     const string& getName(void) const noexcept;
 
     void setName(const string& name) noexcept;
@@ -0,0 +1,137 @@
+#ifndef SCENE_SNAPSHOT_HPP
+#define SCENE_SNAPSHOT_HPP
+
+// cpp
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include <SceneObject.hpp>
+#include <Frustum.hpp>
+
+class BoundingVolumeHierarchy;
+
+// Render relevant state of every object of a scene as it was when a frame was published.
+// Entries are indexed by slot, free slots have no scene object. The snapshot keeps its objects alive,
+// so the render thread may still draw objects the simulation already removed.
+class SceneSnapshot {
+public:
+    class Entry {
+    public:
+        shared_ptr<const SceneObject> sceneObject = nullptr;
+        CachedTransform worldTransform;
+        // world space, objects without bounds get an infinite sphere and are always drawn
+        BoundingSphere worldBounds;
+    };
+
+    static const size_t NULL_NODE = ~size_t(0);
+
+private:
+    // copy of the bounding volume hierarchy as it was when publishing, leaves refer to entry slots
+    class CullNode {
+    public:
+        BoundingBox boundingBox;
+        size_t left = NULL_NODE;
+        size_t right = NULL_NODE;
+        size_t slot = NULL_NODE;
+    };
+
+    vector<Entry> entries;
+    size_t frame = 0;
+    vector<CullNode> cullNodes;
+    size_t cullRoot = NULL_NODE;
+    bool indexed = false;
+    size_t boundedCount = 0;
+    vector<size_t> unboundedSlots;
+
+    friend class SceneSnapshotBuffer;
+
+public:
+    const vector<Entry>& getEntries(void) const noexcept;
+
+    // slots of the bounded entries whose hierarchy leaves the frustum touches,
+    // false when the snapshot was published without a bounding volume hierarchy
+    bool query(const Frustum& frustum, vector<size_t>& slots) const;
+
+    // entries without bounds, which query leaves out
+    const vector<size_t>& getUnboundedSlots(void) const noexcept;
+
+    // entries in the hierarchy copy
+    const size_t& getBoundedCount(void) const noexcept;
+
+    // publish count of the frame this snapshot shows
+    const size_t& getFrame(void) const noexcept;
+};
+
+// Two snapshots, one read by the render thread while the simulation brings the other up to date.
+// Objects report changes themselves as their world transforms are rebuilt, so publishing only copies the objects
+// changed since the back snapshot was last written, the changes of this frame and of the frame before it.
+// Descendants of an edited object are rebuilt by propagation, which therefore has to run before publishing.
+class SceneSnapshotBuffer {
+private:
+    SceneSnapshot snapshots[2];
+    SceneSnapshot* front = &snapshots[0];
+    SceneSnapshot* back = &snapshots[1];
+
+    // live side, owned by the simulation thread
+    vector<SceneObject*> sceneObjects;
+    vector<shared_ptr<const SceneObject>> owners;
+    vector<size_t> freeSlots;
+    // one entry per slot, filled up to the count. objects rebuilt on propagation threads add to it concurrently
+    vector<size_t> changedSlots;
+    atomic<size_t> changedCount;
+    vector<size_t> previousChangedSlots;
+    size_t previousChangedCount = 0;
+    // publish count at which a slot was last put in changedSlots
+    vector<size_t> changedFrames;
+    size_t frame = 1;
+    size_t copiedCount = 0;
+    // hierarchy nodes changed in the frame before, which the back snapshot has not seen yet
+    vector<size_t> previousChangedNodes;
+
+    mutex swapMutex;
+    condition_variable released;
+    bool reading = false;
+
+    void writeEntry(const size_t& slot);
+
+    void writeCullNode(const BoundingVolumeHierarchy& boundingVolumeHierarchy, const size_t& node);
+
+    void writeCullNodes(BoundingVolumeHierarchy* boundingVolumeHierarchy);
+
+public:
+    SceneSnapshotBuffer(void);
+
+    SceneSnapshotBuffer(const SceneSnapshotBuffer& sceneSnapshotBuffer) = delete;
+
+    ~SceneSnapshotBuffer(void);
+
+    SceneSnapshotBuffer& operator=(const SceneSnapshotBuffer& other) = delete;
+
+    void insert(const shared_ptr<SceneObject>& sceneObject);
+
+    void erase(SceneObject* sceneObject) noexcept;
+
+    void markChanged(const size_t& slot) noexcept;
+
+    // on the simulation thread, once its frame is complete. waits while the render thread holds the front.
+    // a bounding volume hierarchy tracking its changes is copied along, so the render thread culls without visiting every entry
+    void publish(BoundingVolumeHierarchy* boundingVolumeHierarchy = nullptr);
+
+    // on the render thread, the snapshot stays unchanged until release
+    const SceneSnapshot& acquire(void);
+
+    void release(void);
+
+    size_t size(void) const noexcept;
+
+    // references to sceneObject held through its current slot, by the live side and by both snapshots
+    size_t getReferenceCount(const SceneObject* sceneObject) const noexcept;
+
+    // entries copied by the last publish
+    const size_t& getCopiedCount(void) const noexcept;
+};
+
+ostream& operator<< (ostream& out, const SceneSnapshotBuffer& sceneSnapshotBuffer);
+
+#endif // !SCENE_SNAPSHOT_HPP
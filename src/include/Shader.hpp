@@ -4,25 +4,54 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <memory>
 
 #include <Vertex.hpp>
+#include <ProgramCache.hpp>
 
 using namespace std;
 
 class Shader {
 private:
-    GLuint id;
+    // active uniform resolved once after linking, value holds what was last sent
+    class Uniform {
+    public:
+        GLint location = -1;
+        bool uploaded = false;
+        GLfloat value[16];
+    };
+
+    // the linked program with what is known about its uniforms. copies of a shader share it, so the shadow
+    // values match the program whichever copy sent them, and the last copy queues the program for deletion
+    class Program {
+    public:
+        GLuint id = 0;
+        vector<Uniform> uniforms;
+        unordered_map<string, GLint> uniformHandles;
+
+        ~Program(void);
+    };
+
+    shared_ptr<Program> program;
 
     void checkCompileErrors(const GLuint& shader, const string& type) const;
 
+    void compile(const string& vertexCode, const string& fragmentCode);
+
+    void cacheUniformLocations(void);
+
+    bool updateShadow(const GLint& handle, const GLfloat* value, const size_t& count) const noexcept;
+
 public:
-    Shader(const string& vertexPath, const string& fragmentPath);
+    // with a program cache, a binary stored by an earlier launch replaces compiling and linking
+    Shader(const string& vertexPath, const string& fragmentPath, const shared_ptr<ProgramCache>& programCache = nullptr);
 
-    Shader(const Shader& shader);
-    
-    Shader(Shader&& shader);
-    
-    ~Shader(void);
+    // the copy refers to the same program
+    Shader(const Shader& shader) = default;
+
+    Shader(Shader&& shader) = default;
 
     void use(void) const;
     
@@ -30,9 +59,16 @@ public:
     
     const GLuint getUniformBlockIdx(const std::string& uniformBlockName) const;
 
+    // handles stay valid for the lifetime of the program, -1 for unknown names
+    GLint getUniformHandle(const std::string& name) const noexcept;
+
     void setVec4(const std::string& name, const GLfloat* vec) const;
 
+    void setVec4(const GLint& handle, const GLfloat* vec) const;
+
     void setMat4(const std::string& name, const GLfloat* mat) const;
+
+    void setMat4(const GLint& handle, const GLfloat* mat) const;
 };
 
 ostream& operator<< (ostream& out, const Shader& shader);
@@ -55,10 +55,42 @@ public:
     const vec3& getScale(void) const noexcept;
 };
 
+// Cached-matrix mode for transforms that are read far more often than they are assigned, such as
+// world transforms, which every draw reads. The matrix and its inverse are built once per assignment,
+// while a plain Transform stays a compact value that builds both on every call.
+class CachedTransform {
+private:
+    Transform transform;
+    mat4 matrix = mat4(1.f);
+    mat4 inverseMatrix = mat4(1.f);
+
+public:
+    CachedTransform(const Transform& transform = Transform());
+
+    CachedTransform& operator=(const Transform& transform) noexcept;
+
+    const Transform& getTransform(void) const noexcept;
+
+    const mat4& getMatrix(void) const noexcept;
+
+    const mat4& getInverseMatrix(void) const noexcept;
+
+    operator const Transform&(void) const noexcept;
+};
+
 ostream& operator<< (ostream& out, const Transform& transform) noexcept;
 
+ostream& operator<< (ostream& out, const CachedTransform& cachedTransform) noexcept;
+
 ostream& operator<< (ostream& out, const mat4& mat) noexcept;
 
 Transform inverse(const Transform& transform) noexcept;
 
+// upload layouts read back by WorldMatrixBuffer::getShaderSource, quaternions as xyzw.
+// real part, dual part and scale in the xyz of a third vec4
+void packDualQuaternionScale(const fdualquat& translationAndRotation, const vec3& scale, vec4* packed) noexcept;
+
+// real and dual part only, both multiplied so that the squared norm of the real part is the uniform scale
+void packScaledDualQuaternion(const fdualquat& translationAndRotation, const float& scale, vec4* packed) noexcept;
+
 #endif // !TRANSFORM_HPP
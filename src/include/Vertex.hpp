@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 #include <glad\glad.h>
 #include <glm\glm.hpp>
@@ -33,6 +34,10 @@ public:
     vec2 texCoord;
 };
 
+// welds bitwise identical vertices in place and fills one index per original vertex,
+// the order of first occurrence is kept so the result stays cache friendly
+void weldVertices(vector<Vertex>& vertices, vector<GLuint>& indices);
+
 ostream& operator<< (ostream& out, const vec2& vector);
 
 ostream& operator<< (ostream& out, const vec3& vector);
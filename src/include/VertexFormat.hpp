@@ -0,0 +1,107 @@
+#ifndef VERTEX_FORMAT_HPP
+#define VERTEX_FORMAT_HPP
+
+#include <vector>
+
+#include <Vertex.hpp>
+#include <BoundingSphere.hpp>
+
+// One attribute of an interleaved vertex buffer, as handed to glVertexAttribPointer.
+class VertexAttribute {
+public:
+    GLuint location = 0;
+    GLint size = 0;
+    GLenum type = GL_FLOAT;
+    GLboolean normalized = GL_FALSE;
+    size_t offset = 0;
+};
+
+// Encoding of each Vertex member in the vertex buffer, together with the attribute layout it produces.
+// Quantized positions are stored relative to the bounding sphere of the geometry, the matrix from
+// getPositionDecode maps them back and is folded into the model matrix, so shaders see no change.
+// Octahedral normals reach the shader as a vec2 in [-1, 1] at location 1 and are decoded there:
+//     vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+//     if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+//     n = normalize(n);
+class VertexFormat {
+public:
+    // first of the four vec4 locations taking the per instance model matrix
+    static const GLuint INSTANCE_MODEL_LOCATION = 4;
+
+    enum PositionEncoding : unsigned char {
+        POSITION_FLOAT,
+        POSITION_HALF,
+        POSITION_SNORM16
+    };
+
+    enum NormalEncoding : unsigned char {
+        NORMAL_FLOAT,
+        NORMAL_OCTAHEDRAL_SNORM16
+    };
+
+    enum ColorEncoding : unsigned char {
+        COLOR_FLOAT,
+        COLOR_RGBA8
+    };
+
+    // unorm16 covers [0, 1] only, half floats also take repeating coordinates
+    enum TexCoordEncoding : unsigned char {
+        TEXCOORD_FLOAT,
+        TEXCOORD_HALF,
+        TEXCOORD_UNORM16
+    };
+
+private:
+    PositionEncoding positionEncoding = POSITION_FLOAT;
+    NormalEncoding normalEncoding = NORMAL_FLOAT;
+    ColorEncoding colorEncoding = COLOR_FLOAT;
+    TexCoordEncoding texCoordEncoding = TEXCOORD_FLOAT;
+    vector<VertexAttribute> attributes;
+    size_t stride = 0;
+
+    void buildLayout(void);
+
+public:
+    VertexFormat(
+        const PositionEncoding& positionEncoding = POSITION_FLOAT,
+        const NormalEncoding& normalEncoding = NORMAL_FLOAT,
+        const ColorEncoding& colorEncoding = COLOR_FLOAT,
+        const TexCoordEncoding& texCoordEncoding = TEXCOORD_FLOAT
+    );
+
+    // 20 bytes per vertex: snorm16 positions, octahedral normals, RGBA8 color and unorm16 coordinates
+    static VertexFormat compact(void);
+
+    // writes getStride() bytes per vertex into buffer
+    void encode(const vector<Vertex>& vertices, const BoundingSphere& bounds, vector<unsigned char>& buffer) const;
+
+    // enables and points every attribute of the layout, expects the vertex array and buffer to be bound
+    void apply(void) const noexcept;
+
+    // points the instance model matrix at the bound array buffer, one mat4 per instance
+    static void applyInstanceModel(void) noexcept;
+
+    bool isFloat(void) const noexcept;
+
+    mat4 getPositionDecode(const BoundingSphere& bounds) const noexcept;
+
+    const vector<VertexAttribute>& getAttributes(void) const noexcept;
+
+    const size_t& getStride(void) const noexcept;
+
+    const PositionEncoding& getPositionEncoding(void) const noexcept;
+
+    const NormalEncoding& getNormalEncoding(void) const noexcept;
+
+    const ColorEncoding& getColorEncoding(void) const noexcept;
+
+    const TexCoordEncoding& getTexCoordEncoding(void) const noexcept;
+
+    static vec2 encodeOctahedral(const vec3& normal) noexcept;
+
+    static vec3 decodeOctahedral(const vec2& encoded) noexcept;
+};
+
+ostream& operator<< (ostream& out, const VertexFormat& vertexFormat);
+
+#endif // !VERTEX_FORMAT_HPP
@@ -0,0 +1,71 @@
+#ifndef WORLD_MATRIX_BUFFER_HPP
+#define WORLD_MATRIX_BUFFER_HPP
+
+#include <RenderQueue.hpp>
+
+// Model transforms of every visible object of a frame in one persistently mapped shader storage buffer.
+// The buffer is split into regions used round robin, each guarded by a fence, so a frame never writes
+// transforms the GPU may still read. Shaders paste getShaderSource of the layout in use and call
+//     getWorldMatrix(gl_BaseInstance + gl_InstanceID)
+// with draws passing the packet index in the sorted render queue as base instance, so every batch reads
+// a contiguous range.
+class WorldMatrixBuffer {
+public:
+    static const GLuint BINDING = 0;
+    static const size_t REGION_COUNT = 3;
+
+    // MATRIX uploads 64 bytes per object, DUAL_QUATERNION_SCALE 48 and DUAL_QUATERNION_UNIFORM_SCALE 32,
+    // the last one taking the x scale of every object as its uniform scale
+    enum Layout {
+        MATRIX,
+        DUAL_QUATERNION_SCALE,
+        DUAL_QUATERNION_UNIFORM_SCALE
+    };
+
+private:
+    Layout layout;
+    GLuint buffer = 0;
+    unsigned char* mapped = nullptr;
+    // objects per region
+    size_t capacity = 0;
+    size_t region = 0;
+    size_t count = 0;
+    GLsync fences[REGION_COUNT] = {};
+
+    void allocate(const size_t& capacity);
+
+    void deallocate(void) noexcept;
+
+    void waitForRegion(const size_t& region) noexcept;
+
+public:
+    WorldMatrixBuffer(const size_t& capacity = 1024, const Layout& layout = MATRIX);
+
+    WorldMatrixBuffer(const WorldMatrixBuffer& worldMatrixBuffer) = delete;
+
+    ~WorldMatrixBuffer(void);
+
+    WorldMatrixBuffer& operator=(const WorldMatrixBuffer& other) = delete;
+
+    // writes the transform of every packet of a sorted queue into the next region and binds that region
+    void write(const RenderQueue& renderQueue);
+
+    // marks the end of the draws reading the region written last
+    void fence(void);
+
+    const Layout& getLayout(void) const noexcept;
+
+    const size_t& getCapacity(void) const noexcept;
+
+    const size_t& size(void) const noexcept;
+
+    // bytes per object
+    static size_t getStride(const Layout& layout) noexcept;
+
+    // GLSL declaring the storage block of a layout and mat4 getWorldMatrix(uint index) reading it
+    static string getShaderSource(const Layout& layout);
+};
+
+ostream& operator<< (ostream& out, const WorldMatrixBuffer& worldMatrixBuffer);
+
+#endif // !WORLD_MATRIX_BUFFER_HPP
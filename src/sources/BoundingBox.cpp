@@ -0,0 +1,80 @@
+#include <BoundingBox.hpp>
+#include <Vertex.hpp>
+
+BoundingBox::BoundingBox(const vec3& minimum, const vec3& maximum):
+    minimum(minimum),
+    maximum(maximum) {
+}
+
+BoundingBox::BoundingBox(const BoundingSphere& boundingSphere):
+    minimum(boundingSphere.getCenter() - vec3(boundingSphere.getRadius())),
+    maximum(boundingSphere.getCenter() + vec3(boundingSphere.getRadius())) {
+}
+
+BoundingBox::BoundingBox(const BoundingBox& boundingBox):
+    minimum(boundingBox.minimum),
+    maximum(boundingBox.maximum) {
+}
+
+BoundingBox& BoundingBox::operator=(const BoundingBox& other) noexcept {
+    minimum = other.minimum;
+    maximum = other.maximum;
+    return *this;
+}
+
+BoundingBox BoundingBox::merge(const BoundingBox& other) const noexcept {
+    return BoundingBox(glm::min(minimum, other.minimum), glm::max(maximum, other.maximum));
+}
+
+BoundingBox BoundingBox::expand(const float& margin) const noexcept {
+    return BoundingBox(minimum - vec3(margin), maximum + vec3(margin));
+}
+
+bool BoundingBox::contains(const BoundingBox& other) const noexcept {
+    return all(lessThanEqual(minimum, other.minimum)) && all(greaterThanEqual(maximum, other.maximum));
+}
+
+bool BoundingBox::intersects(const BoundingBox& other) const noexcept {
+    return all(lessThanEqual(minimum, other.maximum)) && all(greaterThanEqual(maximum, other.minimum));
+}
+
+bool BoundingBox::intersects(const vec3& origin, const vec3& inverseDirection, const float& maxDistance, float& distance) const noexcept {
+    const vec3 slabNear = (minimum - origin) * inverseDirection;
+    const vec3 slabFar = (maximum - origin) * inverseDirection;
+    const vec3 entry = glm::min(slabNear, slabFar);
+    const vec3 exit = glm::max(slabNear, slabFar);
+
+    const float entryDistance = glm::max(glm::max(entry.x, entry.y), glm::max(entry.z, 0.f));
+    const float exitDistance = glm::min(glm::min(exit.x, exit.y), glm::min(exit.z, maxDistance));
+
+    if (entryDistance > exitDistance) {
+        return false;
+    }
+
+    distance = entryDistance;
+    return true;
+}
+
+float BoundingBox::getSurfaceArea(void) const noexcept {
+    const vec3 extent = maximum - minimum;
+    return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+vec3 BoundingBox::getCenter(void) const noexcept {
+    return (minimum + maximum) * 0.5f;
+}
+
+const vec3& BoundingBox::getMinimum(void) const noexcept {
+    return minimum;
+}
+
+const vec3& BoundingBox::getMaximum(void) const noexcept {
+    return maximum;
+}
+
+ostream& operator<< (ostream& out, const BoundingBox& boundingBox) {
+    out << "Bounding Box minimum: " << boundingBox.getMinimum() << endl;
+    out << "Bounding Box maximum: " << boundingBox.getMaximum() << endl;
+
+    return out;
+}
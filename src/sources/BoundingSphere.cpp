@@ -0,0 +1,90 @@
+#include <BoundingSphere.hpp>
+#include <Vertex.hpp>
+
+BoundingSphere::BoundingSphere(const vec3& center, const float& radius):
+    center(center),
+    radius(radius) {
+}
+
+BoundingSphere::BoundingSphere(const vector<Vertex>& vertices) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    // centered on the axis aligned box, which is cheap and tight enough for culling
+    vec3 minimum = vertices[0].position;
+    vec3 maximum = vertices[0].position;
+
+    for (auto& vertex : vertices) {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+
+    center = (minimum + maximum) * 0.5f;
+
+    float radiusSquared = 0.f;
+    for (auto& vertex : vertices) {
+        radiusSquared = glm::max(radiusSquared, length2(vertex.position - center));
+    }
+
+    radius = glm::sqrt(radiusSquared);
+}
+
+BoundingSphere::BoundingSphere(const BoundingSphere& boundingSphere):
+    center(boundingSphere.center),
+    radius(boundingSphere.radius) {
+}
+
+BoundingSphere& BoundingSphere::operator=(const BoundingSphere& other) noexcept {
+    center = other.center;
+    radius = other.radius;
+    return *this;
+}
+
+BoundingSphere BoundingSphere::transform(const Transform& transform) const noexcept {
+    return this->transform(transform.getMatrix(), transform.getScale());
+}
+
+BoundingSphere BoundingSphere::transform(const CachedTransform& transform) const noexcept {
+    return this->transform(transform.getMatrix(), transform.getTransform().getScale());
+}
+
+BoundingSphere BoundingSphere::transform(const mat4& matrix, const vec3& scale) const noexcept {
+    const vec3 absoluteScale = glm::abs(scale);
+
+    return BoundingSphere(
+        vec3(matrix * vec4(center, 1.f)),
+        radius * glm::max(absoluteScale.x, glm::max(absoluteScale.y, absoluteScale.z))
+    );
+}
+
+BoundingSphere BoundingSphere::merge(const BoundingSphere& other) const noexcept {
+    const vec3 offset = other.center - center;
+    const float distance = length(offset);
+
+    if (distance + other.radius <= radius) {
+        return *this;
+    }
+
+    if (distance + radius <= other.radius) {
+        return other;
+    }
+
+    const float mergedRadius = (distance + radius + other.radius) * 0.5f;
+    return BoundingSphere(center + offset * ((mergedRadius - radius) / distance), mergedRadius);
+}
+
+const vec3& BoundingSphere::getCenter(void) const noexcept {
+    return center;
+}
+
+const float& BoundingSphere::getRadius(void) const noexcept {
+    return radius;
+}
+
+ostream& operator<< (ostream& out, const BoundingSphere& boundingSphere) {
+    out << "Bounding Sphere center: " << boundingSphere.getCenter() << endl;
+    out << "Bounding Sphere radius: " << boundingSphere.getRadius() << endl;
+
+    return out;
+}
@@ -0,0 +1,798 @@
+#include <BoundingVolumeHierarchy.hpp>
+
+// cpp
+#include <algorithm>
+#include <cfloat>
+
+const size_t BoundingVolumeHierarchy::NULL_NODE;
+const size_t BoundingVolumeHierarchy::BIN_COUNT;
+
+// spreads the low 21 bits of value three apart
+static uint64_t spreadBits(uint64_t value) noexcept {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffff;
+    value = (value | value << 16) & 0x1f0000ff0000ff;
+    value = (value | value << 8) & 0x100f00f00f00f00f;
+    value = (value | value << 4) & 0x10c30c30c30c30c3;
+    value = (value | value << 2) & 0x1249249249249249;
+    return value;
+}
+
+// position along a z order curve through the box from minimum to maximum, close codes are close in space
+static uint64_t getMortonCode(const vec3& position, const vec3& minimum, const vec3& maximum) noexcept {
+    const vec3 extent = glm::max(maximum - minimum, vec3(FLT_MIN));
+    const vec3 cell = glm::clamp((position - minimum) / extent, 0.f, 1.f) * 2097151.f;
+    return spreadBits((uint64_t)cell.x) | spreadBits((uint64_t)cell.y) << 1 | spreadBits((uint64_t)cell.z) << 2;
+}
+
+bool BoundingVolumeHierarchy::Node::isLeaf(void) const noexcept {
+    return left == NULL_NODE;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const float& margin, const float& rebuildDegradation):
+    movedCount(0),
+    margin(margin),
+    rebuildDegradation(rebuildDegradation) {
+}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy(void) {
+    for (auto& node : nodes) {
+        if (node.height == 0 && node.sceneObject != nullptr) {
+            node.sceneObject->boundingVolumeHierarchy = nullptr;
+            node.sceneObject->boundingVolumeLeaf = NULL_NODE;
+            node.sceneObject->observersChanged();
+        }
+    }
+}
+
+size_t BoundingVolumeHierarchy::allocateNode(void) {
+    if (freeList == NULL_NODE) {
+        nodes.push_back(Node());
+        worldBounds.resize(nodes.size());
+        movedLeaves.resize(nodes.size());
+        changedNodes.resize(nodes.size());
+        return nodes.size() - 1;
+    }
+
+    // free nodes are chained through their parent index. a node still listed as changed stays listed
+    const size_t node = freeList;
+    const bool logged = nodes[node].logged;
+    freeList = nodes[node].parent;
+    nodes[node] = Node();
+    nodes[node].logged = logged;
+
+    return node;
+}
+
+void BoundingVolumeHierarchy::logChange(const size_t& node) noexcept {
+    if (tracking && !nodes[node].logged) {
+        nodes[node].logged = true;
+        changedNodes[changedCount++] = node;
+    }
+}
+
+void BoundingVolumeHierarchy::freeNode(const size_t& node) noexcept {
+    nodes[node].parent = freeList;
+    nodes[node].left = NULL_NODE;
+    nodes[node].right = NULL_NODE;
+    nodes[node].sceneObject = nullptr;
+    nodes[node].height = -1;
+    nodes[node].moved = false;
+    freeList = node;
+}
+
+void BoundingVolumeHierarchy::insertLeaf(const size_t& leaf) {
+    logChange(leaf);
+
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // descend towards the sibling that adds the least surface area
+    const BoundingBox leafBoundingBox = nodes[leaf].boundingBox;
+    size_t index = root;
+
+    while (!nodes[index].isLeaf()) {
+        const float area = nodes[index].boundingBox.getSurfaceArea();
+        const float combinedArea = nodes[index].boundingBox.merge(leafBoundingBox).getSurfaceArea();
+        const float cost = 2.f * combinedArea;
+        const float inheritanceCost = 2.f * (combinedArea - area);
+
+        auto descentCost = [&](const size_t& child) {
+            const float mergedArea = leafBoundingBox.merge(nodes[child].boundingBox).getSurfaceArea();
+            return nodes[child].isLeaf() ?
+                mergedArea + inheritanceCost :
+                mergedArea - nodes[child].boundingBox.getSurfaceArea() + inheritanceCost;
+        };
+
+        const float leftCost = descentCost(nodes[index].left);
+        const float rightCost = descentCost(nodes[index].right);
+
+        if (cost < leftCost && cost < rightCost) {
+            break;
+        }
+
+        index = leftCost < rightCost ? nodes[index].left : nodes[index].right;
+    }
+
+    const size_t sibling = index;
+    const size_t oldParent = nodes[sibling].parent;
+    const size_t newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].boundingBox = leafBoundingBox.merge(nodes[sibling].boundingBox);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    } else if (nodes[oldParent].left == sibling) {
+        nodes[oldParent].left = newParent;
+    } else {
+        nodes[oldParent].right = newParent;
+    }
+
+    // refit and rebalance the path back to the root
+    for (index = nodes[leaf].parent; index != NULL_NODE; index = nodes[index].parent) {
+        index = balance(index);
+        logChange(index);
+
+        const Node& left = nodes[nodes[index].left];
+        const Node& right = nodes[nodes[index].right];
+        nodes[index].height = 1 + std::max(left.height, right.height);
+        nodes[index].boundingBox = left.boundingBox.merge(right.boundingBox);
+    }
+}
+
+void BoundingVolumeHierarchy::removeLeaf(const size_t& leaf) noexcept {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    const size_t parent = nodes[leaf].parent;
+    const size_t grandParent = nodes[parent].parent;
+    const size_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    freeNode(parent);
+    nodes[sibling].parent = grandParent;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        return;
+    }
+
+    if (nodes[grandParent].left == parent) {
+        nodes[grandParent].left = sibling;
+    } else {
+        nodes[grandParent].right = sibling;
+    }
+
+    for (size_t index = grandParent; index != NULL_NODE; index = nodes[index].parent) {
+        index = balance(index);
+        logChange(index);
+
+        const Node& left = nodes[nodes[index].left];
+        const Node& right = nodes[nodes[index].right];
+        nodes[index].height = 1 + std::max(left.height, right.height);
+        nodes[index].boundingBox = left.boundingBox.merge(right.boundingBox);
+    }
+}
+
+size_t BoundingVolumeHierarchy::balance(const size_t& indexA) noexcept {
+    // rotates the taller grandchild subtree up when the children heights differ by more than one
+    Node& a = nodes[indexA];
+
+    if (a.isLeaf() || a.height < 2) {
+        return indexA;
+    }
+
+    const size_t indexB = a.left;
+    const size_t indexC = a.right;
+    Node& b = nodes[indexB];
+    Node& c = nodes[indexC];
+    const int heightDifference = c.height - b.height;
+
+    if (heightDifference > 1) {
+        logChange(indexA);
+
+        const size_t indexF = c.left;
+        const size_t indexG = c.right;
+        Node& f = nodes[indexF];
+        Node& g = nodes[indexG];
+
+        c.left = indexA;
+        c.parent = a.parent;
+        a.parent = indexC;
+
+        if (c.parent == NULL_NODE) {
+            root = indexC;
+        } else if (nodes[c.parent].left == indexA) {
+            nodes[c.parent].left = indexC;
+        } else {
+            nodes[c.parent].right = indexC;
+        }
+
+        if (f.height > g.height) {
+            c.right = indexF;
+            a.right = indexG;
+            g.parent = indexA;
+            a.boundingBox = b.boundingBox.merge(g.boundingBox);
+            c.boundingBox = a.boundingBox.merge(f.boundingBox);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        } else {
+            c.right = indexG;
+            a.right = indexF;
+            f.parent = indexA;
+            a.boundingBox = b.boundingBox.merge(f.boundingBox);
+            c.boundingBox = a.boundingBox.merge(g.boundingBox);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+
+        return indexC;
+    }
+
+    if (heightDifference < -1) {
+        logChange(indexA);
+
+        const size_t indexD = b.left;
+        const size_t indexE = b.right;
+        Node& d = nodes[indexD];
+        Node& e = nodes[indexE];
+
+        b.left = indexA;
+        b.parent = a.parent;
+        a.parent = indexB;
+
+        if (b.parent == NULL_NODE) {
+            root = indexB;
+        } else if (nodes[b.parent].left == indexA) {
+            nodes[b.parent].left = indexB;
+        } else {
+            nodes[b.parent].right = indexB;
+        }
+
+        if (d.height > e.height) {
+            b.right = indexD;
+            a.left = indexE;
+            e.parent = indexA;
+            a.boundingBox = c.boundingBox.merge(e.boundingBox);
+            b.boundingBox = a.boundingBox.merge(d.boundingBox);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        } else {
+            b.right = indexE;
+            a.left = indexD;
+            d.parent = indexA;
+            a.boundingBox = c.boundingBox.merge(d.boundingBox);
+            b.boundingBox = a.boundingBox.merge(e.boundingBox);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+
+        return indexB;
+    }
+
+    return indexA;
+}
+
+size_t BoundingVolumeHierarchy::buildTopDown(vector<BuildLeaf>& leaves, const size_t& begin, const size_t& end) {
+    if (end - begin == 1) {
+        return leaves[begin].leaf;
+    }
+
+    const size_t node = allocateNode();
+    vec3 centerMinimum(FLT_MAX);
+    vec3 centerMaximum(-FLT_MAX);
+
+    // centers are kept doubled, which orders them the same without halving every one
+    for (size_t i = begin; i < end; i++) {
+        const vec3 center = leaves[i].minimum + leaves[i].maximum;
+        centerMinimum = glm::min(centerMinimum, center);
+        centerMaximum = glm::max(centerMaximum, center);
+    }
+
+    // leaves are binned by center along the axis their centers spread the most
+    const vec3 extent = centerMaximum - centerMinimum;
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    const float minimumCenter = centerMinimum[axis];
+    const float scale = extent[axis] > 0.f ? (float)BIN_COUNT / extent[axis] : 0.f;
+
+    auto getBin = [&minimumCenter, &scale, &axis](const BuildLeaf& leaf) {
+        return std::min((size_t)((leaf.minimum[axis] + leaf.maximum[axis] - minimumCenter) * scale), BIN_COUNT - 1);
+    };
+
+    auto getArea = [](const vec3& minimum, const vec3& maximum) {
+        const vec3 extent = maximum - minimum;
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    };
+
+    // coinciding centers give no useful split, they are halved instead
+    size_t middle = begin + (end - begin) / 2;
+
+    if (scale > 0.f) {
+        vec3 binMinimum[BIN_COUNT];
+        vec3 binMaximum[BIN_COUNT];
+        size_t binCounts[BIN_COUNT] = {};
+
+        for (size_t bin = 0; bin < BIN_COUNT; bin++) {
+            binMinimum[bin] = vec3(FLT_MAX);
+            binMaximum[bin] = vec3(-FLT_MAX);
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            const size_t bin = getBin(leaves[i]);
+            binMinimum[bin] = glm::min(binMinimum[bin], leaves[i].minimum);
+            binMaximum[bin] = glm::max(binMaximum[bin], leaves[i].maximum);
+            binCounts[bin]++;
+        }
+
+        // the split with the least area weighted leaf count wins, areas right of every split are summed up from the last bin
+        float rightCosts[BIN_COUNT];
+        vec3 rightMinimum(FLT_MAX);
+        vec3 rightMaximum(-FLT_MAX);
+        size_t rightCount = 0;
+
+        for (size_t bin = BIN_COUNT - 1; bin > 0; bin--) {
+            rightMinimum = glm::min(rightMinimum, binMinimum[bin]);
+            rightMaximum = glm::max(rightMaximum, binMaximum[bin]);
+            rightCount += binCounts[bin];
+            rightCosts[bin] = rightCount > 0 ? (float)rightCount * getArea(rightMinimum, rightMaximum) : 0.f;
+        }
+
+        vec3 leftMinimum(FLT_MAX);
+        vec3 leftMaximum(-FLT_MAX);
+        size_t leftCount = 0;
+        size_t bestSplit = 0;
+        float bestCost = FLT_MAX;
+
+        for (size_t split = 1; split < BIN_COUNT; split++) {
+            leftMinimum = glm::min(leftMinimum, binMinimum[split - 1]);
+            leftMaximum = glm::max(leftMaximum, binMaximum[split - 1]);
+            leftCount += binCounts[split - 1];
+
+            const float cost = (float)leftCount * getArea(leftMinimum, leftMaximum) + rightCosts[split];
+
+            if (leftCount > 0 && leftCount < end - begin && cost < bestCost) {
+                bestSplit = split;
+                bestCost = cost;
+            }
+        }
+
+        middle = (size_t)(partition(leaves.begin() + begin, leaves.begin() + end, [&](const BuildLeaf& leaf) {
+            return getBin(leaf) < bestSplit;
+        }) - leaves.begin());
+    }
+
+    const size_t left = buildTopDown(leaves, begin, middle);
+    const size_t right = buildTopDown(leaves, middle, end);
+
+    nodes[node].left = left;
+    nodes[node].right = right;
+    nodes[node].height = 1 + std::max(nodes[left].height, nodes[right].height);
+    nodes[node].boundingBox = nodes[left].boundingBox.merge(nodes[right].boundingBox);
+    nodes[left].parent = node;
+    nodes[right].parent = node;
+    logChange(node);
+
+    return node;
+}
+
+BoundingBox BoundingVolumeHierarchy::getFatBoundingBox(const BoundingSphere& boundingSphere) const noexcept {
+    return BoundingBox(boundingSphere).expand(boundingSphere.getRadius() * margin);
+}
+
+size_t BoundingVolumeHierarchy::createLeaf(SceneObject* sceneObject) {
+    if (sceneObject->boundingVolumeHierarchy != nullptr) {
+        sceneObject->boundingVolumeHierarchy->erase(sceneObject);
+    }
+
+    const size_t leaf = allocateNode();
+    nodes[leaf].sceneObject = sceneObject;
+    sceneObject->boundingVolumeHierarchy = this;
+    sceneObject->boundingVolumeLeaf = leaf;
+    sceneObject->observersChanged();
+
+    return leaf;
+}
+
+void BoundingVolumeHierarchy::setWorldBounds(const size_t& leaf, const BoundingSphere& boundingSphere) noexcept {
+    worldBounds[leaf] = boundingSphere;
+    nodes[leaf].boundingBox = getFatBoundingBox(boundingSphere);
+    leafCount++;
+}
+
+void BoundingVolumeHierarchy::insert(SceneObject* sceneObject) {
+    const size_t leaf = createLeaf(sceneObject);
+    BoundingSphere boundingSphere;
+
+    if (sceneObject->getBoundingSphere(boundingSphere)) {
+        setWorldBounds(leaf, boundingSphere.transform(sceneObject->getWorldTransform()));
+        insertLeaf(leaf);
+    } else {
+        appendUnbounded(leaf);
+    }
+}
+
+void BoundingVolumeHierarchy::insert(const vector<SceneObject*>& sceneObjects) {
+    // a leaf and an inner node per object at most, reserved once instead of growing node by node
+    const size_t capacity = nodes.size() + 2 * sceneObjects.size();
+    nodes.reserve(capacity);
+    worldBounds.reserve(capacity);
+    movedLeaves.reserve(capacity);
+    changedNodes.reserve(capacity);
+
+    vector<BoundingSphere> boundingSpheres(sceneObjects.size());
+    vector<pair<uint64_t, size_t>> order;
+    order.reserve(sceneObjects.size());
+    vec3 minimum(FLT_MAX);
+    vec3 maximum(-FLT_MAX);
+
+    for (size_t i = 0; i < sceneObjects.size(); i++) {
+        if (sceneObjects[i]->getBoundingSphere(boundingSpheres[i])) {
+            boundingSpheres[i] = boundingSpheres[i].transform(sceneObjects[i]->getWorldTransform());
+            minimum = glm::min(minimum, boundingSpheres[i].getCenter());
+            maximum = glm::max(maximum, boundingSpheres[i].getCenter());
+            order.push_back(make_pair(0, i));
+        } else {
+            appendUnbounded(createLeaf(sceneObjects[i]));
+        }
+    }
+
+    // leaves are allocated along a z order curve, so the leaves of a subtree end up close together in memory
+    for (auto& entry : order) {
+        entry.first = getMortonCode(boundingSpheres[entry.second].getCenter(), minimum, maximum);
+    }
+
+    sort(order.begin(), order.end());
+
+    for (auto& entry : order) {
+        const size_t leaf = createLeaf(sceneObjects[entry.second]);
+        setWorldBounds(leaf, boundingSpheres[entry.second]);
+        logChange(leaf);
+    }
+
+    rebuild();
+}
+
+void BoundingVolumeHierarchy::erase(SceneObject* sceneObject) noexcept {
+    if (sceneObject->boundingVolumeHierarchy != this) {
+        return;
+    }
+
+    const size_t leaf = sceneObject->boundingVolumeLeaf;
+
+    if (nodes[leaf].bounded) {
+        removeLeaf(leaf);
+        leafCount--;
+    } else {
+        removeUnbounded(leaf);
+    }
+
+    freeNode(leaf);
+
+    sceneObject->boundingVolumeHierarchy = nullptr;
+    sceneObject->boundingVolumeLeaf = NULL_NODE;
+    sceneObject->observersChanged();
+}
+
+void BoundingVolumeHierarchy::appendUnbounded(const size_t& leaf) {
+    nodes[leaf].bounded = false;
+    nodes[leaf].parent = unboundedLeaves.size();
+    unboundedLeaves.push_back(leaf);
+}
+
+void BoundingVolumeHierarchy::removeUnbounded(const size_t& leaf) noexcept {
+    // the last leaf of the list takes the place of the removed one
+    const size_t position = nodes[leaf].parent;
+    const size_t last = unboundedLeaves.back();
+
+    unboundedLeaves[position] = last;
+    nodes[last].parent = position;
+    unboundedLeaves.pop_back();
+
+    nodes[leaf].bounded = true;
+    nodes[leaf].parent = NULL_NODE;
+}
+
+void BoundingVolumeHierarchy::markMoved(const size_t& leaf) noexcept {
+    // each leaf is only marked by the thread rebuilding its object, the list itself is shared
+    if (!nodes[leaf].moved) {
+        nodes[leaf].moved = true;
+        movedLeaves[movedCount.fetch_add(1, memory_order_relaxed)] = leaf;
+    }
+}
+
+void BoundingVolumeHierarchy::update(void) {
+    // resolving a world transform may rebuild it and list more leaves, which are handled in the same pass
+    for (size_t i = 0; i < movedCount.load(memory_order_relaxed); i++) {
+        const size_t leaf = movedLeaves[i];
+
+        // leaves erased after moving are freed and no longer flagged
+        if (!nodes[leaf].moved) {
+            continue;
+        }
+
+        // resolved while the leaf is still flagged, so a rebuild it reports does not list the leaf a second time
+        const CachedTransform& worldTransform = nodes[leaf].sceneObject->getWorldTransform();
+        nodes[leaf].moved = false;
+
+        // objects may gain or lose their bounds, such as meshes given other geometry
+        BoundingSphere boundingSphere;
+        const bool bounded = nodes[leaf].sceneObject->getBoundingSphere(boundingSphere);
+
+        if (!bounded) {
+            if (nodes[leaf].bounded) {
+                removeLeaf(leaf);
+                appendUnbounded(leaf);
+                leafCount--;
+            }
+
+            continue;
+        }
+
+        boundingSphere = boundingSphere.transform(worldTransform);
+        worldBounds[leaf] = boundingSphere;
+
+        if (!nodes[leaf].bounded) {
+            removeUnbounded(leaf);
+            nodes[leaf].boundingBox = getFatBoundingBox(boundingSphere);
+            insertLeaf(leaf);
+            leafCount++;
+        } else if (!nodes[leaf].boundingBox.contains(BoundingBox(boundingSphere))) {
+            removeLeaf(leaf);
+            nodes[leaf].boundingBox = getFatBoundingBox(boundingSphere);
+            insertLeaf(leaf);
+            reinsertCount++;
+        }
+    }
+
+    movedCount.store(0, memory_order_relaxed);
+
+    // measuring quality walks the tree, so it is only done after a share of the leaves moved
+    if (reinsertCount > 0 && reinsertCount >= leafCount / 4) {
+        reinsertCount = 0;
+
+        if (getAreaRatio() > rebuiltAreaRatio * rebuildDegradation) {
+            rebuild();
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::rebuild(void) {
+    vector<BuildLeaf> leaves;
+    leaves.reserve(leafCount);
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].height == 0 && nodes[i].sceneObject != nullptr && nodes[i].bounded) {
+            leaves.push_back({ nodes[i].boundingBox.getMinimum(), nodes[i].boundingBox.getMaximum(), i });
+        } else if (nodes[i].height > 0) {
+            freeNode(i);
+        }
+    }
+
+    root = leaves.empty() ? NULL_NODE : buildTopDown(leaves, 0, leaves.size());
+
+    if (root != NULL_NODE) {
+        nodes[root].parent = NULL_NODE;
+    }
+
+    reinsertCount = 0;
+    rebuiltAreaRatio = getAreaRatio();
+}
+
+void BoundingVolumeHierarchy::query(const BoundingBox& boundingBox, vector<const SceneObject*>& sceneObjects) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    vector<size_t> stack(1, root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!node.boundingBox.intersects(boundingBox)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            sceneObjects.push_back(node.sceneObject);
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::query(const Frustum& frustum, vector<const SceneObject*>& sceneObjects) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    vector<size_t> stack(1, root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!frustum.intersects(node.boundingBox)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            sceneObjects.push_back(node.sceneObject);
+        } else if (frustum.contains(node.boundingBox)) {
+            // every leaf below a node wholly inside is taken without further tests
+            const size_t begin = stack.size();
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+
+            while (stack.size() > begin) {
+                const Node& inside = nodes[stack.back()];
+                stack.pop_back();
+
+                if (inside.isLeaf()) {
+                    sceneObjects.push_back(inside.sceneObject);
+                } else {
+                    stack.push_back(inside.left);
+                    stack.push_back(inside.right);
+                }
+            }
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::query(const Frustum& frustum, vector<size_t>& leaves) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    vector<size_t> stack(1, root);
+    while (!stack.empty()) {
+        const size_t index = stack.back();
+        const Node& node = nodes[index];
+        stack.pop_back();
+
+        if (!frustum.intersects(node.boundingBox)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            leaves.push_back(index);
+        } else if (frustum.contains(node.boundingBox)) {
+            const size_t begin = stack.size();
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+
+            while (stack.size() > begin) {
+                const size_t inside = stack.back();
+                stack.pop_back();
+
+                if (nodes[inside].isLeaf()) {
+                    leaves.push_back(inside);
+                } else {
+                    stack.push_back(nodes[inside].left);
+                    stack.push_back(nodes[inside].right);
+                }
+            }
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::queryUnbounded(vector<const SceneObject*>& sceneObjects) const {
+    for (auto& leaf : unboundedLeaves) {
+        sceneObjects.push_back(nodes[leaf].sceneObject);
+    }
+}
+
+const SceneObject* BoundingVolumeHierarchy::raycast(const vec3& origin, const vec3& direction, const float& maxDistance, float& distance) const noexcept {
+    const vec3 unitDirection = normalize(direction);
+    const vec3 inverseDirection = 1.f / unitDirection;
+    const SceneObject* closest = nullptr;
+    float closestDistance = maxDistance;
+
+    if (root == NULL_NODE) {
+        return nullptr;
+    }
+
+    vector<size_t> stack(1, root);
+    while (!stack.empty()) {
+        const size_t index = stack.back();
+        const Node& node = nodes[index];
+        stack.pop_back();
+
+        float entryDistance;
+        if (!node.boundingBox.intersects(origin, inverseDirection, closestDistance, entryDistance)) {
+            continue;
+        }
+
+        if (!node.isLeaf()) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        // leaves are hit tested against the world space bounding sphere
+        const BoundingSphere& boundingSphere = worldBounds[index];
+
+        const vec3 offset = origin - boundingSphere.getCenter();
+        const float b = dot(offset, unitDirection);
+        const float c = dot(offset, offset) - boundingSphere.getRadius() * boundingSphere.getRadius();
+        const float discriminant = b * b - c;
+
+        if (discriminant >= 0.f) {
+            const float hitDistance = std::max(-b - glm::sqrt(discriminant), 0.f);
+
+            if (hitDistance <= closestDistance && (c <= 0.f || b <= 0.f)) {
+                closest = node.sceneObject;
+                closestDistance = hitDistance;
+            }
+        }
+    }
+
+    if (closest != nullptr) {
+        distance = closestDistance;
+    }
+
+    return closest;
+}
+
+const SceneObject* BoundingVolumeHierarchy::getSceneObject(const size_t& leaf) const noexcept {
+    return nodes[leaf].sceneObject;
+}
+
+const BoundingSphere& BoundingVolumeHierarchy::getWorldBounds(const size_t& leaf) const noexcept {
+    return worldBounds[leaf];
+}
+
+void BoundingVolumeHierarchy::setChangeTracking(const bool& tracking) {
+    for (size_t i = 0; i < changedCount; i++) {
+        nodes[changedNodes[i]].logged = false;
+    }
+
+    changedCount = 0;
+    this->tracking = tracking;
+
+    // a new copy starts from every node in use, free ones are never reached from the root
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].height >= 0) {
+            logChange(i);
+        }
+    }
+}
+
+size_t BoundingVolumeHierarchy::size(void) const noexcept {
+    return leafCount;
+}
+
+int BoundingVolumeHierarchy::getHeight(void) const noexcept {
+    return root == NULL_NODE ? 0 : nodes[root].height;
+}
+
+float BoundingVolumeHierarchy::getAreaRatio(void) const noexcept {
+    if (root == NULL_NODE || nodes[root].isLeaf()) {
+        return 1.f;
+    }
+
+    float totalArea = 0.f;
+    for (auto& node : nodes) {
+        if (node.height > 0) {
+            totalArea += node.boundingBox.getSurfaceArea();
+        }
+    }
+
+    const float rootArea = nodes[root].boundingBox.getSurfaceArea();
+    return rootArea > 0.f ? totalArea / rootArea : 1.f;
+}
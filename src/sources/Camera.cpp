@@ -15,7 +15,7 @@ Camera::Camera(
 }
 
 Camera::Camera(const Camera& camera):
-    SceneObject(camera.name, camera.transform),
+    SceneObject(camera.name, camera.getTransform()),
     eyePosition(camera.eyePosition),
     lookAtPosition(camera.lookAtPosition),
     upVector(camera.upVector),
@@ -23,7 +23,7 @@ Camera::Camera(const Camera& camera):
 }
 
 Camera::Camera(Camera&& camera):
-    SceneObject(std::move(camera.name), std::move(camera.transform)),
+    SceneObject(std::move(camera.name), camera.getTransform()),
     eyePosition(std::move(camera.eyePosition)),
     lookAtPosition(std::move(camera.lookAtPosition)),
     upVector(std::move(camera.upVector)),
@@ -32,38 +32,45 @@ Camera::Camera(Camera&& camera):
 
 Camera& Camera::operator=(const Camera& camera) noexcept {
     name = camera.name;
-    transform = camera.transform;
+    setTransform(camera.getTransform());
     eyePosition = camera.eyePosition;
     lookAtPosition = camera.lookAtPosition;
     upVector = camera.upVector;
     cameraMatrix = camera.cameraMatrix;
+    cameraMatrixDirty = true;
 
     return *this;
 }
 
 Camera& Camera::operator=(Camera&& camera) noexcept {
     name = std::move(camera.name);
-    transform = std::move(camera.transform);
+    setTransform(camera.getTransform());
     eyePosition = std::move(camera.eyePosition);
     lookAtPosition = std::move(camera.lookAtPosition);
     upVector = std::move(camera.upVector);
     cameraMatrix = std::move(camera.cameraMatrix);
+    cameraMatrixDirty = true;
 
     return *this;
 }
 
-void Camera::updateCameraMatrix(void) noexcept {
-    const mat4 matrix = transform.getMatrix();
+void Camera::worldTransformChanged(void) const noexcept {
+    SceneObject::worldTransformChanged();
+    cameraMatrixDirty = true;
+}
+
+bool Camera::isWorldTransformObserved(void) const noexcept {
+    return true;
+}
+
+void Camera::updateCameraMatrix(void) const noexcept {
+    const mat4& matrix = getWorldTransform().getMatrix();
     cameraMatrix = lookAt(
         vec3(matrix * vec4(eyePosition, 1.f)),
         vec3(matrix * vec4(lookAtPosition, 1.f)),
         vec3(matrix * vec4(upVector, 0.f))
     );
-}
-
-void Camera::update(const Transform& newTransform) {
-    SceneObject::update(newTransform);
-    updateCameraMatrix();
+    cameraMatrixDirty = false;
 }
 
 const vec3& Camera::getEyePosition(void) const noexcept {
@@ -97,5 +104,12 @@ Camera& Camera::setUpVector(const vec3& upVector) noexcept {
 }
 
 const mat4& Camera::getCameraMatrix(void) const noexcept {
+    // moving an ancestor only shows once the world transform is resolved
+    getWorldTransform();
+
+    if (cameraMatrixDirty) {
+        updateCameraMatrix();
+    }
+
     return cameraMatrix;
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include <Frustum.hpp>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+Frustum::Frustum(const mat4& ProjectionViewMatrix) {
+    const mat4 rows = transpose(ProjectionViewMatrix);
+
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[3] + rows[2];
+    planes[5] = rows[3] - rows[2];
+
+    for (auto& plane : planes) {
+        plane /= length(vec3(plane));
+    }
+}
+
+Frustum::Frustum(const Frustum& frustum) {
+    for (size_t i = 0; i < 6; i++) {
+        planes[i] = frustum.planes[i];
+    }
+}
+
+Frustum& Frustum::operator=(const Frustum& other) noexcept {
+    for (size_t i = 0; i < 6; i++) {
+        planes[i] = other.planes[i];
+    }
+
+    return *this;
+}
+
+bool Frustum::intersects(const BoundingSphere& boundingSphere) const noexcept {
+    const vec4 center = vec4(boundingSphere.getCenter(), 1.f);
+
+    for (auto& plane : planes) {
+        if (dot(plane, center) < -boundingSphere.getRadius()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::intersects(const BoundingBox& boundingBox) const noexcept {
+    // only the corner furthest along each plane normal needs testing
+    for (auto& plane : planes) {
+        const vec3 corner = vec3(
+            plane.x >= 0.f ? boundingBox.getMaximum().x : boundingBox.getMinimum().x,
+            plane.y >= 0.f ? boundingBox.getMaximum().y : boundingBox.getMinimum().y,
+            plane.z >= 0.f ? boundingBox.getMaximum().z : boundingBox.getMinimum().z
+        );
+
+        if (dot(vec3(plane), corner) + plane.w < 0.f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::contains(const BoundingBox& boundingBox) const noexcept {
+    // the corner nearest to each plane has to be on its inner side
+    for (auto& plane : planes) {
+        const vec3 corner = vec3(
+            plane.x >= 0.f ? boundingBox.getMinimum().x : boundingBox.getMaximum().x,
+            plane.y >= 0.f ? boundingBox.getMinimum().y : boundingBox.getMaximum().y,
+            plane.z >= 0.f ? boundingBox.getMinimum().z : boundingBox.getMaximum().z
+        );
+
+        if (dot(vec3(plane), corner) + plane.w < 0.f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t Frustum::intersects(
+    const float* centerX,
+    const float* centerY,
+    const float* centerZ,
+    const float* radius,
+    const size_t& count,
+    unsigned char* visible
+) const noexcept {
+    size_t visibleCount = 0;
+    size_t i = 0;
+
+#ifdef FRUSTUM_SSE
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_loadu_ps(centerX + i);
+        const __m128 y = _mm_loadu_ps(centerY + i);
+        const __m128 z = _mm_loadu_ps(centerZ + i);
+        const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+        __m128 outside = _mm_setzero_ps();
+
+        for (auto& plane : planes) {
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), z), _mm_set1_ps(plane.w))
+            );
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+        }
+
+        const int mask = _mm_movemask_ps(outside);
+        for (int lane = 0; lane < 4; lane++) {
+            visible[i + lane] = (mask >> lane) & 1 ? 0 : 1;
+            visibleCount += visible[i + lane];
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        visible[i] = intersects(BoundingSphere(vec3(centerX[i], centerY[i], centerZ[i]), radius[i])) ? 1 : 0;
+        visibleCount += visible[i];
+    }
+
+    return visibleCount;
+}
+
+const vec4& Frustum::getPlane(const size_t& index) const noexcept {
+    return planes[index];
+}
+
+ostream& operator<< (ostream& out, const Frustum& frustum) {
+    out << std::fixed << std::setprecision(4);
+
+    for (size_t i = 0; i < 6; i++) {
+        const vec4& plane = frustum.getPlane(i);
+        out << "Frustum plane " << i << ": " << plane.x << "\t\t" << plane.y << "\t\t" << plane.z << "\t\t" << plane.w << endl;
+    }
+
+    return out;
+}
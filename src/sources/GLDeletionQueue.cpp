@@ -0,0 +1,123 @@
+#include <GLDeletionQueue.hpp>
+
+// cpp
+#include <algorithm>
+
+static thread_local bool deferringThread = false;
+
+void GLDeletionQueue::deleteBuffers(const GLsizei& count, const GLuint* names) {
+    lock_guard<mutex> lock(queueMutex);
+
+    for (GLsizei i = 0; i < count; i++) {
+        if (names[i] != 0) {
+            buffers.push_back(names[i]);
+        }
+    }
+}
+
+void GLDeletionQueue::deleteVertexArrays(const GLsizei& count, const GLuint* names) {
+    lock_guard<mutex> lock(queueMutex);
+
+    for (GLsizei i = 0; i < count; i++) {
+        if (names[i] != 0) {
+            vertexArrays.push_back(names[i]);
+        }
+    }
+}
+
+void GLDeletionQueue::deleteProgram(const GLuint& program) {
+    lock_guard<mutex> lock(queueMutex);
+
+    if (program != 0) {
+        programs.push_back(program);
+    }
+}
+
+void GLDeletionQueue::defer(const function<void(void)>& task) {
+    lock_guard<mutex> lock(queueMutex);
+    tasks.push_back(task);
+}
+
+size_t GLDeletionQueue::flush(void) {
+    vector<GLuint> flushedBuffers;
+    vector<GLuint> flushedVertexArrays;
+    vector<GLuint> flushedPrograms;
+    vector<function<void(void)>> flushedTasks;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        flushedBuffers.swap(buffers);
+        flushedVertexArrays.swap(vertexArrays);
+        flushedPrograms.swap(programs);
+        flushedTasks.swap(tasks);
+    }
+
+    if (!flushedVertexArrays.empty()) {
+        glDeleteVertexArrays((GLsizei)flushedVertexArrays.size(), flushedVertexArrays.data());
+    }
+
+    if (!flushedBuffers.empty()) {
+        glDeleteBuffers((GLsizei)flushedBuffers.size(), flushedBuffers.data());
+    }
+
+    // copies of a shader share their program, each copy queues it
+    sort(flushedPrograms.begin(), flushedPrograms.end());
+    flushedPrograms.erase(unique(flushedPrograms.begin(), flushedPrograms.end()), flushedPrograms.end());
+
+    for (auto& program : flushedPrograms) {
+        glDeleteProgram(program);
+    }
+
+    for (auto& task : flushedTasks) {
+        task();
+    }
+
+    const size_t freed = flushedBuffers.size() + flushedVertexArrays.size() + flushedPrograms.size();
+    {
+        lock_guard<mutex> lock(queueMutex);
+        freedCount += freed;
+        flushCount += freed > 0 ? 1 : 0;
+    }
+
+    return freed + flushedTasks.size();
+}
+
+bool GLDeletionQueue::empty(void) const noexcept {
+    lock_guard<mutex> lock(queueMutex);
+    return buffers.empty() && vertexArrays.empty() && programs.empty() && tasks.empty();
+}
+
+size_t GLDeletionQueue::getPendingCount(void) const noexcept {
+    lock_guard<mutex> lock(queueMutex);
+    return buffers.size() + vertexArrays.size() + programs.size() + tasks.size();
+}
+
+size_t GLDeletionQueue::getFreedCount(void) const noexcept {
+    lock_guard<mutex> lock(queueMutex);
+    return freedCount;
+}
+
+size_t GLDeletionQueue::getFlushCount(void) const noexcept {
+    lock_guard<mutex> lock(queueMutex);
+    return flushCount;
+}
+
+GLDeletionQueue& GLDeletionQueue::getShared(void) {
+    static GLDeletionQueue glDeletionQueue;
+    return glDeletionQueue;
+}
+
+bool GLDeletionQueue::isDeferring(void) noexcept {
+    return deferringThread;
+}
+
+void GLDeletionQueue::setDeferring(const bool& deferring) noexcept {
+    deferringThread = deferring;
+}
+
+ostream& operator<< (ostream& out, const GLDeletionQueue& glDeletionQueue) {
+    out << "GL Deletion Queue pending: " << glDeletionQueue.getPendingCount() << endl;
+    out << "GL Deletion Queue freed: " << glDeletionQueue.getFreedCount() << endl;
+    out << "GL Deletion Queue flushes: " << glDeletionQueue.getFlushCount() << endl;
+
+    return out;
+}
@@ -0,0 +1,306 @@
+#include <Geometry.hpp>
+#include <GLDeletionQueue.hpp>
+
+Geometry::Retention Geometry::defaultRetention = Geometry::KEEP_VERTICES;
+
+Geometry::Geometry(vector<Vertex>&& vertices, const Retention& retention, const VertexFormat& format) :
+    retention(retention),
+    format(format),
+    vertices(std::forward<vector<Vertex>>(vertices)),
+    boundingSphere(this->vertices) {
+    weldVertices(this->vertices, indices);
+    initialize();
+    applyRetention();
+}
+
+Geometry::Geometry(vector<Vertex>&& vertices, vector<GLuint>&& indices, const Retention& retention, const VertexFormat& format) :
+    retention(retention),
+    format(format),
+    vertices(std::forward<vector<Vertex>>(vertices)),
+    indices(std::forward<vector<GLuint>>(indices)),
+    boundingSphere(this->vertices) {
+    initialize();
+    applyRetention();
+}
+
+Geometry::Geometry(vector<Vertex>&& vertices, const shared_ptr<GeometryArena>& arena, const Retention& retention) :
+    arena(arena),
+    retention(retention),
+    format(arena->getFormat()),
+    vertices(std::forward<vector<Vertex>>(vertices)),
+    boundingSphere(this->vertices) {
+    weldVertices(this->vertices, indices);
+    initialize();
+    applyRetention();
+}
+
+Geometry::Geometry(vector<Vertex>&& vertices, vector<GLuint>&& indices, const shared_ptr<GeometryArena>& arena, const Retention& retention) :
+    arena(arena),
+    retention(retention),
+    format(arena->getFormat()),
+    vertices(std::forward<vector<Vertex>>(vertices)),
+    indices(std::forward<vector<GLuint>>(indices)),
+    boundingSphere(this->vertices) {
+    initialize();
+    applyRetention();
+}
+
+Geometry::~Geometry(void) {
+    deallocate();
+}
+
+void Geometry::initialize(void) noexcept {
+    vertexCount = (GLsizei)vertices.size();
+    indexCount = (GLsizei)indices.size();
+
+    if (!vertices.empty() && arena != nullptr) {
+        vector<unsigned char> encoded;
+        format.encode(vertices, boundingSphere, encoded);
+
+        // arena buffers always take 32 bit indices
+        indexType = GL_UNSIGNED_INT;
+        allocation = arena->allocate(encoded.data(), vertices.size(), indices.data(), indices.size());
+    } else if (!vertices.empty()) {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        if (format.isFloat()) {
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+        } else {
+            vector<unsigned char> encoded;
+            format.encode(vertices, boundingSphere, encoded);
+            glBufferData(GL_ARRAY_BUFFER, encoded.size(), encoded.data(), GL_STATIC_DRAW);
+        }
+
+        // the element buffer binding is part of the VAO state
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+        if (vertices.size() <= 0x10000) {
+            // every index fits in 16 bits, which halves the index buffer
+            vector<GLushort> shortIndices(indices.begin(), indices.end());
+            indexType = GL_UNSIGNED_SHORT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(GLushort), shortIndices.data(), GL_STATIC_DRAW);
+        } else {
+            indexType = GL_UNSIGNED_INT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        }
+
+        // positions, normals, colors and texture coords
+        format.apply();
+
+        glBindVertexArray(0);
+    }
+}
+
+void Geometry::initializeInstancing(void) noexcept {
+    // expects the vertex array to be bound already
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    VertexFormat::applyInstanceModel();
+}
+
+void Geometry::deallocate(void) noexcept {
+    // GL objects are tracked by their names, the CPU copies may have been released long ago.
+    // the names are deleted in a batch by the next flush of the deletion queue
+    GLDeletionQueue& deletionQueue = GLDeletionQueue::getShared();
+    const GLuint buffers[] = { VBO, EBO, instanceVBO };
+    deletionQueue.deleteVertexArrays(1, &VAO);
+    deletionQueue.deleteBuffers(3, buffers);
+    VAO = 0;
+    VBO = 0;
+    EBO = 0;
+    instanceVBO = 0;
+
+    // released in the background, the arena range is returned on the GL thread
+    if (allocation != GeometryArena::NULL_ALLOCATION && GLDeletionQueue::isDeferring()) {
+        const shared_ptr<GeometryArena> owner = arena;
+        const size_t freed = allocation;
+        deletionQueue.defer([owner, freed](void) { owner->free(freed); });
+    } else if (allocation != GeometryArena::NULL_ALLOCATION) {
+        arena->free(allocation);
+    }
+
+    allocation = GeometryArena::NULL_ALLOCATION;
+}
+
+void Geometry::applyRetention(void) {
+    // the bounding sphere is already built, so nothing below needs the full vertices again
+    switch (retention) {
+    case KEEP_VERTICES:
+        break;
+
+    case KEEP_POSITIONS:
+        positions.reserve(vertices.size());
+        for (auto& vertex : vertices) {
+            positions.push_back(vertex.position);
+        }
+
+        vector<Vertex>().swap(vertices);
+        break;
+
+    case DISCARD_VERTICES:
+        vector<Vertex>().swap(vertices);
+        vector<GLuint>().swap(indices);
+        break;
+    }
+}
+
+void Geometry::draw(void) const noexcept {
+    if (allocation != GeometryArena::NULL_ALLOCATION) {
+        arena->draw(allocation);
+    } else {
+        glDrawElements(GL_TRIANGLES, indexCount, indexType, (void*)0);
+    }
+}
+
+void Geometry::drawObjects(const GLuint& firstObjectIndex, const GLsizei& objectCount) const noexcept {
+    if (allocation != GeometryArena::NULL_ALLOCATION) {
+        arena->drawObjects(allocation, firstObjectIndex, objectCount);
+    } else {
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, indexType, (void*)0, objectCount, firstObjectIndex);
+    }
+}
+
+void Geometry::drawInstanced(const vector<mat4>& models) {
+    if (models.empty() || getVAO() == 0) {
+        return;
+    }
+
+    if (allocation != GeometryArena::NULL_ALLOCATION) {
+        // the arena block sets up its own instance buffer in the shared vertex array
+        glBindBuffer(GL_ARRAY_BUFFER, arena->getInstanceVBO(allocation));
+    } else if (instanceVBO == 0) {
+        initializeInstancing();
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    }
+
+    const vector<mat4>* uploaded = &models;
+
+    if (format.getPositionEncoding() != VertexFormat::POSITION_FLOAT) {
+        instanceModels.resize(models.size());
+
+        for (size_t i = 0; i < models.size(); i++) {
+            instanceModels[i] = decodeModel(models[i]);
+        }
+
+        uploaded = &instanceModels;
+    }
+
+    // respecifying the whole store orphans the one still read by earlier draws
+    glBufferData(GL_ARRAY_BUFFER, uploaded->size() * sizeof(mat4), uploaded->data(), GL_STREAM_DRAW);
+
+    if (allocation != GeometryArena::NULL_ALLOCATION) {
+        arena->drawInstanced(allocation, (GLsizei)uploaded->size());
+    } else {
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, indexType, (void*)0, (GLsizei)uploaded->size());
+    }
+}
+
+void Geometry::drawIndirect(const vector<DrawElementsIndirectCommand>& commands, const vector<mat4>& models) {
+    if (allocation != GeometryArena::NULL_ALLOCATION) {
+        arena->drawIndirect(allocation, commands, models);
+    }
+}
+
+bool Geometry::getDrawCommand(DrawElementsIndirectCommand& command) const noexcept {
+    if (allocation == GeometryArena::NULL_ALLOCATION) {
+        return false;
+    }
+
+    command = arena->getDrawCommand(allocation);
+    return true;
+}
+
+const vector<Vertex>& Geometry::getVertices(void) const noexcept {
+    return vertices;
+}
+
+const vector<vec3>& Geometry::getPositions(void) const noexcept {
+    return positions;
+}
+
+const vector<GLuint>& Geometry::getIndices(void) const noexcept {
+    return indices;
+}
+
+const GLsizei& Geometry::getVertexCount(void) const noexcept {
+    return vertexCount;
+}
+
+const GLsizei& Geometry::getIndexCount(void) const noexcept {
+    return indexCount;
+}
+
+const Geometry::Retention& Geometry::getRetention(void) const noexcept {
+    return retention;
+}
+
+const BoundingSphere& Geometry::getBoundingSphere(void) const noexcept {
+    return boundingSphere;
+}
+
+const VertexFormat& Geometry::getFormat(void) const noexcept {
+    return format;
+}
+
+mat4 Geometry::getPositionDecode(void) const noexcept {
+    return format.getPositionDecode(boundingSphere);
+}
+
+mat4 Geometry::decodeModel(const mat4& world) const noexcept {
+    return format.getPositionEncoding() != VertexFormat::POSITION_FLOAT ? world * getPositionDecode() : world;
+}
+
+void Geometry::decodeDualQuaternion(const Transform& world, fdualquat& translationAndRotation, vec3& scale) const noexcept {
+    translationAndRotation = world.getTranslationAndRotation();
+    scale = world.getScale();
+
+    if (format.getPositionEncoding() != VertexFormat::POSITION_FLOAT && boundingSphere.getRadius() > 0.f) {
+        // world * translate(center) * scale(radius), the center is scaled by the world before it is rotated
+        translationAndRotation = translationAndRotation * fdualquat(fquat(1.f, 0.f, 0.f, 0.f), scale * boundingSphere.getCenter());
+        scale *= boundingSphere.getRadius();
+    }
+}
+
+const shared_ptr<GeometryArena>& Geometry::getArena(void) const noexcept {
+    return arena;
+}
+
+const GLuint& Geometry::getVBO(void) const noexcept {
+    return allocation != GeometryArena::NULL_ALLOCATION ? arena->getVBO(allocation) : VBO;
+}
+
+const GLuint& Geometry::getVAO(void) const noexcept {
+    return allocation != GeometryArena::NULL_ALLOCATION ? arena->getVAO(allocation) : VAO;
+}
+
+const GLuint& Geometry::getEBO(void) const noexcept {
+    return allocation != GeometryArena::NULL_ALLOCATION ? arena->getEBO(allocation) : EBO;
+}
+
+const GLenum& Geometry::getIndexType(void) const noexcept {
+    return indexType;
+}
+
+const Geometry::Retention& Geometry::getDefaultRetention(void) noexcept {
+    return defaultRetention;
+}
+
+void Geometry::setDefaultRetention(const Retention& retention) noexcept {
+    defaultRetention = retention;
+}
+
+ostream& operator<< (ostream& out, const Geometry& geometry) {
+    out << "Geometry VBO: " << geometry.getVBO() << endl;
+    out << "Geometry VAO: " << geometry.getVAO() << endl;
+    out << "Geometry EBO: " << geometry.getEBO() << endl;
+    out << "Geometry vertices: " << geometry.getVertexCount() << endl;
+    out << "Geometry indices: " << geometry.getIndexCount() << endl;
+
+    return out;
+}
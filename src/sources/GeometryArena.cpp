@@ -0,0 +1,413 @@
+#include <GeometryArena.hpp>
+#include <GLDeletionQueue.hpp>
+
+// cpp
+#include <algorithm>
+
+GeometryArena::FreeList::FreeList(const size_t& capacity):
+    capacity(capacity) {
+    if (capacity > 0) {
+        ranges.emplace(0, capacity);
+    }
+}
+
+bool GeometryArena::FreeList::allocate(const size_t& size, size_t& offset) {
+    if (size == 0) {
+        offset = 0;
+        return true;
+    }
+
+    for (auto it = ranges.begin(); it != ranges.end(); it++) {
+        if (it->second >= size) {
+            offset = it->first;
+
+            if (it->second > size) {
+                ranges.emplace(it->first + size, it->second - size);
+            }
+
+            ranges.erase(it);
+            used += size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void GeometryArena::FreeList::free(const size_t& offset, const size_t& size) {
+    if (size == 0) {
+        return;
+    }
+
+    auto next = ranges.lower_bound(offset);
+    size_t begin = offset;
+    size_t end = offset + size;
+
+    if (next != ranges.begin()) {
+        auto previous = std::prev(next);
+
+        if (previous->first + previous->second == begin) {
+            begin = previous->first;
+            ranges.erase(previous);
+        }
+    }
+
+    if (next != ranges.end() && next->first == end) {
+        end += next->second;
+        ranges.erase(next);
+    }
+
+    ranges.emplace(begin, end - begin);
+    used -= size;
+}
+
+size_t GeometryArena::FreeList::getLargestRange(void) const noexcept {
+    size_t largest = 0;
+
+    for (auto& range : ranges) {
+        largest = std::max(largest, range.second);
+    }
+
+    return largest;
+}
+
+GeometryArena::GeometryArena(const VertexFormat& format, const size_t& blockVertexCapacity, const size_t& blockIndexCapacity):
+    format(format),
+    blockVertexCapacity(blockVertexCapacity),
+    blockIndexCapacity(blockIndexCapacity) {
+}
+
+GeometryArena::~GeometryArena(void) {
+    GLDeletionQueue& deletionQueue = GLDeletionQueue::getShared();
+
+    for (auto& block : blocks) {
+        const GLuint buffers[] = { block.VBO, block.EBO, block.instanceVBO };
+        deletionQueue.deleteVertexArrays(1, &block.VAO);
+        deletionQueue.deleteBuffers(3, buffers);
+    }
+
+    deletionQueue.deleteBuffers(1, &indirectBuffer);
+}
+
+size_t GeometryArena::createBlock(const size_t& vertexCapacity, const size_t& indexCapacity) {
+    Block block;
+    block.vertexRanges = FreeList(vertexCapacity);
+    block.indexRanges = FreeList(indexCapacity);
+
+    glGenVertexArrays(1, &block.VAO);
+    glGenBuffers(1, &block.VBO);
+    glGenBuffers(1, &block.EBO);
+    glGenBuffers(1, &block.instanceVBO);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, block.VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, vertexCapacity * format.getStride(), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, block.EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, indexCapacity * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+    bindBlockBuffers(block);
+
+    blocks.push_back(block);
+    return blocks.size() - 1;
+}
+
+void GeometryArena::bindBlockBuffers(const Block& block) const noexcept {
+    glBindVertexArray(block.VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, block.VBO);
+    format.apply();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, block.EBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, block.instanceVBO);
+    VertexFormat::applyInstanceModel();
+
+    glBindVertexArray(0);
+}
+
+size_t GeometryArena::allocate(const void* vertexData, const size_t& vertexCount, const GLuint* indices, const size_t& indexCount) {
+    Allocation allocation;
+    allocation.vertexCount = vertexCount;
+    allocation.indexCount = indexCount;
+    allocation.live = true;
+
+    // both ranges have to come from the same block, as it owns the vertex array
+    size_t block = 0;
+    for (; block < blocks.size(); block++) {
+        if (blocks[block].vertexRanges.allocate(vertexCount, allocation.firstVertex)) {
+            if (blocks[block].indexRanges.allocate(indexCount, allocation.firstIndex)) {
+                break;
+            }
+
+            blocks[block].vertexRanges.free(allocation.firstVertex, vertexCount);
+        }
+    }
+
+    if (block == blocks.size()) {
+        // geometry larger than a block gets a block of its own size
+        block = createBlock(std::max(vertexCount, blockVertexCapacity), std::max(indexCount, blockIndexCapacity));
+        blocks[block].vertexRanges.allocate(vertexCount, allocation.firstVertex);
+        blocks[block].indexRanges.allocate(indexCount, allocation.firstIndex);
+    }
+
+    allocation.block = block;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, blocks[block].VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.firstVertex * format.getStride(), vertexCount * format.getStride(), vertexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, blocks[block].EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.firstIndex * sizeof(GLuint), indexCount * sizeof(GLuint), indices);
+
+    size_t handle = allocations.size();
+    if (!freeAllocations.empty()) {
+        handle = freeAllocations.back();
+        freeAllocations.pop_back();
+        allocations[handle] = allocation;
+    } else {
+        allocations.push_back(allocation);
+    }
+
+    return handle;
+}
+
+void GeometryArena::free(const size_t& allocation) noexcept {
+    Allocation& freed = allocations[allocation];
+    Block& block = blocks[freed.block];
+
+    block.vertexRanges.free(freed.firstVertex, freed.vertexCount);
+    block.indexRanges.free(freed.firstIndex, freed.indexCount);
+    freed.live = false;
+    freeAllocations.push_back(allocation);
+}
+
+size_t GeometryArena::defragment(void) {
+    size_t movedBytes = 0;
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        Block& block = blocks[i];
+
+        // a block whose only free ranges sit at its end is already packed
+        const bool verticesPacked = block.vertexRanges.ranges.empty() ||
+            (block.vertexRanges.ranges.size() == 1 && block.vertexRanges.ranges.begin()->first == block.vertexRanges.used);
+        const bool indicesPacked = block.indexRanges.ranges.empty() ||
+            (block.indexRanges.ranges.size() == 1 && block.indexRanges.ranges.begin()->first == block.indexRanges.used);
+
+        if (verticesPacked && indicesPacked) {
+            continue;
+        }
+
+        vector<size_t> live;
+        for (size_t j = 0; j < allocations.size(); j++) {
+            if (allocations[j].live && allocations[j].block == i) {
+                live.push_back(j);
+            }
+        }
+
+        std::sort(live.begin(), live.end(), [this](const size_t& a, const size_t& b) {
+            return allocations[a].firstVertex < allocations[b].firstVertex;
+        });
+
+        // ranges of the same buffer may not overlap in a copy, so the data moves into fresh buffers
+        GLuint VBO = 0;
+        GLuint EBO = 0;
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+        glBufferData(GL_COPY_WRITE_BUFFER, block.vertexRanges.capacity * format.getStride(), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER, block.VBO);
+
+        size_t firstVertex = 0;
+        for (auto& handle : live) {
+            Allocation& allocation = allocations[handle];
+            const size_t bytes = allocation.vertexCount * format.getStride();
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.firstVertex * format.getStride(), firstVertex * format.getStride(), bytes);
+            allocation.firstVertex = firstVertex;
+            firstVertex += allocation.vertexCount;
+            movedBytes += bytes;
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+        glBufferData(GL_COPY_WRITE_BUFFER, block.indexRanges.capacity * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER, block.EBO);
+
+        // indices count from the base vertex, so they are copied unchanged
+        size_t firstIndex = 0;
+        for (auto& handle : live) {
+            Allocation& allocation = allocations[handle];
+            const size_t bytes = allocation.indexCount * sizeof(GLuint);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.firstIndex * sizeof(GLuint), firstIndex * sizeof(GLuint), bytes);
+            allocation.firstIndex = firstIndex;
+            firstIndex += allocation.indexCount;
+            movedBytes += bytes;
+        }
+
+        const GLuint replaced[] = { block.VBO, block.EBO };
+        GLDeletionQueue::getShared().deleteBuffers(2, replaced);
+        block.VBO = VBO;
+        block.EBO = EBO;
+        bindBlockBuffers(block);
+
+        block.vertexRanges.ranges.clear();
+        if (firstVertex < block.vertexRanges.capacity) {
+            block.vertexRanges.ranges.emplace(firstVertex, block.vertexRanges.capacity - firstVertex);
+        }
+
+        block.indexRanges.ranges.clear();
+        if (firstIndex < block.indexRanges.capacity) {
+            block.indexRanges.ranges.emplace(firstIndex, block.indexRanges.capacity - firstIndex);
+        }
+    }
+
+    return movedBytes;
+}
+
+void GeometryArena::draw(const size_t& allocation) const noexcept {
+    const Allocation& drawn = allocations[allocation];
+    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)drawn.indexCount, GL_UNSIGNED_INT, (void*)(drawn.firstIndex * sizeof(GLuint)), (GLint)drawn.firstVertex);
+}
+
+void GeometryArena::drawInstanced(const size_t& allocation, const GLsizei& instanceCount) const noexcept {
+    const Allocation& drawn = allocations[allocation];
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)drawn.indexCount, GL_UNSIGNED_INT, (void*)(drawn.firstIndex * sizeof(GLuint)), instanceCount, (GLint)drawn.firstVertex);
+}
+
+void GeometryArena::drawObjects(const size_t& allocation, const GLuint& baseInstance, const GLsizei& instanceCount) const noexcept {
+    const Allocation& drawn = allocations[allocation];
+    glDrawElementsInstancedBaseVertexBaseInstance(
+        GL_TRIANGLES,
+        (GLsizei)drawn.indexCount,
+        GL_UNSIGNED_INT,
+        (void*)(drawn.firstIndex * sizeof(GLuint)),
+        instanceCount,
+        (GLint)drawn.firstVertex,
+        baseInstance
+    );
+}
+
+void GeometryArena::drawIndirect(const size_t& allocation, const vector<DrawElementsIndirectCommand>& commands, const vector<mat4>& models) {
+    if (commands.empty()) {
+        return;
+    }
+
+    if (indirectBuffer == 0) {
+        glGenBuffers(1, &indirectBuffer);
+    }
+
+    // both stores are respecified every pass, orphaning the ones earlier draws still read
+    if (!models.empty()) {
+        glBindBuffer(GL_ARRAY_BUFFER, blocks[allocations[allocation].block].instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, models.size() * sizeof(mat4), models.data(), GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)commands.size(), 0);
+}
+
+DrawElementsIndirectCommand GeometryArena::getDrawCommand(const size_t& allocation) const noexcept {
+    const Allocation& drawn = allocations[allocation];
+
+    DrawElementsIndirectCommand command;
+    command.count = (GLuint)drawn.indexCount;
+    command.instanceCount = 1;
+    command.firstIndex = (GLuint)drawn.firstIndex;
+    command.baseVertex = (GLint)drawn.firstVertex;
+    return command;
+}
+
+const VertexFormat& GeometryArena::getFormat(void) const noexcept {
+    return format;
+}
+
+const GLuint& GeometryArena::getVAO(const size_t& allocation) const noexcept {
+    return blocks[allocations[allocation].block].VAO;
+}
+
+const GLuint& GeometryArena::getVBO(const size_t& allocation) const noexcept {
+    return blocks[allocations[allocation].block].VBO;
+}
+
+const GLuint& GeometryArena::getEBO(const size_t& allocation) const noexcept {
+    return blocks[allocations[allocation].block].EBO;
+}
+
+const GLuint& GeometryArena::getInstanceVBO(const size_t& allocation) const noexcept {
+    return blocks[allocations[allocation].block].instanceVBO;
+}
+
+size_t GeometryArena::getBlockCount(void) const noexcept {
+    return blocks.size();
+}
+
+size_t GeometryArena::getAllocationCount(void) const noexcept {
+    return allocations.size() - freeAllocations.size();
+}
+
+size_t GeometryArena::getUsedVertexCount(void) const noexcept {
+    size_t used = 0;
+
+    for (auto& block : blocks) {
+        used += block.vertexRanges.used;
+    }
+
+    return used;
+}
+
+size_t GeometryArena::getVertexCapacity(void) const noexcept {
+    size_t capacity = 0;
+
+    for (auto& block : blocks) {
+        capacity += block.vertexRanges.capacity;
+    }
+
+    return capacity;
+}
+
+size_t GeometryArena::getUsedIndexCount(void) const noexcept {
+    size_t used = 0;
+
+    for (auto& block : blocks) {
+        used += block.indexRanges.used;
+    }
+
+    return used;
+}
+
+size_t GeometryArena::getIndexCapacity(void) const noexcept {
+    size_t capacity = 0;
+
+    for (auto& block : blocks) {
+        capacity += block.indexRanges.capacity;
+    }
+
+    return capacity;
+}
+
+size_t GeometryArena::getFreeRangeCount(void) const noexcept {
+    size_t count = 0;
+
+    for (auto& block : blocks) {
+        count += block.vertexRanges.ranges.size() + block.indexRanges.ranges.size();
+    }
+
+    return count;
+}
+
+size_t GeometryArena::getLargestFreeVertexRange(void) const noexcept {
+    size_t largest = 0;
+
+    for (auto& block : blocks) {
+        largest = std::max(largest, block.vertexRanges.getLargestRange());
+    }
+
+    return largest;
+}
+
+ostream& operator<< (ostream& out, const GeometryArena& geometryArena) {
+    out << "Geometry Arena blocks: " << geometryArena.getBlockCount() << endl;
+    out << "Geometry Arena allocations: " << geometryArena.getAllocationCount() << endl;
+    out << "Geometry Arena vertices: " << geometryArena.getUsedVertexCount() << " / " << geometryArena.getVertexCapacity() << endl;
+    out << "Geometry Arena indices: " << geometryArena.getUsedIndexCount() << " / " << geometryArena.getIndexCapacity() << endl;
+    out << "Geometry Arena free ranges: " << geometryArena.getFreeRangeCount() << endl;
+    out << "Geometry Arena largest free vertex range: " << geometryArena.getLargestFreeVertexRange() << endl;
+
+    return out;
+}
@@ -0,0 +1,64 @@
+#include <GeometryCache.hpp>
+
+shared_ptr<Geometry> GeometryCache::load(const string& key, const function<shared_ptr<Geometry>(void)>& create) {
+    weak_ptr<Geometry>& entry = geometries[key];
+    shared_ptr<Geometry> geometry = entry.lock();
+
+    if (geometry != nullptr) {
+        hitCount++;
+        return geometry;
+    }
+
+    missCount++;
+    geometry = create();
+    entry = geometry;
+    return geometry;
+}
+
+shared_ptr<Geometry> GeometryCache::find(const string& key) const noexcept {
+    auto it = geometries.find(key);
+    return it != geometries.end() ? it->second.lock() : nullptr;
+}
+
+void GeometryCache::insert(const string& key, const shared_ptr<Geometry>& geometry) {
+    geometries[key] = geometry;
+}
+
+bool GeometryCache::erase(const string& key) noexcept {
+    return geometries.erase(key) > 0;
+}
+
+size_t GeometryCache::prune(void) noexcept {
+    size_t prunedCount = 0;
+
+    for (auto it = geometries.begin(); it != geometries.end();) {
+        if (it->second.expired()) {
+            it = geometries.erase(it);
+            prunedCount++;
+        } else {
+            it++;
+        }
+    }
+
+    return prunedCount;
+}
+
+size_t GeometryCache::size(void) const noexcept {
+    return geometries.size();
+}
+
+const size_t& GeometryCache::getHitCount(void) const noexcept {
+    return hitCount;
+}
+
+const size_t& GeometryCache::getMissCount(void) const noexcept {
+    return missCount;
+}
+
+ostream& operator<< (ostream& out, const GeometryCache& geometryCache) {
+    out << "Geometry Cache entries: " << geometryCache.size() << endl;
+    out << "Geometry Cache hits: " << geometryCache.getHitCount() << endl;
+    out << "Geometry Cache misses: " << geometryCache.getMissCount() << endl;
+
+    return out;
+}
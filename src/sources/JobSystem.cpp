@@ -0,0 +1,349 @@
+#include <JobSystem.hpp>
+
+// cpp
+#include <algorithm>
+
+// index of the queue owned by the current thread in every job system it works for
+static thread_local const JobSystem* currentJobSystem = nullptr;
+static thread_local size_t currentQueue = 0;
+
+JobSystem::Job::Job(void):
+    pendingCount(1),
+    finished(false) {
+}
+
+JobSystem::JobSystem(const size_t& workerCount):
+    mainThreadId(this_thread::get_id()),
+    queuedCount(0),
+    sleepingCount(0),
+    waitingCount(0),
+    stopping(false),
+    executedCount(0),
+    stolenCount(0),
+    injectedCount(0),
+    failedStealCount(0) {
+    const size_t count = workerCount > 0 ? workerCount : 1;
+
+    // the last queue takes jobs submitted from outside the workers
+    for (size_t i = 0; i <= count; i++) {
+        queues.push_back(unique_ptr<Queue>(new Queue()));
+    }
+
+    workers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        workers.push_back(thread(&JobSystem::work, this, i));
+    }
+}
+
+JobSystem::~JobSystem(void) {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    // workers only stop once nothing is queued, so every worker job ran by now
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // main lane jobs left behind, and whatever they queue
+    while (runOne(workers.size(), true)) {
+    }
+}
+
+size_t JobSystem::getQueueIndex(void) const noexcept {
+    return currentJobSystem == this ? currentQueue : workers.size();
+}
+
+void JobSystem::work(const size_t& worker) {
+    currentJobSystem = this;
+    currentQueue = worker;
+
+    for (;;) {
+        if (runOne(worker, false)) {
+            continue;
+        }
+
+        // a job still running may queue continuations, which its own worker runs next
+        if (stopping) {
+            return;
+        }
+
+        // a job queued after the check below is seen by the predicate, a job queued before it wakes us
+        unique_lock<mutex> lock(sleepMutex);
+        sleepingCount++;
+        wakeUp.wait(lock, [this](void) { return stopping || queuedCount > 0; });
+        sleepingCount--;
+    }
+}
+
+shared_ptr<JobSystem::Job> JobSystem::take(const size_t& queue) noexcept {
+    // the owner works newest first while its data is still cached, thieves take the oldest
+    Queue& own = *queues[queue];
+    {
+        lock_guard<mutex> lock(own.queueMutex);
+
+        if (!own.jobs.empty()) {
+            shared_ptr<Job> job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+
+            if (queue == workers.size()) {
+                injectedCount++;
+            }
+
+            return job;
+        }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+        const size_t index = (queue + i) % queues.size();
+        Queue& victim = *queues[index];
+        lock_guard<mutex> lock(victim.queueMutex);
+
+        if (!victim.jobs.empty()) {
+            shared_ptr<Job> job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+
+            // the external queue belongs to no worker, taking from it is not stealing
+            if (index == workers.size()) {
+                injectedCount++;
+            } else {
+                stolenCount++;
+            }
+
+            return job;
+        }
+    }
+
+    failedStealCount++;
+    return nullptr;
+}
+
+bool JobSystem::runOne(const size_t& queue, const bool& mainThread) {
+    shared_ptr<Job> job = nullptr;
+
+    if (mainThread) {
+        lock_guard<mutex> lock(mainThreadQueue.queueMutex);
+
+        if (!mainThreadQueue.jobs.empty()) {
+            job = std::move(mainThreadQueue.jobs.front());
+            mainThreadQueue.jobs.pop_front();
+        }
+    }
+
+    if (job == nullptr) {
+        if (queuedCount == 0) {
+            return false;
+        }
+
+        job = take(queue);
+
+        if (job == nullptr) {
+            return false;
+        }
+
+        queuedCount--;
+    }
+
+    job->task();
+    finish(job);
+    return true;
+}
+
+void JobSystem::schedule(const shared_ptr<Job>& job) {
+    if (job->lane == MAIN_THREAD) {
+        {
+            lock_guard<mutex> lock(mainThreadQueue.queueMutex);
+            mainThreadQueue.jobs.push_back(job);
+        }
+
+        if (waitingCount > 0) {
+            notifyWaiting();
+        }
+
+        return;
+    }
+
+    Queue& queue = *queues[getQueueIndex()];
+    {
+        lock_guard<mutex> lock(queue.queueMutex);
+        queue.jobs.push_back(job);
+    }
+
+    queuedCount++;
+
+    // taking the lock orders the wake up after a worker that is about to sleep checked queuedCount
+    if (sleepingCount > 0) {
+        { lock_guard<mutex> lock(sleepMutex); }
+        wakeUp.notify_one();
+    }
+
+    // a waiting thread helps with it
+    if (waitingCount > 0) {
+        notifyWaiting();
+    }
+}
+
+void JobSystem::finish(const shared_ptr<Job>& job) {
+    vector<shared_ptr<Job>> continuations;
+    {
+        lock_guard<mutex> lock(job->continuationMutex);
+        job->finished = true;
+        continuations.swap(job->continuations);
+    }
+
+    executedCount++;
+
+    for (auto& continuation : continuations) {
+        if (--continuation->pendingCount == 0) {
+            schedule(continuation);
+        }
+    }
+
+    if (waitingCount > 0) {
+        notifyWaiting();
+    }
+}
+
+void JobSystem::notifyWaiting(void) {
+    { lock_guard<mutex> lock(sleepMutex); }
+    jobDone.notify_all();
+}
+
+shared_ptr<JobSystem::Job> JobSystem::run(const function<void(void)>& task, const vector<shared_ptr<Job>>& dependencies, const Lane& lane) {
+    shared_ptr<Job> job = make_shared<Job>();
+    job->task = task;
+    job->lane = lane;
+
+    for (auto& dependency : dependencies) {
+        lock_guard<mutex> lock(dependency->continuationMutex);
+
+        if (!dependency->finished) {
+            job->pendingCount++;
+            dependency->continuations.push_back(job);
+        }
+    }
+
+    // the extra count kept the job from starting while dependencies were still being added
+    if (--job->pendingCount == 0) {
+        schedule(job);
+    }
+
+    return job;
+}
+
+void JobSystem::wait(const shared_ptr<Job>& job) {
+    const size_t queue = getQueueIndex();
+    const bool mainThread = this_thread::get_id() == mainThreadId;
+
+    while (!job->finished) {
+        if (runOne(queue, mainThread)) {
+            continue;
+        }
+
+        // the job runs elsewhere and nothing else is queued. a job finished or queued after the check below
+        // is seen by the predicate, one finished or queued before it wakes us
+        unique_lock<mutex> lock(sleepMutex);
+        waitingCount++;
+        jobDone.wait(lock, [this, &job, &mainThread](void) {
+            if (job->finished || queuedCount > 0) {
+                return true;
+            }
+
+            if (!mainThread) {
+                return false;
+            }
+
+            lock_guard<mutex> queueLock(mainThreadQueue.queueMutex);
+            return !mainThreadQueue.jobs.empty();
+        });
+        waitingCount--;
+    }
+}
+
+void JobSystem::parallelFor(const size_t& count, const function<void(const size_t&, const size_t&)>& body, const size_t& chunkCount) {
+    if (count == 0) {
+        return;
+    }
+
+    const size_t chunks = std::min(chunkCount > 0 ? chunkCount : (workers.size() + 1) * 4, count);
+    if (chunks == 1) {
+        body(0, count);
+        return;
+    }
+
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    vector<shared_ptr<Job>> jobs;
+    jobs.reserve(chunks);
+
+    for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+        const size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+        jobs.push_back(run([&body, begin, end](void) { body(begin, end); }));
+    }
+
+    // the first chunk runs here, the rest is helped with while waiting
+    body(0, chunkSize);
+
+    for (auto& job : jobs) {
+        wait(job);
+    }
+}
+
+size_t JobSystem::runMainThreadJobs(void) {
+    size_t count = 0;
+
+    for (;;) {
+        shared_ptr<Job> job = nullptr;
+        {
+            lock_guard<mutex> lock(mainThreadQueue.queueMutex);
+
+            if (mainThreadQueue.jobs.empty()) {
+                return count;
+            }
+
+            job = std::move(mainThreadQueue.jobs.front());
+            mainThreadQueue.jobs.pop_front();
+        }
+
+        job->task();
+        finish(job);
+        count++;
+    }
+}
+
+size_t JobSystem::getWorkerCount(void) const noexcept {
+    return workers.size();
+}
+
+size_t JobSystem::getExecutedCount(void) const noexcept {
+    return executedCount;
+}
+
+size_t JobSystem::getStolenCount(void) const noexcept {
+    return stolenCount;
+}
+
+size_t JobSystem::getInjectedCount(void) const noexcept {
+    return injectedCount;
+}
+
+size_t JobSystem::getFailedStealCount(void) const noexcept {
+    return failedStealCount;
+}
+
+JobSystem& JobSystem::getShared(void) {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+ostream& operator<< (ostream& out, const JobSystem& jobSystem) {
+    out << "Job System workers: " << jobSystem.getWorkerCount() << endl;
+    out << "Job System executed jobs: " << jobSystem.getExecutedCount() << endl;
+    out << "Job System stolen jobs: " << jobSystem.getStolenCount() << endl;
+    out << "Job System injected jobs: " << jobSystem.getInjectedCount() << endl;
+    out << "Job System failed steals: " << jobSystem.getFailedStealCount() << endl;
+
+    return out;
+}
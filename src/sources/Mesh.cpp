@@ -1,95 +1,199 @@
 #include <Mesh.hpp>
 
-Mesh::Mesh(vector<Vertex>&& vertices, const string& name, const Transform& transform) :
+Mesh::Mesh(vector<Vertex>&& vertices, const string& name, const Transform& transform, const Geometry::Retention& retention) :
     SceneObject(name, transform),
-    vertices(std::forward<vector<Vertex>>(vertices)) {
-    initialize();
+    geometry(make_shared<Geometry>(std::forward<vector<Vertex>>(vertices), retention)) {
+}
+
+Mesh::Mesh(vector<Vertex>&& vertices, vector<GLuint>&& indices, const string& name, const Transform& transform, const Geometry::Retention& retention) :
+    SceneObject(name, transform),
+    geometry(make_shared<Geometry>(std::forward<vector<Vertex>>(vertices), std::forward<vector<GLuint>>(indices), retention)) {
+}
+
+Mesh::Mesh(const shared_ptr<Geometry>& geometry, const string& name, const Transform& transform) :
+    SceneObject(name, transform),
+    geometry(geometry) {
+}
+
+Mesh::Mesh(const Mesh& mesh):
+    SceneObject(mesh.name, mesh.getTransform()),
+    geometry(mesh.geometry),
+    shader(mesh.shader),
+    PVMHandle(mesh.PVMHandle),
+    modelHandle(mesh.modelHandle),
+    PVHandle(mesh.PVHandle) {
 }
 
 Mesh::Mesh(Mesh&& mesh):
-    SceneObject(std::move(mesh.name), std::move(mesh.transform)),
-    VBO(std::move(mesh.VBO)),
-    VAO(std::move(mesh.VAO)),
-    vertices(std::move(mesh.vertices)){
+    SceneObject(std::move(mesh.name), mesh.getTransform()),
+    geometry(std::move(mesh.geometry)),
+    shader(std::move(mesh.shader)),
+    PVMHandle(mesh.PVMHandle),
+    modelHandle(mesh.modelHandle),
+    PVHandle(mesh.PVHandle) {
 }
 
-Mesh::~Mesh(void) {
-    deallocate();
+Mesh& Mesh::operator=(const Mesh& other) noexcept {
+    name = other.name;
+    setTransform(other.getTransform());
+    geometry = other.geometry;
+    shader = other.shader;
+    PVMHandle = other.PVMHandle;
+    modelHandle = other.modelHandle;
+    PVHandle = other.PVHandle;
+
+    // other geometry means other bounds, for this mesh, its ancestors and the hierarchy
+    markBoundsDirty();
+    invalidateTransform();
+
+    return *this;
 }
 
-void Mesh::initialize(void) noexcept {
-    if (!vertices.empty()) {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    name = std::move(other.name);
+    setTransform(other.getTransform());
+    geometry = std::move(other.geometry);
+    shader = std::move(other.shader);
+    PVMHandle = other.PVMHandle;
+    modelHandle = other.modelHandle;
+    PVHandle = other.PVHandle;
 
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // other geometry means other bounds, for this mesh, its ancestors and the hierarchy
+    markBoundsDirty();
+    invalidateTransform();
 
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    return *this;
+}
+
+void Mesh::render(const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const {
+    if (shader != nullptr && geometry != nullptr) {
+        const mat4 model = geometry->decodeModel(worldTransform.getMatrix());
 
-        // vertex positions
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        // vertex normals
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-        // vertex colors
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-        // vertex texture coords
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+        shader->use();
+        shader->setMat4(PVMHandle, value_ptr(ProjectionViewMatrix * model));
+        shader->setMat4(modelHandle, value_ptr(model));
 
+        glBindVertexArray(geometry->getVAO());
+        geometry->draw();
         glBindVertexArray(0);
     }
 }
 
-void Mesh::deallocate(void) noexcept {
-    if (!vertices.empty()) {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        vertices.clear();
+void Mesh::enqueue(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const {
+    if (shader != nullptr && geometry != nullptr) {
+        // clip space w is the view depth, which sorts front to back within the same state and geometry
+        const float depth = (ProjectionViewMatrix * (worldTransform.getMatrix() * vec4(geometry->getBoundingSphere().getCenter(), 1.f))).w;
+        const uint64_t key = RenderQueue::makeKey(
+            0,
+            renderQueue.getProgramIndex(shader->getId()),
+            0,
+            renderQueue.getVertexArrayIndex(geometry->getVAO()),
+            renderQueue.getGeometryIndex(geometry.get()),
+            depth
+        );
+
+        // meshes sharing geometry and an instancing shader end up next to each other and are drawn in one call,
+        // with an arena that holds for every geometry of the same block
+        const void* batch = nullptr;
+        if (PVHandle >= 0) {
+            batch = geometry->getArena() != nullptr ? (const void*)geometry->getArena().get() : (const void*)geometry.get();
+        }
+
+        renderQueue.push(key, this, &worldTransform, batch, shader->getId(), geometry->getVAO());
     }
 }
 
-Mesh& Mesh::operator=(Mesh&& other) noexcept {
-    deallocate();
+void Mesh::submit(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const {
+    const mat4 model = geometry->decodeModel(worldTransform.getMatrix());
 
-    name = std::move(other.name);
-    transform = std::move(other.transform);
-    VBO = std::move(other.VBO);
-    VAO = std::move(other.VAO);
-    vertices = std::move(other.vertices);
+    renderQueue.useProgram(*shader);
+    shader->setMat4(PVMHandle, value_ptr(ProjectionViewMatrix * model));
+    shader->setMat4(modelHandle, value_ptr(model));
 
-    return *this;
+    renderQueue.bindVertexArray(geometry->getVAO());
+    geometry->draw();
 }
 
-void Mesh::draw(const mat4& ProjectionViewMatrix) const {
-    if (shader != nullptr) {
-        const mat4 model = transform.getMatrix();
+void Mesh::submitInstances(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const vector<mat4>& models) const {
+    renderQueue.useProgram(*shader);
+    shader->setMat4(PVHandle, value_ptr(ProjectionViewMatrix));
 
-        shader->use();
-        shader->setMat4("PVM", value_ptr(ProjectionViewMatrix * model));
-        shader->setMat4("model", value_ptr(model));
+    renderQueue.bindVertexArray(geometry->getVAO());
+    geometry->drawInstanced(models);
+}
 
-        glBindVertexArray(getVAO());
-        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)getVertices().size());
-        glBindVertexArray(0);
+bool Mesh::getIndirectDraw(const CachedTransform& worldTransform, DrawElementsIndirectCommand& command, mat4& model) const {
+    if (PVHandle < 0 || !geometry->getDrawCommand(command)) {
+        return false;
     }
 
-    SceneObject::draw(ProjectionViewMatrix);
+    model = geometry->decodeModel(worldTransform.getMatrix());
+    return true;
+}
+
+void Mesh::submitIndirect(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const vector<DrawElementsIndirectCommand>& commands, const vector<mat4>& models) const {
+    renderQueue.useProgram(*shader);
+    shader->setMat4(PVHandle, value_ptr(ProjectionViewMatrix));
+
+    renderQueue.bindVertexArray(geometry->getVAO());
+    geometry->drawIndirect(commands, models);
+}
+
+void Mesh::submitObjects(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const GLuint& firstObjectIndex, const GLsizei& objectCount) const {
+    renderQueue.useProgram(*shader);
+    shader->setMat4(PVHandle, value_ptr(ProjectionViewMatrix));
+
+    renderQueue.bindVertexArray(geometry->getVAO());
+    geometry->drawObjects(firstObjectIndex, objectCount);
+}
+
+mat4 Mesh::getModelMatrix(const CachedTransform& worldTransform) const noexcept {
+    return geometry != nullptr ? geometry->decodeModel(worldTransform.getMatrix()) : worldTransform.getMatrix();
+}
+
+void Mesh::getModelDualQuaternion(const CachedTransform& worldTransform, fdualquat& translationAndRotation, vec3& scale) const noexcept {
+    if (geometry != nullptr) {
+        geometry->decodeDualQuaternion(worldTransform, translationAndRotation, scale);
+    } else {
+        SceneObject::getModelDualQuaternion(worldTransform, translationAndRotation, scale);
+    }
+}
+
+bool Mesh::getBoundingSphere(BoundingSphere& boundingSphere) const noexcept {
+    if (geometry == nullptr) {
+        return false;
+    }
+
+    boundingSphere = geometry->getBoundingSphere();
+    return true;
+}
+
+const shared_ptr<Geometry>& Mesh::getGeometry(void) const noexcept {
+    return geometry;
 }
 
 const vector<Vertex>& Mesh::getVertices(void) const noexcept {
-    return vertices;
+    return geometry->getVertices();
+}
+
+const vector<GLuint>& Mesh::getIndices(void) const noexcept {
+    return geometry->getIndices();
 }
 
 const GLuint& Mesh::getVBO(void) const noexcept {
-    return VBO;
+    return geometry->getVBO();
 }
 
 const GLuint& Mesh::getVAO(void) const noexcept {
-    return VAO;
+    return geometry->getVAO();
+}
+
+const GLuint& Mesh::getEBO(void) const noexcept {
+    return geometry->getEBO();
+}
+
+const GLenum& Mesh::getIndexType(void) const noexcept {
+    return geometry->getIndexType();
 }
 
 const shared_ptr<Shader>& Mesh::getShader(void) const noexcept {
@@ -98,13 +202,18 @@ const shared_ptr<Shader>& Mesh::getShader(void) const noexcept {
 
 void Mesh::setShader(const shared_ptr<Shader>& shader) noexcept {
     this->shader = shader;
+    PVMHandle = shader != nullptr ? shader->getUniformHandle("PVM") : -1;
+    modelHandle = shader != nullptr ? shader->getUniformHandle("model") : -1;
+    PVHandle = shader != nullptr ? shader->getUniformHandle("PV") : -1;
 }
 
 ostream& operator<< (ostream& out, const Mesh& mesh) {
     out << "Mesh name: " << mesh.getName() << endl;
     out << "Mesh transform:\n" << mesh.getTransform() << endl;
-    out << "Mesh VBO: " << mesh.getVBO() << endl;
-    out << "Mesh VAO: " << mesh.getVAO() << endl;
+
+    if (mesh.getGeometry() != nullptr) {
+        out << *mesh.getGeometry();
+    }
 
     if (!mesh.getChildren().empty()) {
         out << "Mesh children:\n" << endl;
@@ -0,0 +1,25 @@
+#include <Parallel.hpp>
+
+void parallelFor(const size_t& count, const size_t& threadCount, const function<void(const size_t&, const size_t&)>& body) {
+    parallelFor(count, threadCount, body, JobSystem::getShared());
+}
+
+void parallelFor(const size_t& count, const size_t& threadCount, const function<void(const size_t&, const size_t&)>& body, JobSystem& jobSystem) {
+    if (count == 0) {
+        return;
+    }
+
+    const size_t threads = threadCount < count ? (threadCount > 0 ? threadCount : 1) : count;
+    if (threads == 1) {
+        body(0, count);
+        return;
+    }
+
+    // several chunks per thread so that uneven chunks even out
+    jobSystem.parallelFor(count, body, threads * 4);
+}
+
+size_t getHardwareThreadCount(void) noexcept {
+    const size_t threadCount = thread::hardware_concurrency();
+    return threadCount > 0 ? threadCount : 1;
+}
@@ -0,0 +1,146 @@
+#include <ProgramCache.hpp>
+
+// cpp
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+
+// FNV-1a, 64 bits make accidental collisions between programs of one application practically impossible
+static uint64_t hashString(uint64_t hash, const string& text) noexcept {
+    for (auto& c : text) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+
+    // separates the strings, so that moving text from one source to the next changes the hash
+    hash ^= 0xff;
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+static string getDriverString(const GLenum& name) {
+    const GLubyte* value = glGetString(name);
+    return value != nullptr ? string((const char*)value) : string();
+}
+
+ProgramCache::ProgramCache(const string& directory):
+    directory(directory),
+    driver(getDriverString(GL_VENDOR) + "\n" + getDriverString(GL_RENDERER) + "\n" + getDriverString(GL_VERSION)) {
+}
+
+string ProgramCache::getPath(const vector<string>& sources) const {
+    uint64_t hash = hashString(14695981039346656037ull, driver);
+
+    for (auto& source : sources) {
+        hash = hashString(hash, source);
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    string name(16, '0');
+
+    for (size_t i = 0; i < 16; i++) {
+        name[15 - i] = digits[(hash >> (i * 4)) & 0xf];
+    }
+
+    return directory + "/" + name + ".bin";
+}
+
+bool ProgramCache::load(const vector<string>& sources, const GLuint& program) {
+    const auto start = chrono::steady_clock::now();
+    ifstream file(getPath(sources), ios::binary);
+
+    double storedCompileMilliseconds = 0.0;
+    GLenum format = 0;
+    GLint length = 0;
+    vector<char> binary;
+
+    if (file.read((char*)&storedCompileMilliseconds, sizeof(storedCompileMilliseconds)) &&
+        file.read((char*)&format, sizeof(format)) && file.read((char*)&length, sizeof(length)) && length > 0) {
+        binary.resize(length);
+        file.read(binary.data(), length);
+    }
+
+    if (binary.empty() || !file) {
+        missCount++;
+        return false;
+    }
+
+    glProgramBinary(program, format, binary.data(), length);
+
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+    if (!success) {
+        rejectedCount++;
+        missCount++;
+        return false;
+    }
+
+    const double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    hitCount++;
+    loadMilliseconds += milliseconds;
+    savedMilliseconds += storedCompileMilliseconds - milliseconds;
+    return true;
+}
+
+void ProgramCache::store(const vector<string>& sources, const GLuint& program, const double& compileMilliseconds) {
+    this->compileMilliseconds += compileMilliseconds;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0) {
+        return;
+    }
+
+    GLenum format = 0;
+    vector<char> binary(length);
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    // a cache that cannot be written only costs the next launch a compile
+    ofstream file(getPath(sources), ios::binary | ios::trunc);
+    file.write((const char*)&compileMilliseconds, sizeof(compileMilliseconds));
+    file.write((const char*)&format, sizeof(format));
+    file.write((const char*)&length, sizeof(length));
+    file.write(binary.data(), length);
+}
+
+const string& ProgramCache::getDirectory(void) const noexcept {
+    return directory;
+}
+
+const size_t& ProgramCache::getHitCount(void) const noexcept {
+    return hitCount;
+}
+
+const size_t& ProgramCache::getMissCount(void) const noexcept {
+    return missCount;
+}
+
+const size_t& ProgramCache::getRejectedCount(void) const noexcept {
+    return rejectedCount;
+}
+
+const double& ProgramCache::getLoadMilliseconds(void) const noexcept {
+    return loadMilliseconds;
+}
+
+const double& ProgramCache::getCompileMilliseconds(void) const noexcept {
+    return compileMilliseconds;
+}
+
+const double& ProgramCache::getSavedMilliseconds(void) const noexcept {
+    return savedMilliseconds;
+}
+
+ostream& operator<< (ostream& out, const ProgramCache& programCache) {
+    out << "Program Cache directory: " << programCache.getDirectory() << endl;
+    out << "Program Cache hits: " << programCache.getHitCount() << endl;
+    out << "Program Cache misses: " << programCache.getMissCount() << endl;
+    out << "Program Cache rejected: " << programCache.getRejectedCount() << endl;
+    out << "Program Cache load ms: " << programCache.getLoadMilliseconds() << endl;
+    out << "Program Cache compile ms: " << programCache.getCompileMilliseconds() << endl;
+    out << "Program Cache saved ms: " << programCache.getSavedMilliseconds() << endl;
+
+    return out;
+}
@@ -0,0 +1,314 @@
+#include <RenderQueue.hpp>
+
+// cpp
+#include <cstring>
+
+uint64_t RenderQueue::makeKey(const unsigned& pass, const unsigned& shader, const unsigned& material, const unsigned& vertexArray, const unsigned& geometry, const float& depth) noexcept {
+    // positive floats order like their bit patterns, so the top bits below the sign make a depth key
+    uint32_t depthBits = 0;
+    if (depth > 0.f) {
+        memcpy(&depthBits, &depth, sizeof(float));
+    }
+
+    uint64_t key = pass & ((1u << PASS_BITS) - 1);
+    key = (key << SHADER_BITS) | (shader & ((1u << SHADER_BITS) - 1));
+    key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+    key = (key << VERTEX_ARRAY_BITS) | (vertexArray & ((1u << VERTEX_ARRAY_BITS) - 1));
+    key = (key << GEOMETRY_BITS) | (geometry & ((1u << GEOMETRY_BITS) - 1));
+    key = (key << DEPTH_BITS) | (depthBits >> (31 - DEPTH_BITS));
+    return key;
+}
+
+void RenderQueue::clear(void) noexcept {
+    packets.clear();
+    programIndices.clear();
+    vertexArrayIndices.clear();
+    geometryIndices.clear();
+    lastProgramIndex = make_pair(0u, ~0u);
+    lastVertexArrayIndex = make_pair(0u, ~0u);
+    lastGeometryIndex = make_pair((const void*)nullptr, ~0u);
+}
+
+unsigned RenderQueue::getProgramIndex(const GLuint& program) {
+    if (lastProgramIndex.second == ~0u || lastProgramIndex.first != program) {
+        lastProgramIndex = *programIndices.emplace(program, (unsigned)programIndices.size()).first;
+    }
+
+    return lastProgramIndex.second;
+}
+
+unsigned RenderQueue::getVertexArrayIndex(const GLuint& vertexArray) {
+    if (lastVertexArrayIndex.second == ~0u || lastVertexArrayIndex.first != vertexArray) {
+        lastVertexArrayIndex = *vertexArrayIndices.emplace(vertexArray, (unsigned)vertexArrayIndices.size()).first;
+    }
+
+    return lastVertexArrayIndex.second;
+}
+
+unsigned RenderQueue::getGeometryIndex(const void* geometry) {
+    if (lastGeometryIndex.second == ~0u || lastGeometryIndex.first != geometry) {
+        lastGeometryIndex = *geometryIndices.emplace(geometry, (unsigned)geometryIndices.size()).first;
+    }
+
+    return lastGeometryIndex.second;
+}
+
+void RenderQueue::push(
+    const uint64_t& key,
+    const SceneObject* sceneObject,
+    const CachedTransform* worldTransform,
+    const void* batch,
+    const GLuint& program,
+    const GLuint& vertexArray
+) {
+    DrawPacket packet;
+    packet.key = key;
+    packet.sceneObject = sceneObject;
+    packet.worldTransform = worldTransform;
+    packet.batch = batch;
+    packet.program = program;
+    packet.vertexArray = vertexArray;
+    packets.push_back(packet);
+}
+
+void RenderQueue::sort(void) {
+    // least significant digit radix sort on bytes, stable so equal keys keep traversal order
+    sortBuffer.resize(packets.size());
+
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256] = { 0 };
+
+        for (auto& packet : packets) {
+            offsets[(packet.key >> shift) & 0xff]++;
+        }
+
+        // a byte shared by every key does not reorder anything
+        if (offsets[(packets.empty() ? 0 : packets[0].key >> shift) & 0xff] == packets.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto& count : offsets) {
+            const size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (auto& packet : packets) {
+            sortBuffer[offsets[(packet.key >> shift) & 0xff]++] = packet;
+        }
+
+        packets.swap(sortBuffer);
+    }
+}
+
+void RenderQueue::submit(const mat4& ProjectionViewMatrix) {
+    // state left behind by whoever drew before is unknown, so the first packet always binds
+    resetBindings();
+    bindCount = 0;
+    skippedBindCount = 0;
+    drawCount = 0;
+    commandCount = 0;
+
+    for (size_t begin = 0; begin < packets.size();) {
+        const DrawPacket& first = packets[begin];
+        size_t end = begin + 1;
+
+        if (first.batch == nullptr) {
+            first.sceneObject->submit(*this, ProjectionViewMatrix, *first.worldTransform);
+            drawCount++;
+        } else {
+            // geometry and depth are the only parts of the key allowed to differ inside a batch, the state itself is compared as well
+            const uint64_t state = first.key >> (GEOMETRY_BITS + DEPTH_BITS);
+            while (end < packets.size() && packets[end].batch == first.batch && (packets[end].key >> (GEOMETRY_BITS + DEPTH_BITS)) == state &&
+                packets[end].program == first.program && packets[end].vertexArray == first.vertexArray) {
+                end++;
+            }
+
+            submitBatch(ProjectionViewMatrix, begin, end);
+        }
+
+        begin = end;
+    }
+
+    glBindVertexArray(0);
+    boundVertexArray = 0;
+}
+
+void RenderQueue::submitBatch(const mat4& ProjectionViewMatrix, const size_t& begin, const size_t& end) {
+    const DrawPacket& first = packets[begin];
+    DrawElementsIndirectCommand command;
+    mat4 model;
+
+    instanceModels.clear();
+
+    if (!first.sceneObject->getIndirectDraw(*first.worldTransform, command, model)) {
+        drawCount++;
+
+        if (worldMatrixIndexing) {
+            first.sceneObject->submitObjects(*this, ProjectionViewMatrix, (GLuint)begin, (GLsizei)(end - begin));
+            return;
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            instanceModels.push_back(packets[i].worldTransform->getMatrix());
+        }
+
+        first.sceneObject->submitInstances(*this, ProjectionViewMatrix, instanceModels);
+        return;
+    }
+
+    // model matrices are read by instance, baseInstance points each command at its own,
+    // either in the instance matrices uploaded here or in the world matrix buffer
+    drawCommands.clear();
+    size_t commandsBegin = begin;
+
+    for (size_t i = begin; i < end; i++) {
+        if (i > begin && !packets[i].sceneObject->getIndirectDraw(*packets[i].worldTransform, command, model)) {
+            // the packet closes the commands gathered so far and is drawn on its own, later packets start new commands
+            submitCommands(ProjectionViewMatrix, commandsBegin);
+            submitSingle(ProjectionViewMatrix, i);
+            commandsBegin = i + 1;
+            continue;
+        }
+
+        if (worldMatrixIndexing) {
+            command.baseInstance = (GLuint)i;
+        } else {
+            command.baseInstance = (GLuint)instanceModels.size();
+            instanceModels.push_back(model);
+        }
+
+        // neighbouring draws of the same geometry become instances of one command
+        if (!drawCommands.empty()) {
+            DrawElementsIndirectCommand& previous = drawCommands.back();
+
+            if (previous.firstIndex == command.firstIndex && previous.baseVertex == command.baseVertex && previous.count == command.count &&
+                previous.baseInstance + previous.instanceCount == command.baseInstance) {
+                previous.instanceCount++;
+                continue;
+            }
+        }
+
+        drawCommands.push_back(command);
+    }
+
+    submitCommands(ProjectionViewMatrix, commandsBegin);
+}
+
+void RenderQueue::submitCommands(const mat4& ProjectionViewMatrix, const size_t& first) {
+    if (drawCommands.empty()) {
+        return;
+    }
+
+    // any packet of the batch may draw the commands, they share program, vertex array and batch
+    commandCount += drawCommands.size();
+    drawCount++;
+    packets[first].sceneObject->submitIndirect(*this, ProjectionViewMatrix, drawCommands, instanceModels);
+    drawCommands.clear();
+    instanceModels.clear();
+}
+
+void RenderQueue::submitSingle(const mat4& ProjectionViewMatrix, const size_t& packet) {
+    const DrawPacket& single = packets[packet];
+    instanceModels.clear();
+    drawCount++;
+
+    if (worldMatrixIndexing) {
+        single.sceneObject->submitObjects(*this, ProjectionViewMatrix, (GLuint)packet, 1);
+    } else {
+        instanceModels.push_back(single.worldTransform->getMatrix());
+        single.sceneObject->submitInstances(*this, ProjectionViewMatrix, instanceModels);
+        instanceModels.clear();
+    }
+}
+
+void RenderQueue::useProgram(const Shader& shader) {
+    if (boundProgram == shader.getId()) {
+        skippedBindCount++;
+        return;
+    }
+
+    shader.use();
+    boundProgram = shader.getId();
+    bindCount++;
+}
+
+void RenderQueue::bindVertexArray(const GLuint& vertexArray) {
+    if (boundVertexArray == vertexArray) {
+        skippedBindCount++;
+        return;
+    }
+
+    glBindVertexArray(vertexArray);
+    boundVertexArray = vertexArray;
+    bindCount++;
+}
+
+void RenderQueue::resetBindings(void) noexcept {
+    boundProgram = 0;
+    boundVertexArray = 0;
+}
+
+const size_t& RenderQueue::getDrawCount(void) const noexcept {
+    return drawCount;
+}
+
+const size_t& RenderQueue::getCommandCount(void) const noexcept {
+    return commandCount;
+}
+
+void RenderQueue::writeModelMatrices(mat4* models) const noexcept {
+    for (auto& packet : packets) {
+        *models++ = packet.sceneObject->getModelMatrix(*packet.worldTransform);
+    }
+}
+
+void RenderQueue::writeDualQuaternions(vec4* packed, const bool& uniformScale) const noexcept {
+    fdualquat translationAndRotation;
+    vec3 scale;
+
+    if (uniformScale) {
+        for (auto& packet : packets) {
+            packet.sceneObject->getModelDualQuaternion(*packet.worldTransform, translationAndRotation, scale);
+            packScaledDualQuaternion(translationAndRotation, scale.x, packed);
+            packed += 2;
+        }
+    } else {
+        for (auto& packet : packets) {
+            packet.sceneObject->getModelDualQuaternion(*packet.worldTransform, translationAndRotation, scale);
+            packDualQuaternionScale(translationAndRotation, scale, packed);
+            packed += 3;
+        }
+    }
+}
+
+void RenderQueue::setWorldMatrixIndexing(const bool& worldMatrixIndexing) noexcept {
+    this->worldMatrixIndexing = worldMatrixIndexing;
+}
+
+const bool& RenderQueue::isWorldMatrixIndexing(void) const noexcept {
+    return worldMatrixIndexing;
+}
+
+size_t RenderQueue::size(void) const noexcept {
+    return packets.size();
+}
+
+const size_t& RenderQueue::getBindCount(void) const noexcept {
+    return bindCount;
+}
+
+const size_t& RenderQueue::getSkippedBindCount(void) const noexcept {
+    return skippedBindCount;
+}
+
+ostream& operator<< (ostream& out, const RenderQueue& renderQueue) {
+    out << "Render Queue packets: " << renderQueue.size() << endl;
+    out << "Render Queue draws: " << renderQueue.getDrawCount() << endl;
+    out << "Render Queue indirect commands: " << renderQueue.getCommandCount() << endl;
+    out << "Render Queue binds: " << renderQueue.getBindCount() << endl;
+    out << "Render Queue skipped binds: " << renderQueue.getSkippedBindCount() << endl;
+
+    return out;
+}
@@ -0,0 +1,118 @@
+#include <SceneCommandQueue.hpp>
+
+SceneCommandQueue::Command::Command(const Type& type, const shared_ptr<SceneObject>& sceneObject):
+    type(type),
+    sceneObject(sceneObject) {
+}
+
+SceneCommandQueue::SceneCommandQueue(void):
+    head(nullptr) {
+}
+
+SceneCommandQueue::~SceneCommandQueue(void) {
+    for (Command* command = head.exchange(nullptr); command != nullptr;) {
+        Command* next = command->next;
+        delete command;
+        command = next;
+    }
+}
+
+void SceneCommandQueue::push(Command* command) noexcept {
+    command->next = head.load(memory_order_relaxed);
+
+    while (!head.compare_exchange_weak(command->next, command, memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+void SceneCommandQueue::appendChild(const shared_ptr<SceneObject>& parent, const shared_ptr<SceneObject>& child) {
+    Command* command = new Command(APPEND_CHILD, child);
+    command->parent = parent;
+    push(command);
+}
+
+void SceneCommandQueue::removeChild(const shared_ptr<SceneObject>& parent, const shared_ptr<SceneObject>& child) {
+    Command* command = new Command(REMOVE_CHILD, child);
+    command->parent = parent;
+    push(command);
+}
+
+void SceneCommandQueue::reparent(const shared_ptr<SceneObject>& sceneObject, const shared_ptr<SceneObject>& parent) {
+    Command* command = new Command(REPARENT, sceneObject);
+    command->parent = parent;
+    push(command);
+}
+
+void SceneCommandQueue::rename(const shared_ptr<SceneObject>& sceneObject, const string& name) {
+    Command* command = new Command(RENAME, sceneObject);
+    command->name = name;
+    push(command);
+}
+
+void SceneCommandQueue::setTransform(const shared_ptr<SceneObject>& sceneObject, const Transform& transform) {
+    Command* command = new Command(SET_TRANSFORM, sceneObject);
+    command->transform = transform;
+    push(command);
+}
+
+size_t SceneCommandQueue::apply(void) {
+    Command* newest = head.exchange(nullptr, memory_order_acquire);
+
+    // back into recording order
+    Command* oldest = nullptr;
+    while (newest != nullptr) {
+        Command* next = newest->next;
+        newest->next = oldest;
+        oldest = newest;
+        newest = next;
+    }
+
+    size_t count = 0;
+
+    for (Command* command = oldest; command != nullptr; count++) {
+        SceneObject* currentParent = command->sceneObject->getParent();
+
+        switch (command->type) {
+        case APPEND_CHILD:
+            command->parent->appendChild(command->sceneObject);
+            break;
+        case REMOVE_CHILD:
+            command->parent->removeChild(command->sceneObject);
+            break;
+        case REPARENT:
+            if (command->parent != nullptr) {
+                command->parent->appendChild(command->sceneObject);
+            } else if (currentParent != nullptr) {
+                currentParent->removeChild(command->sceneObject);
+            }
+            break;
+        case RENAME:
+            command->sceneObject->setName(command->name);
+            break;
+        case SET_TRANSFORM:
+            command->sceneObject->setTransform(command->transform);
+            break;
+        }
+
+        Command* next = command->next;
+        delete command;
+        command = next;
+    }
+
+    appliedCount += count;
+    return count;
+}
+
+bool SceneCommandQueue::empty(void) const noexcept {
+    return head.load(memory_order_relaxed) == nullptr;
+}
+
+const size_t& SceneCommandQueue::getAppliedCount(void) const noexcept {
+    return appliedCount;
+}
+
+ostream& operator<< (ostream& out, const SceneCommandQueue& sceneCommandQueue) {
+    out << "Scene Command Queue pending: " << (sceneCommandQueue.empty() ? "no" : "yes") << endl;
+    out << "Scene Command Queue applied: " << sceneCommandQueue.getAppliedCount() << endl;
+
+    return out;
+}
@@ -1,37 +1,533 @@
 #include <SceneGraph.hpp>
+#include <JobSystem.hpp>
+#include <GLDeletionQueue.hpp>
+
+// cpp
+#include <cfloat>
+#include <tuple>
+#include <algorithm>
 
 SceneGraph::SceneGraph(const shared_ptr<SceneObject>& root):
-    root(root) {
+    root(root),
+    index(make_shared<SceneIndex>()) {
+    if (root != nullptr) {
+        index->insert(root);
+    }
+}
+
+SceneGraph::~SceneGraph(void) {
+    vector<shared_ptr<SceneObject>> survivors;
+
+    if (root != nullptr) {
+        findSurvivors(root, 1, survivors);
+    }
+
+    // survivors take their world transforms along and stop referring to the structures released below.
+    // the flat arrays, the namesakes and the children of every parent are each gone through once
+    if (!survivors.empty()) {
+        if (hierarchy != nullptr) {
+            hierarchy->clear();
+        }
+
+        index->erase(survivors);
+        vector<SceneObject*> parents;
+
+        for (auto& survivor : survivors) {
+            if (survivor->parent != nullptr) {
+                parents.push_back(survivor->parent);
+                survivor->setParent(nullptr);
+            }
+        }
+
+        sort(parents.begin(), parents.end());
+        parents.erase(unique(parents.begin(), parents.end()), parents.end());
+
+        for (auto& parent : parents) {
+            parent->children.erase(remove_if(parent->children.begin(), parent->children.end(), [parent](const shared_ptr<SceneObject>& child) {
+                return child->parent != parent;
+            }), parent->children.end());
+
+            for (size_t i = 0; i < parent->children.size(); i++) {
+                parent->children[i]->childIndex = i;
+            }
+        }
+    }
+
+    // held through one more pointer, so copies of the task made on this thread never own the objects.
+    // released in reverse declaration order, as the members would be
+    auto released = make_shared<tuple<
+        shared_ptr<SceneObject>,
+        shared_ptr<SceneHierarchy>,
+        shared_ptr<SceneIndex>,
+        shared_ptr<BoundingVolumeHierarchy>,
+        shared_ptr<SceneSnapshotBuffer>
+    >>(std::move(root), std::move(hierarchy), std::move(index), std::move(boundingVolumeHierarchy), std::move(snapshotBuffer));
+
+    // after the releases still running. unless the root survives, nothing outside refers to the remaining
+    // objects any more, so they are torn down as a released subtree
+    releaseInBackground([released](void) {
+        if (get<0>(*released).use_count() == 1) {
+            get<0>(*released)->markReleased();
+        }
+
+        get<4>(*released) = nullptr;
+        get<3>(*released) = nullptr;
+        get<2>(*released) = nullptr;
+        get<1>(*released) = nullptr;
+        get<0>(*released) = nullptr;
+    });
+}
+
+void SceneGraph::releaseInBackground(const function<void(void)>& release) const {
+    // created ahead of the shared job system, so it is destroyed after the workers are joined
+    GLDeletionQueue::getShared();
+
+    // with GL deletions routed back to the GL thread
+    lastRelease = JobSystem::getShared().run([release](void) {
+        GLDeletionQueue::setDeferring(true);
+        release();
+        GLDeletionQueue::setDeferring(false);
+    }, lastRelease != nullptr ? vector<shared_ptr<JobSystem::Job>>(1, lastRelease) : vector<shared_ptr<JobSystem::Job>>());
+}
+
+void SceneGraph::releaseIndexNodes(void) const {
+    auto released = make_shared<vector<shared_ptr<SceneObject>>>();
+    index->flushReleases(*released);
+
+    if (!released->empty()) {
+        releaseInBackground([released](void) {
+            released->clear();
+        });
+    }
+}
+
+void SceneGraph::releaseHierarchyNodes(void) const {
+    if ((hierarchy->getReleasedCount() + hierarchy->getMisplacedCount()) * 4 > hierarchy->size()) {
+        hierarchy->compact();
+    }
+
+    // removing nodes drops released ranges inside them as well
+    auto released = make_shared<vector<shared_ptr<SceneObject>>>(hierarchy->takeReleased());
+
+    if (!released->empty()) {
+        releaseInBackground([released](void) {
+            released->clear();
+        });
+    }
+}
+
+void SceneGraph::findSurvivors(const shared_ptr<SceneObject>& sceneObject, const long& owners, vector<shared_ptr<SceneObject>>& survivors) const {
+    // references the scene holds, anything beyond them comes from outside
+    long expected = owners;
+
+    if (sceneObject->index == index.get()) {
+        expected++;
+    }
+
+    if (sceneObject->hierarchy != nullptr) {
+        expected++;
+    }
+
+    if (snapshotBuffer != nullptr) {
+        expected += (long)snapshotBuffer->getReferenceCount(sceneObject.get());
+    }
+
+    if (sceneObject.use_count() > expected) {
+        survivors.push_back(sceneObject);
+        return;
+    }
+
+    for (auto& child : sceneObject->getChildren()) {
+        findSurvivors(child, 1, survivors);
+    }
+}
+
+void SceneGraph::destroySceneObject(shared_ptr<SceneObject> sceneObject) {
+    if (sceneObject == nullptr || sceneObject->released) {
+        return;
+    }
+
+    // the root, or an object this scene does not index, is detached the usual way and torn down on a worker
+    if (sceneObject == root || sceneObject->index != index.get()) {
+        if (sceneObject->getParent() != nullptr) {
+            sceneObject->getParent()->removeChild(sceneObject);
+        } else {
+            index->erase(sceneObject);
+        }
+
+        auto released = make_shared<shared_ptr<SceneObject>>(std::move(sceneObject));
+
+        releaseInBackground([released](void) {
+            if (released->use_count() == 1) {
+                (*released)->markReleased();
+            }
+
+            *released = nullptr;
+        });
+
+        return;
+    }
+
+    // the last sibling takes the place of the destroyed object
+    SceneObject* parent = sceneObject->parent;
+
+    if (parent != nullptr) {
+        const size_t childIndex = sceneObject->childIndex;
+        parent->children[childIndex] = std::move(parent->children.back());
+        parent->children[childIndex]->childIndex = childIndex;
+        parent->children.pop_back();
+        parent->markBoundsDirty();
+        sceneObject->parent = nullptr;
+    }
+
+    if (sceneObject->hierarchy != nullptr) {
+        sceneObject->hierarchy->releaseNode(sceneObject->hierarchyNode);
+    } else {
+        sceneObject->markReleased();
+    }
+
+    index->release(std::move(sceneObject));
+}
+
+void SceneGraph::waitForReleases(void) const {
+    releaseIndexNodes();
+
+    if (lastRelease != nullptr) {
+        JobSystem::getShared().wait(lastRelease);
+    }
+}
+
+size_t SceneGraph::applyCommands(void) {
+    return commandQueue.apply();
+}
+
+SceneCommandQueue& SceneGraph::getCommandQueue(void) noexcept {
+    return commandQueue;
+}
+
+void SceneGraph::propagateTransforms(const size_t& threadCount, JobSystem* jobSystem) const {
+    releaseIndexNodes();
+
+    if (hierarchy != nullptr) {
+        releaseHierarchyNodes();
+
+        if (jobSystem != nullptr) {
+            hierarchy->propagateTransforms(threadCount, *jobSystem);
+        } else {
+            hierarchy->propagateTransforms();
+        }
+    } else if (jobSystem != nullptr) {
+        root->propagateTransform(threadCount, *jobSystem);
+    } else {
+        root->propagateTransform();
+    }
+
+    if (boundingVolumeHierarchy != nullptr) {
+        boundingVolumeHierarchy->update();
+    }
+}
+
+void SceneGraph::propagateTransforms(const size_t& threadCount) const {
+    // the shared job system is only started once work is handed to other threads
+    propagateTransforms(threadCount, threadCount > 1 ? &JobSystem::getShared() : nullptr);
+}
+
+void SceneGraph::propagateTransforms(JobSystem& jobSystem) const {
+    propagateTransforms(jobSystem.getWorkerCount() + 1, &jobSystem);
 }
 
 void SceneGraph::draw(const mat4& ProjectionViewMatrix) const noexcept {
-    root->draw(ProjectionViewMatrix);
+    drawVisible(ProjectionViewMatrix, cull(ProjectionViewMatrix));
+}
+
+void SceneGraph::draw(const SceneSnapshot& snapshot, const mat4& ProjectionViewMatrix) const noexcept {
+    drawVisible(ProjectionViewMatrix, cull(snapshot, ProjectionViewMatrix));
+}
+
+void SceneGraph::drawVisible(const mat4& ProjectionViewMatrix, const vector<pair<const SceneObject*, const CachedTransform*>>& visible) const {
+    renderQueue.clear();
+    renderQueue.setWorldMatrixIndexing(worldMatrixBuffer != nullptr);
+
+    for (auto& visibleObject : visible) {
+        visibleObject.first->enqueue(renderQueue, ProjectionViewMatrix, *visibleObject.second);
+    }
+
+    renderQueue.sort();
+
+    // matrices follow the sorted packets, so each batch reads a contiguous range of the buffer
+    if (worldMatrixBuffer != nullptr) {
+        worldMatrixBuffer->write(renderQueue);
+    }
+
+    renderQueue.submit(ProjectionViewMatrix);
+
+    if (worldMatrixBuffer != nullptr) {
+        worldMatrixBuffer->fence();
+    }
+
+    // frame end, what background destruction released
+    GLDeletionQueue::getShared().flush();
+}
+
+const vector<pair<const SceneObject*, const CachedTransform*>>& SceneGraph::cull(const mat4& ProjectionViewMatrix) const {
+    // released objects leave the bounding volume hierarchy here as well
+    propagateTransforms();
+
+    const Frustum frustum(ProjectionViewMatrix);
+    clearCandidates();
+
+    // the hierarchy holds every object of the scene, so only those its query returns are visited.
+    // leaves carry the world bounds of their object, whose world transform is only looked up once visible
+    if (boundingVolumeHierarchy != nullptr) {
+        queriedLeaves.clear();
+        boundingVolumeHierarchy->query(frustum, queriedLeaves);
+        prunedCount = boundingVolumeHierarchy->size() - queriedLeaves.size();
+
+        for (auto& leaf : queriedLeaves) {
+            addCandidate(boundingVolumeHierarchy->getSceneObject(leaf), nullptr, boundingVolumeHierarchy->getWorldBounds(leaf));
+        }
+
+        queriedObjects.clear();
+        boundingVolumeHierarchy->queryUnbounded(queriedObjects);
+
+        for (auto& sceneObject : queriedObjects) {
+            addCandidate(sceneObject, &sceneObject->getWorldTransform());
+        }
+    } else if (hierarchy != nullptr) {
+        gatherCandidates(*hierarchy, frustum);
+    } else if (root != nullptr) {
+        gatherCandidates(root.get(), frustum);
+    }
+
+    return testCandidates(frustum);
+}
+
+const vector<pair<const SceneObject*, const CachedTransform*>>& SceneGraph::cull(const SceneSnapshot& snapshot, const mat4& ProjectionViewMatrix) const {
+    const Frustum frustum(ProjectionViewMatrix);
+    clearCandidates();
+
+    const vector<SceneSnapshot::Entry>& entries = snapshot.getEntries();
+    queriedSlots.clear();
+
+    if (snapshot.query(frustum, queriedSlots)) {
+        prunedCount = snapshot.getBoundedCount() - queriedSlots.size();
+        queriedSlots.insert(queriedSlots.end(), snapshot.getUnboundedSlots().begin(), snapshot.getUnboundedSlots().end());
+
+        for (auto& slot : queriedSlots) {
+            addCandidate(entries[slot].sceneObject.get(), &entries[slot].worldTransform, entries[slot].worldBounds);
+        }
+    } else {
+        // slot order, the render queue sorts what matters for drawing anyway
+        for (auto& entry : entries) {
+            if (entry.sceneObject != nullptr) {
+                addCandidate(entry.sceneObject.get(), &entry.worldTransform, entry.worldBounds);
+            }
+        }
+    }
+
+    return testCandidates(frustum);
 }
 
-shared_ptr<SceneObject> SceneGraph::getSceneObject(const string& name) const noexcept {
-    return getSceneObject(name, root);
+void SceneGraph::clearCandidates(void) const noexcept {
+    prunedCount = 0;
+    candidates.clear();
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
 }
 
-shared_ptr<SceneObject> SceneGraph::getSceneObject(const string& name, const shared_ptr<SceneObject>& sceneObject) const noexcept {
-    if (sceneObject->getName() == name) {
-        return sceneObject;
+const vector<pair<const SceneObject*, const CachedTransform*>>& SceneGraph::testCandidates(const Frustum& frustum) const {
+    visibility.resize(candidates.size());
+    const size_t visibleTotal = frustum.intersects(
+        centerX.data(),
+        centerY.data(),
+        centerZ.data(),
+        radius.data(),
+        candidates.size(),
+        visibility.data()
+    );
+
+    // candidates stay in traversal order so drawing order is unchanged
+    visibleObjects.clear();
+    size_t unboundedCount = 0;
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (visibility[i] && candidates[i].second != nullptr) {
+            visibleObjects.push_back(candidates[i]);
+        } else if (visibility[i]) {
+            visibleObjects.push_back(make_pair(candidates[i].first, &candidates[i].first->getWorldTransform()));
+        }
+
+        if (radius[i] == FLT_MAX) {
+            unboundedCount++;
+        }
     }
 
-    for (size_t i = 0; i < sceneObject->getChildren().size(); i++) {
-        shared_ptr<SceneObject> foundChild = getSceneObject(name, sceneObject->getChildren()[i]);
+    culledCount = candidates.size() - visibleTotal + prunedCount;
+    visibleCount = visibleTotal - unboundedCount;
+
+    return visibleObjects;
+}
+
+void SceneGraph::gatherCandidates(const SceneObject* sceneObject, const Frustum& frustum) const {
+    // a whole branch outside the frustum is rejected with a single test,
+    // objects without bounds inside it go along with it
+    BoundingSphere subtreeBounds;
+
+    if (sceneObject->getSubtreeBounds(subtreeBounds) && !frustum.intersects(subtreeBounds)) {
+        prunedCount += sceneObject->getSubtreeBoundedCount();
+        return;
+    }
+
+    addCandidate(sceneObject, &sceneObject->getWorldTransform());
+
+    for (auto& child : sceneObject->getChildren()) {
+        gatherCandidates(child.get(), frustum);
+    }
+}
+
+void SceneGraph::gatherCandidates(const SceneHierarchy& sceneHierarchy, const Frustum& frustum) const {
+    // the same pruning over the flat storage, a rejected subtree is skipped as one contiguous range
+    const bool misplaced = sceneHierarchy.getMisplacedCount() > 0;
+
+    for (size_t i = 0; i < sceneHierarchy.size();) {
+        const SceneObject* sceneObject = sceneHierarchy.getSceneObject(i).get();
+        BoundingSphere subtreeBounds;
+
+        if (sceneHierarchy.isReleased(i)) {
+            i += sceneHierarchy.getSubtreeSize(i);
+        } else if (misplaced && sceneHierarchy.isMisplaced(i) && isPruned(sceneObject->getParent(), frustum)) {
+            // counted already by the ancestor that was rejected
+            i += sceneHierarchy.getSubtreeSize(i);
+        } else if (sceneObject->getSubtreeBounds(subtreeBounds) && !frustum.intersects(subtreeBounds)) {
+            prunedCount += sceneObject->getSubtreeBoundedCount();
+            i += sceneHierarchy.getSubtreeSize(i);
+        } else {
+            addCandidate(sceneObject, &sceneHierarchy.getWorldTransform(i));
+            i++;
+        }
+    }
+}
+
+bool SceneGraph::isPruned(const SceneObject* sceneObject, const Frustum& frustum) const noexcept {
+    // the range of a misplaced subtree is not skipped along with the ranges of its ancestors
+    for (; sceneObject != nullptr; sceneObject = sceneObject->getParent()) {
+        BoundingSphere subtreeBounds;
 
-        if (foundChild != nullptr) {
-            return foundChild;
+        if (sceneObject->released || (sceneObject->getSubtreeBounds(subtreeBounds) && !frustum.intersects(subtreeBounds))) {
+            return true;
         }
     }
 
-    return nullptr;
+    return false;
+}
+
+void SceneGraph::addCandidate(const SceneObject* sceneObject, const CachedTransform* worldTransform) const {
+    BoundingSphere boundingSphere;
+
+    if (sceneObject->getBoundingSphere(boundingSphere)) {
+        boundingSphere = boundingSphere.transform(*worldTransform);
+    } else {
+        // objects without bounds are always drawn
+        boundingSphere = BoundingSphere(vec3(0.f, 0.f, 0.f), FLT_MAX);
+    }
+
+    addCandidate(sceneObject, worldTransform, boundingSphere);
+}
+
+void SceneGraph::addCandidate(const SceneObject* sceneObject, const CachedTransform* worldTransform, const BoundingSphere& worldBounds) const {
+    candidates.push_back(make_pair(sceneObject, worldTransform));
+    centerX.push_back(worldBounds.getCenter().x);
+    centerY.push_back(worldBounds.getCenter().y);
+    centerZ.push_back(worldBounds.getCenter().z);
+    radius.push_back(worldBounds.getRadius());
+}
+
+const shared_ptr<SceneObject>& SceneGraph::getSceneObject(const string& name) const noexcept {
+    return index->find(name);
 }
 
 const shared_ptr<SceneObject>& SceneGraph::getRoot(void) const noexcept {
     return root;
 }
 
+void SceneGraph::flatten(void) {
+    if (hierarchy == nullptr) {
+        hierarchy = make_shared<SceneHierarchy>();
+        hierarchy->setIndex(index.get());
+    }
+
+    hierarchy->build(root);
+}
+
+const shared_ptr<SceneHierarchy>& SceneGraph::getHierarchy(void) const noexcept {
+    return hierarchy;
+}
+
+void SceneGraph::buildBoundingVolumeHierarchy(void) {
+
+    // a new hierarchy is built once with every object of the index, an existing one is rebuilt in place
+    if (boundingVolumeHierarchy == nullptr) {
+        boundingVolumeHierarchy = make_shared<BoundingVolumeHierarchy>();
+        index->setBoundingVolumeHierarchy(boundingVolumeHierarchy.get());
+        boundingVolumeHierarchy->setChangeTracking(snapshotBuffer != nullptr);
+    } else {
+        boundingVolumeHierarchy->rebuild();
+    }
+}
+
+const shared_ptr<BoundingVolumeHierarchy>& SceneGraph::getBoundingVolumeHierarchy(void) const noexcept {
+    return boundingVolumeHierarchy;
+}
+
+const size_t& SceneGraph::getVisibleCount(void) const noexcept {
+    return visibleCount;
+}
+
+const size_t& SceneGraph::getCulledCount(void) const noexcept {
+    return culledCount;
+}
+
+const RenderQueue& SceneGraph::getRenderQueue(void) const noexcept {
+    return renderQueue;
+}
+
+void SceneGraph::createWorldMatrixBuffer(const WorldMatrixBuffer::Layout& layout) {
+    if (worldMatrixBuffer == nullptr || worldMatrixBuffer->getLayout() != layout) {
+        worldMatrixBuffer = make_shared<WorldMatrixBuffer>(1024, layout);
+    }
+}
+
+const shared_ptr<WorldMatrixBuffer>& SceneGraph::getWorldMatrixBuffer(void) const noexcept {
+    return worldMatrixBuffer;
+}
+
+void SceneGraph::createSnapshotBuffer(void) {
+
+    if (snapshotBuffer == nullptr) {
+        snapshotBuffer = make_shared<SceneSnapshotBuffer>();
+        index->setSnapshotBuffer(snapshotBuffer.get());
+
+        // published snapshots carry a copy of the hierarchy to cull with
+        if (boundingVolumeHierarchy != nullptr) {
+            boundingVolumeHierarchy->setChangeTracking(true);
+        }
+    }
+}
+
+void SceneGraph::publishSnapshot(void) {
+    propagateTransforms();
+
+    if (snapshotBuffer != nullptr) {
+        snapshotBuffer->publish(boundingVolumeHierarchy.get());
+    }
+}
+
+const shared_ptr<SceneSnapshotBuffer>& SceneGraph::getSnapshotBuffer(void) const noexcept {
+    return snapshotBuffer;
+}
+
 ostream& operator<< (ostream& out, const SceneGraph& sceneGraph) {
     out << "Scene Graph:\nRoot node:\n";
 
@@ -0,0 +1,730 @@
+#include <SceneHierarchy.hpp>
+#include <SceneIndex.hpp>
+#include <Parallel.hpp>
+
+// cpp
+#include <iterator>
+
+const size_t SceneHierarchy::NO_PARENT;
+const size_t SceneHierarchy::MIN_PARALLEL_LEVEL_SIZE;
+
+// the values at the given indices in that order, the ones left out are dropped
+template <typename T>
+static void permute(vector<T>& values, const vector<size_t>& order) {
+    vector<T> permuted;
+    permuted.reserve(order.size());
+
+    for (auto& index : order) {
+        permuted.push_back(std::move(values[index]));
+    }
+
+    values.swap(permuted);
+}
+
+SceneHierarchy::SceneHierarchy(const shared_ptr<SceneObject>& root) {
+    build(root);
+}
+
+SceneHierarchy::~SceneHierarchy(void) {
+    clear();
+}
+
+void SceneHierarchy::build(const shared_ptr<SceneObject>& root) {
+    clear();
+
+    if (root != nullptr) {
+        appendSubtree(root);
+    }
+}
+
+void SceneHierarchy::clear(void) noexcept {
+    // every node lets go of its scene object before any scene object can be released
+    for (size_t i = 0; i < sceneObjects.size();) {
+        if (flags[i] & RELEASED) {
+            i = dropReleased(i);
+        } else {
+            detachNode(i);
+            i++;
+        }
+    }
+
+    localTransforms.clear();
+    worldTransforms.clear();
+    worldVersions.clear();
+    parentVersions.clear();
+    checkedEpochs.clear();
+    parents.clear();
+    subtreeSizes.clear();
+    flags.clear();
+    sceneObjects.clear();
+    releasedCount = 0;
+    misplacedCount = 0;
+    levelsDirty = true;
+    propagatedEpoch = 0;
+}
+
+size_t SceneHierarchy::appendNode(const shared_ptr<SceneObject>& sceneObject, const size_t& parent) {
+    vector<shared_ptr<SceneObject>> subtree(1, sceneObject);
+    return insertNodes(subtree, vector<size_t>(1, NO_PARENT), parent);
+}
+
+size_t SceneHierarchy::appendSubtree(const shared_ptr<SceneObject>& sceneObject, const size_t& parent) {
+    // depth first pre-order, the same order in which the pointer tree is drawn and searched
+    vector<shared_ptr<SceneObject>> subtree;
+    vector<size_t> subtreeParents;
+    vector<pair<const shared_ptr<SceneObject>*, size_t>> stack;
+    stack.push_back(make_pair(&sceneObject, NO_PARENT));
+
+    while (!stack.empty()) {
+        const shared_ptr<SceneObject>& node = *stack.back().first;
+        subtreeParents.push_back(stack.back().second);
+        subtree.push_back(node);
+        stack.pop_back();
+
+        const vector<shared_ptr<SceneObject>>& children = node->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); it++) {
+            stack.push_back(make_pair(&(*it), subtree.size() - 1));
+        }
+    }
+
+    return insertNodes(subtree, subtreeParents, parent);
+}
+
+size_t SceneHierarchy::insertNodes(vector<shared_ptr<SceneObject>>& subtree, const vector<size_t>& subtreeParents, const size_t& parent) {
+    for (auto& sceneObject : subtree) {
+        if (sceneObject->hierarchy == this) {
+            throw exception("Scene object is already a node of this hierarchy");
+        }
+    }
+
+    for (auto& sceneObject : subtree) {
+        if (sceneObject->hierarchy != nullptr) {
+            sceneObject->hierarchy->removeNode(sceneObject->hierarchyNode);
+        }
+    }
+
+    // the subtree goes to the end of the arrays. that is right behind the last descendant of its parent
+    // unless other nodes follow its range, which are left in place and the subtree is misplaced until compact
+    const size_t first = sceneObjects.size();
+    const size_t count = subtree.size();
+    const bool inPlace = parent == NO_PARENT || parent + subtreeSizes[parent] == first;
+
+    vector<size_t> newParents(count);
+    vector<size_t> newSizes(count, 1);
+
+    for (size_t i = count; i-- > 0;) {
+        newParents[i] = subtreeParents[i] != NO_PARENT ? first + subtreeParents[i] : parent;
+
+        if (subtreeParents[i] != NO_PARENT) {
+            newSizes[subtreeParents[i]] += newSizes[i];
+        }
+    }
+
+    if (inPlace) {
+        // ranges grow up to the root of a misplaced subtree, the range of its parent does not hold it
+        for (size_t ancestor = parent; ancestor != NO_PARENT; ancestor = parents[ancestor]) {
+            subtreeSizes[ancestor] += count;
+
+            const size_t& above = parents[ancestor];
+            if (above != NO_PARENT && ancestor >= above + subtreeSizes[above]) {
+                break;
+            }
+        }
+    } else {
+        misplacedCount += count;
+    }
+
+    localTransforms.resize(first + count);
+    worldTransforms.resize(first + count);
+    worldVersions.resize(first + count, 0);
+    parentVersions.resize(first + count, 0);
+    checkedEpochs.resize(first + count, 0);
+    parents.insert(parents.end(), newParents.begin(), newParents.end());
+    subtreeSizes.insert(subtreeSizes.end(), newSizes.begin(), newSizes.end());
+    flags.resize(first + count, 0);
+    sceneObjects.insert(sceneObjects.end(), make_move_iterator(subtree.begin()), make_move_iterator(subtree.end()));
+    levelsDirty = true;
+    propagatedEpoch = 0;
+
+    // the scene objects hand over their transforms as they are, dirty or not
+    for (size_t node = first; node < first + count; node++) {
+        SceneObject* sceneObject = sceneObjects[node].get();
+
+        localTransforms[node] = sceneObject->localTransform;
+        worldTransforms[node] = sceneObject->worldTransform;
+        worldVersions[node] = sceneObject->worldTransformVersion;
+        parentVersions[node] = sceneObject->parentTransformVersion;
+        flags[node] = (sceneObject->worldTransformDirty ? DIRTY : 0) | (sceneObject->isWorldTransformObserved() ? OBSERVED : 0);
+
+        sceneObject->hierarchy = this;
+        sceneObject->hierarchyNode = node;
+    }
+
+    return first;
+}
+
+void SceneHierarchy::removeNode(const size_t& index) {
+    // index may refer to the node of a scene object, which the detach below resets
+    vector<size_t> firsts;
+    gatherRanges(sceneObjects[index].get(), firsts);
+
+    // the removed nodes are detached first and their scene objects released last,
+    // so destructors find neither a child still referring to this hierarchy nor a half removed range
+    vector<shared_ptr<SceneObject>> removed;
+    removed.reserve(subtreeSizes[firsts.front()]);
+
+    for (auto& first : firsts) {
+        const size_t last = first + subtreeSizes[first];
+
+        for (size_t i = first; i < last;) {
+            if (flags[i] & RELEASED) {
+                i = dropReleased(i);
+            } else {
+                detachNode(i);
+                removed.push_back(std::move(sceneObjects[i]));
+                i++;
+            }
+        }
+
+        // nothing behind the range moves, it stays as a released range without scene objects
+        flags[first] |= RELEASED;
+        releasedCount += last - first;
+    }
+
+    // the levels are rebuilt without the ranges, nodes without a scene object are never propagated
+    levelsDirty = true;
+}
+
+void SceneHierarchy::gatherRanges(const SceneObject* sceneObject, vector<size_t>& firsts) const {
+    firsts.push_back(sceneObject->hierarchyNode);
+
+    // without misplaced nodes the range holds the whole subtree
+    if (misplacedCount == 0) {
+        return;
+    }
+
+    vector<const SceneObject*> stack(1, sceneObject);
+
+    while (!stack.empty()) {
+        const SceneObject* node = stack.back();
+        stack.pop_back();
+
+        for (auto& child : node->children) {
+            if (child->hierarchy == this && isMisplaced(child->hierarchyNode)) {
+                firsts.push_back(child->hierarchyNode);
+            }
+
+            stack.push_back(child.get());
+        }
+    }
+}
+
+void SceneHierarchy::detachNode(const size_t& index) noexcept {
+    SceneObject* sceneObject = sceneObjects[index].get();
+
+    sceneObject->localTransform = localTransforms[index];
+    sceneObject->worldTransform = worldTransforms[index];
+    sceneObject->worldTransformDirty = (flags[index] & DIRTY) != 0;
+    sceneObject->worldTransformVersion = worldVersions[index];
+    sceneObject->parentTransformVersion = parentVersions[index];
+    sceneObject->checkedTransformEpoch = 0;
+    // rebuilds in the hierarchy did not flag the object for propagation through the pointer tree
+    sceneObject->descendantTransformDirty = true;
+    sceneObject->hierarchy = nullptr;
+    sceneObject->hierarchyNode = NO_PARENT;
+}
+
+size_t SceneHierarchy::dropReleased(const size_t& index) {
+    // nothing reads released objects again, so their transforms are not handed back
+    const size_t last = index + subtreeSizes[index];
+
+    for (size_t i = index; i < last; i++) {
+        if (sceneObjects[i] != nullptr) {
+            sceneObjects[i]->hierarchy = nullptr;
+            sceneObjects[i]->hierarchyNode = NO_PARENT;
+            releasedObjects.push_back(std::move(sceneObjects[i]));
+        }
+    }
+
+    return last;
+}
+
+void SceneHierarchy::releaseNode(const size_t& index) {
+    vector<size_t> firsts;
+    gatherRanges(sceneObjects[index].get(), firsts);
+
+    // the levels are left alone, nodes released after they were built are propagated until compact drops them
+    for (auto& first : firsts) {
+        if (!(flags[first] & RELEASED)) {
+            flags[first] |= RELEASED;
+            releasedCount += subtreeSizes[first];
+
+            // the range is walked in order instead of through the children of every object
+            for (size_t i = first; i < first + subtreeSizes[first]; i++) {
+                if (sceneObjects[i] != nullptr) {
+                    sceneObjects[i]->released = true;
+                }
+            }
+        }
+    }
+}
+
+bool SceneHierarchy::isReleased(const size_t& index) const noexcept {
+    return (flags[index] & RELEASED) != 0;
+}
+
+bool SceneHierarchy::isMisplaced(const size_t& index) const noexcept {
+    const size_t& parent = parents[index];
+    return parent != NO_PARENT && index >= parent + subtreeSizes[parent];
+}
+
+const size_t& SceneHierarchy::getReleasedCount(void) const noexcept {
+    return releasedCount;
+}
+
+const size_t& SceneHierarchy::getMisplacedCount(void) const noexcept {
+    return misplacedCount;
+}
+
+void SceneHierarchy::compact(void) {
+    if (misplacedCount > 0) {
+        reorder();
+        return;
+    }
+
+    if (releasedCount == 0) {
+        return;
+    }
+
+    // the remaining nodes keep their order, so parents still come first and only indices change
+    vector<size_t> newIndices(parents.size(), NO_PARENT);
+    size_t count = 0;
+
+    for (size_t i = 0; i < parents.size();) {
+        if (flags[i] & RELEASED) {
+            i = dropReleased(i);
+            continue;
+        }
+
+        newIndices[i] = count;
+
+        if (count != i) {
+            localTransforms[count] = localTransforms[i];
+            worldTransforms[count] = worldTransforms[i];
+            worldVersions[count] = worldVersions[i];
+            parentVersions[count] = parentVersions[i];
+            checkedEpochs[count] = checkedEpochs[i];
+            flags[count] = flags[i];
+            sceneObjects[count] = std::move(sceneObjects[i]);
+            sceneObjects[count]->hierarchyNode = count;
+        }
+
+        parents[count] = parents[i] != NO_PARENT ? newIndices[parents[i]] : NO_PARENT;
+        count++;
+        i++;
+    }
+
+    localTransforms.resize(count);
+    worldTransforms.resize(count);
+    worldVersions.resize(count);
+    parentVersions.resize(count);
+    checkedEpochs.resize(count);
+    parents.resize(count);
+    flags.resize(count);
+    sceneObjects.resize(count);
+
+    // sizes are summed up again from the leaves, children come after their parents
+    subtreeSizes.assign(count, 1);
+
+    for (size_t i = count; i-- > 0;) {
+        if (parents[i] != NO_PARENT) {
+            subtreeSizes[parents[i]] += subtreeSizes[i];
+        }
+    }
+
+    releasedCount = 0;
+    levelsDirty = true;
+}
+
+void SceneHierarchy::reorder(void) {
+    // children are listed in index order, so a misplaced subtree follows the children in place as it was appended last
+    const size_t count = parents.size();
+    vector<size_t> childOffsets(count + 1, 0);
+    vector<size_t> roots;
+
+    for (size_t i = 0; i < count; i++) {
+        if (parents[i] != NO_PARENT) {
+            childOffsets[parents[i] + 1]++;
+        } else {
+            roots.push_back(i);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+
+    vector<size_t> children(childOffsets.back());
+    vector<size_t> cursors(childOffsets.begin(), childOffsets.end() - 1);
+
+    for (size_t i = 0; i < count; i++) {
+        if (parents[i] != NO_PARENT) {
+            children[cursors[parents[i]]++] = i;
+        }
+    }
+
+    // depth first pre-order again, released nodes are dropped together with everything below them
+    vector<size_t> order;
+    order.reserve(count);
+    vector<pair<size_t, bool>> stack;
+
+    for (auto it = roots.rbegin(); it != roots.rend(); it++) {
+        stack.push_back(make_pair(*it, false));
+    }
+
+    while (!stack.empty()) {
+        const size_t node = stack.back().first;
+        const bool dropped = stack.back().second || (flags[node] & RELEASED) != 0;
+        stack.pop_back();
+
+        if (!dropped) {
+            order.push_back(node);
+        } else if (sceneObjects[node] != nullptr) {
+            sceneObjects[node]->hierarchy = nullptr;
+            sceneObjects[node]->hierarchyNode = NO_PARENT;
+            releasedObjects.push_back(std::move(sceneObjects[node]));
+        }
+
+        for (size_t c = childOffsets[node + 1]; c-- > childOffsets[node];) {
+            stack.push_back(make_pair(children[c], dropped));
+        }
+    }
+
+    vector<size_t> newIndices(count, NO_PARENT);
+    vector<size_t> newParents(order.size());
+
+    for (size_t i = 0; i < order.size(); i++) {
+        newIndices[order[i]] = i;
+    }
+
+    for (size_t i = 0; i < order.size(); i++) {
+        const size_t& parent = parents[order[i]];
+        newParents[i] = parent != NO_PARENT ? newIndices[parent] : NO_PARENT;
+    }
+
+    permute(localTransforms, order);
+    permute(worldTransforms, order);
+    permute(worldVersions, order);
+    permute(parentVersions, order);
+    permute(checkedEpochs, order);
+    permute(flags, order);
+    permute(sceneObjects, order);
+    parents.swap(newParents);
+
+    subtreeSizes.assign(order.size(), 1);
+
+    for (size_t i = order.size(); i-- > 0;) {
+        sceneObjects[i]->hierarchyNode = i;
+
+        if (parents[i] != NO_PARENT) {
+            subtreeSizes[parents[i]] += subtreeSizes[i];
+        }
+    }
+
+    releasedCount = 0;
+    misplacedCount = 0;
+    levelsDirty = true;
+}
+
+vector<shared_ptr<SceneObject>> SceneHierarchy::takeReleased(void) noexcept {
+    vector<shared_ptr<SceneObject>> sceneObjects;
+    sceneObjects.swap(releasedObjects);
+    return sceneObjects;
+}
+
+void SceneHierarchy::markDirty(const size_t& index) noexcept {
+    flags[index] |= DIRTY;
+}
+
+bool SceneHierarchy::isDirty(const size_t& index) const noexcept {
+    return (flags[index] & DIRTY) != 0;
+}
+
+bool SceneHierarchy::isStale(const size_t& index, const size_t& parentVersion) const noexcept {
+    return (flags[index] & DIRTY) != 0 || parentVersions[index] != parentVersion;
+}
+
+const size_t& SceneHierarchy::getWorldTransformVersion(const size_t& index) const noexcept {
+    return worldVersions[index];
+}
+
+void SceneHierarchy::storeLocalTransform(const size_t& index, const Transform& localTransform) noexcept {
+    localTransforms[index] = localTransform;
+}
+
+void SceneHierarchy::setObserved(const size_t& index, const bool& observed) noexcept {
+    flags[index] = observed ? flags[index] | OBSERVED : flags[index] & ~OBSERVED;
+}
+
+void SceneHierarchy::buildLevels(void) {
+    // parents come first, so depths resolve in one pass and a counting sort groups them.
+    // released ranges are left out
+    vector<size_t> depths(parents.size(), 0);
+    levelOffsets.assign(1, 0);
+
+    for (size_t i = 0; i < parents.size(); i++) {
+        if (flags[i] & RELEASED) {
+            i += subtreeSizes[i] - 1;
+            continue;
+        }
+
+        depths[i] = parents[i] == NO_PARENT ? 0 : depths[parents[i]] + 1;
+
+        if (depths[i] + 2 > levelOffsets.size()) {
+            levelOffsets.resize(depths[i] + 2, 0);
+        }
+
+        levelOffsets[depths[i] + 1]++;
+    }
+
+    for (size_t level = 1; level < levelOffsets.size(); level++) {
+        levelOffsets[level] += levelOffsets[level - 1];
+    }
+
+    vector<size_t> cursors(levelOffsets.begin(), levelOffsets.end() - 1);
+    levelNodes.resize(levelOffsets.back());
+
+    for (size_t i = 0; i < parents.size(); i++) {
+        if (flags[i] & RELEASED) {
+            i += subtreeSizes[i] - 1;
+            continue;
+        }
+
+        levelNodes[cursors[depths[i]]++] = i;
+    }
+
+    levelsDirty = false;
+}
+
+bool SceneHierarchy::propagateNode(const size_t& index, const size_t& epoch) const noexcept {
+    // the parent is resolved already, so the node only compares its own state against it.
+    // the scene object is only read at the root, whose parent may be outside the hierarchy
+    const size_t parent = parents[index];
+    bool rebuilt = false;
+
+    if (parent != NO_PARENT) {
+        if ((flags[index] & DIRTY) || parentVersions[index] != worldVersions[parent]) {
+            worldTransforms[index] = worldTransforms[parent].getTransform() * localTransforms[index];
+            parentVersions[index] = worldVersions[parent];
+            rebuilt = true;
+        }
+    } else if (sceneObjects[index]->parent != nullptr) {
+        const SceneObject* outerParent = sceneObjects[index]->parent;
+        const CachedTransform& parentTransform = outerParent->getWorldTransform();
+        const size_t& parentVersion = outerParent->getWorldTransformVersion();
+
+        if ((flags[index] & DIRTY) || parentVersions[index] != parentVersion) {
+            worldTransforms[index] = parentTransform.getTransform() * localTransforms[index];
+            parentVersions[index] = parentVersion;
+            rebuilt = true;
+        }
+    } else if (flags[index] & DIRTY) {
+        worldTransforms[index] = localTransforms[index];
+        rebuilt = true;
+    }
+
+    if (rebuilt) {
+        flags[index] &= ~DIRTY;
+        worldVersions[index]++;
+    }
+
+    checkedEpochs[index] = epoch;
+    return rebuilt;
+}
+
+void SceneHierarchy::notifyChanged(void) const noexcept {
+    for (size_t i = 0; i < flags.size();) {
+        if (flags[i] & RELEASED) {
+            i += subtreeSizes[i];
+            continue;
+        }
+
+        if (flags[i] & CHANGED) {
+            flags[i] &= ~CHANGED;
+            sceneObjects[i]->worldTransformChanged();
+        }
+
+        i++;
+    }
+}
+
+void SceneHierarchy::propagateTransforms(void) noexcept {
+    const size_t epoch = SceneObject::transformEpoch.load(memory_order_relaxed);
+
+    if (propagatedEpoch == epoch) {
+        return;
+    }
+
+    const size_t count = parents.size();
+
+    for (size_t i = 0; i < count;) {
+        if (flags[i] & RELEASED) {
+            i += subtreeSizes[i];
+        } else {
+            if (propagateNode(i, epoch) && (flags[i] & OBSERVED)) {
+                flags[i] |= CHANGED;
+            }
+
+            i++;
+        }
+    }
+
+    notifyChanged();
+    propagatedEpoch = epoch;
+}
+
+void SceneHierarchy::propagateTransforms(const size_t& threadCount, JobSystem& jobSystem) {
+    if (threadCount <= 1) {
+        propagateTransforms();
+        return;
+    }
+
+    const size_t epoch = SceneObject::transformEpoch.load(memory_order_relaxed);
+
+    if (propagatedEpoch == epoch) {
+        return;
+    }
+
+    if (levelsDirty) {
+        buildLevels();
+    }
+
+    // every parent sits one level up and is final before its level starts,
+    // so nodes of the same level can be resolved in any order. every node flags only itself
+    auto propagateNodes = [this, &epoch](const size_t& begin, const size_t& end) {
+        for (size_t n = begin; n < end; n++) {
+            if (propagateNode(levelNodes[n], epoch) && (flags[levelNodes[n]] & OBSERVED)) {
+                flags[levelNodes[n]] |= CHANGED;
+            }
+        }
+    };
+
+    for (size_t level = 0; level + 1 < levelOffsets.size(); level++) {
+        const size_t begin = levelOffsets[level];
+        const size_t end = levelOffsets[level + 1];
+
+        if (end - begin < MIN_PARALLEL_LEVEL_SIZE) {
+            propagateNodes(begin, end);
+        } else {
+            parallelFor(end - begin, threadCount, [&propagateNodes, &begin](const size_t& first, const size_t& last) {
+                propagateNodes(begin + first, begin + last);
+            }, jobSystem);
+        }
+    }
+
+    notifyChanged();
+    propagatedEpoch = epoch;
+}
+
+void SceneHierarchy::draw(const mat4& ProjectionViewMatrix) const noexcept {
+    for (size_t i = 0; i < sceneObjects.size();) {
+        if (flags[i] & RELEASED) {
+            i += subtreeSizes[i];
+        } else {
+            sceneObjects[i]->render(ProjectionViewMatrix, getWorldTransform(i));
+            i++;
+        }
+    }
+}
+
+size_t SceneHierarchy::findNode(const string& name) const noexcept {
+    if (index != nullptr) {
+        const shared_ptr<SceneObject>& sceneObject = index->find(name);
+
+        if (sceneObject == nullptr) {
+            return NO_PARENT;
+        }
+
+        if (sceneObject->hierarchy == this) {
+            return sceneObject->hierarchyNode;
+        }
+    }
+
+    for (size_t i = 0; i < sceneObjects.size();) {
+        if (flags[i] & RELEASED) {
+            i += subtreeSizes[i];
+        } else if (sceneObjects[i]->getName() == name) {
+            return i;
+        } else {
+            i++;
+        }
+    }
+
+    return NO_PARENT;
+}
+
+void SceneHierarchy::setIndex(const SceneIndex* index) noexcept {
+    this->index = index;
+}
+
+shared_ptr<SceneObject> SceneHierarchy::getSceneObject(const string& name) const noexcept {
+    const size_t index = findNode(name);
+    return index != NO_PARENT ? sceneObjects[index] : nullptr;
+}
+
+size_t SceneHierarchy::size(void) const noexcept {
+    return sceneObjects.size();
+}
+
+const shared_ptr<SceneObject>& SceneHierarchy::getSceneObject(const size_t& index) const noexcept {
+    return sceneObjects[index];
+}
+
+const size_t& SceneHierarchy::getParent(const size_t& index) const noexcept {
+    return parents[index];
+}
+
+const size_t& SceneHierarchy::getSubtreeSize(const size_t& index) const noexcept {
+    return subtreeSizes[index];
+}
+
+const Transform& SceneHierarchy::getLocalTransform(const size_t& index) const noexcept {
+    return localTransforms[index];
+}
+
+void SceneHierarchy::setLocalTransform(const size_t& index, const Transform& localTransform) noexcept {
+    sceneObjects[index]->setLocalTransform(localTransform);
+}
+
+const CachedTransform& SceneHierarchy::getWorldTransform(const size_t& index) const noexcept {
+    const size_t epoch = SceneObject::transformEpoch.load(memory_order_relaxed);
+
+    if (checkedEpochs[index] != epoch) {
+        if (parents[index] != NO_PARENT) {
+            getWorldTransform(parents[index]);
+        }
+
+        if (propagateNode(index, epoch)) {
+            sceneObjects[index]->worldTransformChanged();
+        }
+    }
+
+    return worldTransforms[index];
+}
+
+ostream& operator<< (ostream& out, const SceneHierarchy& sceneHierarchy) {
+    out << "Scene Hierarchy nodes: " << sceneHierarchy.size() << endl;
+
+    for (size_t i = 0; i < sceneHierarchy.size();) {
+        if (sceneHierarchy.isReleased(i)) {
+            i += sceneHierarchy.getSubtreeSize(i);
+            continue;
+        }
+
+        out << "Node " << i << " name: " << sceneHierarchy.getSceneObject(i)->getName() << endl;
+        out << "Node " << i << " world transform:\n" << sceneHierarchy.getWorldTransform(i) << endl;
+        i++;
+    }
+
+    return out;
+}
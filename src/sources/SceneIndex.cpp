@@ -0,0 +1,238 @@
+#include <SceneIndex.hpp>
+
+// cpp
+#include <algorithm>
+
+SceneIndex::~SceneIndex(void) {
+    for (auto& entry : sceneObjects) {
+        for (auto& sceneObject : entry.second) {
+            sceneObject->index = nullptr;
+        }
+    }
+}
+
+void SceneIndex::insertNode(const shared_ptr<SceneObject>& sceneObject) {
+    sceneObjects[sceneObject->getName()].push_back(sceneObject);
+    sceneObject->index = this;
+
+    if (boundingVolumeHierarchy != nullptr) {
+        boundingVolumeHierarchy->insert(sceneObject.get());
+    }
+
+    if (snapshotBuffer != nullptr) {
+        snapshotBuffer->insert(sceneObject);
+    }
+
+    for (auto& child : sceneObject->getChildren()) {
+        insertNode(child);
+    }
+}
+
+void SceneIndex::eraseNode(const SceneObject* sceneObject, const string& name) noexcept {
+    auto entry = sceneObjects.find(name);
+
+    if (entry != sceneObjects.end()) {
+        vector<shared_ptr<SceneObject>>& namesakes = entry->second;
+
+        for (auto it = namesakes.begin(); it != namesakes.end(); it++) {
+            if (it->get() == sceneObject) {
+                namesakes.erase(it);
+                break;
+            }
+        }
+
+        if (namesakes.empty()) {
+            sceneObjects.erase(entry);
+        }
+    }
+}
+
+void SceneIndex::insert(const shared_ptr<SceneObject>& sceneObject) {
+    if (sceneObject->index != nullptr) {
+        sceneObject->index->erase(sceneObject);
+    }
+
+    insertNode(sceneObject);
+}
+
+void SceneIndex::erase(const shared_ptr<SceneObject>& sceneObject) noexcept {
+    if (sceneObject->index == this) {
+        erase(vector<shared_ptr<SceneObject>>(1, sceneObject));
+    }
+}
+
+void SceneIndex::rename(const SceneObject* sceneObject, const string& oldName, const string& newName) {
+    auto entry = sceneObjects.find(oldName);
+
+    if (entry != sceneObjects.end()) {
+        for (auto& namesake : entry->second) {
+            if (namesake.get() == sceneObject) {
+                // a renamed object queues up behind objects that already carry the new name
+                shared_ptr<SceneObject> renamed = namesake;
+                eraseNode(sceneObject, oldName);
+                sceneObjects[newName].push_back(renamed);
+                return;
+            }
+        }
+    }
+}
+
+const shared_ptr<SceneObject>& SceneIndex::find(const string& name) const noexcept {
+    static const shared_ptr<SceneObject> notFound = nullptr;
+    auto entry = sceneObjects.find(name);
+
+    if (entry != sceneObjects.end()) {
+        for (auto& namesake : entry->second) {
+            if (!namesake->released) {
+                return namesake;
+            }
+        }
+    }
+
+    return notFound;
+}
+
+size_t SceneIndex::size(void) const noexcept {
+    size_t count = 0;
+
+    for (auto& entry : sceneObjects) {
+        count += entry.second.size();
+    }
+
+    return count;
+}
+
+void SceneIndex::setBoundingVolumeHierarchy(BoundingVolumeHierarchy* boundingVolumeHierarchy) {
+    this->boundingVolumeHierarchy = boundingVolumeHierarchy;
+
+    // objects already indexed are added in bulk, building the tree once
+    if (boundingVolumeHierarchy != nullptr) {
+        vector<SceneObject*> indexed;
+
+        for (auto& entry : sceneObjects) {
+            for (auto& sceneObject : entry.second) {
+                indexed.push_back(sceneObject.get());
+            }
+        }
+
+        boundingVolumeHierarchy->insert(indexed);
+    }
+}
+
+void SceneIndex::setSnapshotBuffer(SceneSnapshotBuffer* snapshotBuffer) {
+    this->snapshotBuffer = snapshotBuffer;
+
+    if (snapshotBuffer != nullptr) {
+        for (auto& entry : sceneObjects) {
+            for (auto& sceneObject : entry.second) {
+                snapshotBuffer->insert(sceneObject);
+            }
+        }
+    }
+}
+
+void SceneIndex::gatherSubtree(SceneObject* sceneObject, vector<SceneObject*>& sceneObjects) {
+    vector<SceneObject*> stack(1, sceneObject);
+
+    while (!stack.empty()) {
+        SceneObject* node = stack.back();
+        stack.pop_back();
+        sceneObjects.push_back(node);
+
+        for (auto& child : node->getChildren()) {
+            stack.push_back(child.get());
+        }
+    }
+}
+
+void SceneIndex::eraseNodes(const vector<SceneObject*>& nodes, vector<shared_ptr<SceneObject>>& erased) noexcept {
+    vector<unordered_map<string, vector<shared_ptr<SceneObject>>>::iterator> entries;
+
+    for (auto& node : nodes) {
+        if (node->index != this) {
+            continue;
+        }
+
+        if (boundingVolumeHierarchy != nullptr) {
+            boundingVolumeHierarchy->erase(node);
+        }
+
+        if (snapshotBuffer != nullptr) {
+            snapshotBuffer->erase(node);
+        }
+
+        node->index = nullptr;
+        auto entry = sceneObjects.find(node->getName());
+
+        if (entry != sceneObjects.end()) {
+            entries.push_back(entry);
+        }
+    }
+
+    // namesakes are filtered once per name rather than searched once per object
+    sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return &a->second < &b->second; });
+    entries.erase(unique(entries.begin(), entries.end()), entries.end());
+
+    for (auto& entry : entries) {
+        vector<shared_ptr<SceneObject>>& namesakes = entry->second;
+        size_t kept = 0;
+
+        for (size_t i = 0; i < namesakes.size(); i++) {
+            if (namesakes[i]->index != this) {
+                erased.push_back(std::move(namesakes[i]));
+            } else {
+                if (kept != i) {
+                    namesakes[kept] = std::move(namesakes[i]);
+                }
+
+                kept++;
+            }
+        }
+
+        namesakes.resize(kept);
+
+        if (namesakes.empty()) {
+            sceneObjects.erase(entry);
+        }
+    }
+}
+
+void SceneIndex::erase(const vector<shared_ptr<SceneObject>>& sceneObjects) noexcept {
+    vector<SceneObject*> nodes;
+    vector<shared_ptr<SceneObject>> erased;
+
+    for (auto& sceneObject : sceneObjects) {
+        gatherSubtree(sceneObject.get(), nodes);
+    }
+
+    eraseNodes(nodes, erased);
+}
+
+void SceneIndex::release(shared_ptr<SceneObject> sceneObject) {
+    pendingReleases.push_back(std::move(sceneObject));
+}
+
+void SceneIndex::flushReleases(vector<shared_ptr<SceneObject>>& released) {
+    if (pendingReleases.empty()) {
+        return;
+    }
+
+    vector<SceneObject*> nodes;
+
+    for (auto& sceneObject : pendingReleases) {
+        gatherSubtree(sceneObject.get(), nodes);
+    }
+
+    eraseNodes(nodes, released);
+
+    // the roots hold their subtrees together until now
+    for (auto& sceneObject : pendingReleases) {
+        released.push_back(std::move(sceneObject));
+    }
+
+    pendingReleases.clear();
+}
+
+bool SceneIndex::isReleasing(void) const noexcept {
+    return !pendingReleases.empty();
+}
@@ -1,68 +1,325 @@
 #include <SceneObject.hpp>
+#include <SceneIndex.hpp>
+#include <SceneHierarchy.hpp>
+#include <BoundingVolumeHierarchy.hpp>
+#include <Parallel.hpp>
+#include <RenderQueue.hpp>
+#include <SceneSnapshot.hpp>
+
+atomic<size_t> SceneObject::transformEpoch(1);
 
 SceneObject::SceneObject(const string& name, const Transform& transform):
     name(name),
-    transform(transform) {
+    localTransform(transform),
+    worldTransform(transform) {
 }
 
 SceneObject::SceneObject(const SceneObject& sceneObject):
     name(sceneObject.name),
-    transform(sceneObject.transform),
+    localTransform(sceneObject.getTransform()),
+    worldTransform(sceneObject.getTransform()),
     children(sceneObject.children) {
 }
 
 SceneObject::SceneObject(SceneObject&& sceneObject):
     name(std::move(sceneObject.name)),
-    transform(std::move(sceneObject.transform)),
+    localTransform(sceneObject.getTransform()),
+    worldTransform(sceneObject.getTransform()),
     children(std::move(sceneObject.children)) {
+    adoptChildren();
 }
 
 SceneObject::~SceneObject(void) {
-    children.clear();
+    releaseChildren();
 }
 
 SceneObject& SceneObject::operator=(const SceneObject& other) noexcept {
     name = other.name;
-    transform = other.transform;
+    setTransform(other.getTransform());
+    releaseChildren();
     children = other.children;
     return *this;
 }
 
 SceneObject& SceneObject::operator=(SceneObject&& other) noexcept {
     name = std::move(other.name);
-    transform = std::move(other.transform);
+    setTransform(other.getTransform());
+    releaseChildren();
     children = std::move(other.children);
+    adoptChildren();
     return *this;
 }
 
-void SceneObject::update(const Transform& newTransform) {
-    transform = newTransform * transform;
-    
+void SceneObject::markTransformDirty(void) noexcept {
+    // descendants are left alone, they see the new version of this world transform once it is rebuilt
+    if (hierarchy != nullptr) {
+        hierarchy->markDirty(hierarchyNode);
+    } else {
+        worldTransformDirty = true;
+    }
+
+    transformEpoch.fetch_add(1, memory_order_relaxed);
+}
+
+bool SceneObject::isTransformDirty(void) const noexcept {
+    return hierarchy != nullptr ? hierarchy->isDirty(hierarchyNode) : worldTransformDirty;
+}
+
+bool SceneObject::needsPropagation(const size_t& parentVersion) const noexcept {
+    if (descendantTransformDirty) {
+        return true;
+    }
+
+    return hierarchy != nullptr ?
+        hierarchy->isStale(hierarchyNode, parentVersion) :
+        worldTransformDirty || parentTransformVersion != parentVersion;
+}
+
+void SceneObject::resolveWorldTransform(void) const noexcept {
+    // the parent is brought up to date first, then this node is rebuilt if either of them changed since
+    if (parent != nullptr) {
+        const CachedTransform& parentTransform = parent->getWorldTransform();
+        const size_t& parentVersion = parent->getWorldTransformVersion();
+
+        if (!worldTransformDirty && parentTransformVersion == parentVersion) {
+            return;
+        }
+
+        worldTransform = parentTransform.getTransform() * localTransform;
+        parentTransformVersion = parentVersion;
+    } else if (worldTransformDirty) {
+        worldTransform = localTransform;
+    } else {
+        return;
+    }
+
+    worldTransformDirty = false;
+    worldTransformVersion++;
+    worldTransformChanged();
+}
+
+const size_t& SceneObject::getWorldTransformVersion(void) const noexcept {
+    return hierarchy != nullptr ? hierarchy->getWorldTransformVersion(hierarchyNode) : worldTransformVersion;
+}
+
+void SceneObject::worldTransformChanged(void) const noexcept {
+    // only state of this object is touched, several propagation threads may rebuild different objects at once.
+    // the bounds find out by the version of the world transform
+    descendantTransformDirty = true;
+
+    if (boundingVolumeHierarchy != nullptr) {
+        boundingVolumeHierarchy->markMoved(boundingVolumeLeaf);
+    }
+
+    if (snapshotBuffer != nullptr) {
+        snapshotBuffer->markChanged(snapshotSlot);
+    }
+}
+
+bool SceneObject::isWorldTransformObserved(void) const noexcept {
+    return boundingVolumeHierarchy != nullptr || snapshotBuffer != nullptr;
+}
+
+void SceneObject::observersChanged(void) noexcept {
+    if (hierarchy != nullptr) {
+        hierarchy->setObserved(hierarchyNode, isWorldTransformObserved());
+    }
+}
+
+void SceneObject::storeLocalTransform(const Transform& localTransform) noexcept {
+    if (hierarchy != nullptr) {
+        hierarchy->storeLocalTransform(hierarchyNode, localTransform);
+    } else {
+        this->localTransform = localTransform;
+    }
+}
+
+void SceneObject::markBoundsDirty(void) noexcept {
+    for (SceneObject* sceneObject = this; sceneObject != nullptr && !sceneObject->subtreeBoundsDirty; sceneObject = sceneObject->parent) {
+        sceneObject->subtreeBoundsDirty = true;
+    }
+}
+
+void SceneObject::markDescendantTransformDirty(void) noexcept {
+    for (SceneObject* sceneObject = this; sceneObject != nullptr && !sceneObject->descendantTransformDirty; sceneObject = sceneObject->parent) {
+        sceneObject->descendantTransformDirty = true;
+    }
+}
+
+void SceneObject::invalidateTransform(void) noexcept {
+    markTransformDirty();
+
+    if (parent != nullptr) {
+        parent->markBoundsDirty();
+        parent->markDescendantTransformDirty();
+    }
+}
+
+void SceneObject::refitSubtreeBounds(void) const noexcept {
+    BoundingSphere bounds;
+    subtreeBoundedCount = 0;
+
+    if (getBoundingSphere(bounds)) {
+        subtreeBounds = bounds.transform(getWorldTransform());
+        subtreeBoundedCount = 1;
+    }
+
+    // clean children hand back their cached bounds, only dirty ones recurse
     for (auto& child : children) {
-        child->update(newTransform);
+        if (child->getSubtreeBounds(bounds)) {
+            subtreeBounds = subtreeBoundedCount > 0 ? subtreeBounds.merge(bounds) : bounds;
+            subtreeBoundedCount += child->subtreeBoundedCount;
+        }
+    }
+
+    subtreeBoundsDirty = false;
+    subtreeBoundsVersion = getWorldTransformVersion();
+}
+
+bool SceneObject::isSubtreeBoundsDirty(void) const noexcept {
+    return subtreeBoundsDirty || subtreeBoundsVersion != getWorldTransformVersion();
+}
+
+void SceneObject::setParent(SceneObject* parent) noexcept {
+    // keep the world transform so that attaching or detaching does not move the object
+    const Transform world = getTransform();
+
+    this->parent = parent;
+    storeLocalTransform(parent != nullptr ? inverse(parent->getTransform()) * world : world);
+    invalidateTransform();
+}
+
+void SceneObject::adoptChildren(void) noexcept {
+    for (size_t i = 0; i < children.size(); i++) {
+        const shared_ptr<SceneObject>& child = children[i];
+
+        // the nodes of the children follow them to the hierarchy of their new parent, if any
+        if (child->hierarchy != nullptr) {
+            child->hierarchy->removeNode(child->hierarchyNode);
+        }
+
+        child->parent = this;
+        child->childIndex = i;
+        child->markTransformDirty();
+        markDescendantTransformDirty();
+
+        if (hierarchy != nullptr) {
+            hierarchy->appendSubtree(child, hierarchyNode);
+        }
     }
+
+    markBoundsDirty();
+}
+
+void SceneObject::releaseChildren(void) noexcept {
+    for (auto& child : children) {
+        if (child->parent == this) {
+            if (child->hierarchy != nullptr) {
+                child->hierarchy->removeNode(child->hierarchyNode);
+            }
+
+            // only children that outlive this object need a world transform of their own. released subtrees are
+            // torn down on a worker, where no transform is rebuilt and the edit epoch is left alone
+            if (!released && child.use_count() > 1) {
+                child->setParent(nullptr);
+            } else {
+                child->parent = nullptr;
+            }
+        }
+    }
+
+    children.clear();
+
+    if (!released) {
+        markBoundsDirty();
+    }
+}
+
+void SceneObject::markReleased(void) noexcept {
+    vector<SceneObject*> stack(1, this);
+
+    while (!stack.empty()) {
+        SceneObject* sceneObject = stack.back();
+        stack.pop_back();
+        sceneObject->released = true;
+
+        for (auto& child : sceneObject->children) {
+            stack.push_back(child.get());
+        }
+    }
+}
+
+void SceneObject::update(const Transform& newTransform) {
+    // newTransform is applied in world space, descendants follow through their parent
+    if (parent != nullptr) {
+        const Transform& parentTransform = parent->getTransform();
+        storeLocalTransform(inverse(parentTransform) * newTransform * parentTransform * getLocalTransform());
+    } else {
+        storeLocalTransform(newTransform * getLocalTransform());
+    }
+
+    invalidateTransform();
 }
 
 void SceneObject::draw(const mat4& ProjectionViewMatrix) const {
+    render(ProjectionViewMatrix, getWorldTransform());
+
     for (auto& child : children) {
         child->draw(ProjectionViewMatrix);
     }
 }
 
+void SceneObject::render(const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const {
+}
+
+void SceneObject::enqueue(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const {
+    // without knowing what render binds, such objects go first under the lowest key
+    renderQueue.push(0, this, &worldTransform);
+}
+
+void SceneObject::submit(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const CachedTransform& worldTransform) const {
+    render(ProjectionViewMatrix, worldTransform);
+    renderQueue.resetBindings();
+}
+
+void SceneObject::submitInstances(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const vector<mat4>& models) const {
+    // plain objects never push batched packets
+}
+
+bool SceneObject::getIndirectDraw(const CachedTransform& worldTransform, DrawElementsIndirectCommand& command, mat4& model) const {
+    return false;
+}
+
+void SceneObject::submitIndirect(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const vector<DrawElementsIndirectCommand>& commands, const vector<mat4>& models) const {
+}
+
+void SceneObject::submitObjects(RenderQueue& renderQueue, const mat4& ProjectionViewMatrix, const GLuint& firstObjectIndex, const GLsizei& objectCount) const {
+}
+
+mat4 SceneObject::getModelMatrix(const CachedTransform& worldTransform) const noexcept {
+    return worldTransform.getMatrix();
+}
+
+void SceneObject::getModelDualQuaternion(const CachedTransform& worldTransform, fdualquat& translationAndRotation, vec3& scale) const noexcept {
+    translationAndRotation = worldTransform.getTransform().getTranslationAndRotation();
+    scale = worldTransform.getTransform().getScale();
+}
+
+bool SceneObject::getBoundingSphere(BoundingSphere& boundingSphere) const noexcept {
+    // nothing to bound, such objects are never culled
+    return false;
+}
+
 void SceneObject::translate(const float& tX, const float& tY, const float& tZ) noexcept {
     Transform newTransform(
         fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(tX, tY, tZ))
     );
 
-    transform = newTransform * transform;
-
-    for (auto& child : children) {
-        child->update(newTransform);
-    }
+    update(newTransform);
 }
 
 void SceneObject::rotate(const float& degreesX, const float& degreesY, const float& degreesZ) noexcept {
-    vec3 translation = vec3(transform.getMatrix()[3]);
+    vec3 translation = vec3(getWorldTransform().getMatrix()[3]);
     Transform newTransform(
         fdualquat(fquat(1.f, 0.f, 0.f, 0.f), translation) *
         fdualquat(glm::rotate(fquat(1.f, 0.f, 0.f, 0.f), radians(degreesX), vec3(1.f, 0.f, 0.f))) *
@@ -71,11 +328,7 @@ void SceneObject::rotate(const float& degreesX, const float& degreesY, const flo
         fdualquat(fquat(1.f, 0.f, 0.f, 0.f), -translation)
     );
 
-    transform = newTransform * transform;
-
-    for (auto& child : children) {
-        child->update(newTransform);
-    }
+    update(newTransform);
 }
 
 void SceneObject::orbit(const float& degreesX, const float& degreesY, const float& degreesZ) noexcept {
@@ -85,20 +338,126 @@ void SceneObject::orbit(const float& degreesX, const float& degreesY, const floa
         fdualquat(glm::rotate(fquat(1.f, 0.f, 0.f, 0.f), radians(degreesZ), vec3(0.f, 0.f, 1.f)))
     );
 
-    transform = newTransform * transform;
+    update(newTransform);
+}
 
-    for (auto& child : children) {
-        child->update(newTransform);
+void SceneObject::propagateTransform(void) const noexcept {
+    // an unflagged node has neither dirty descendants nor children built from an older version of it
+    getWorldTransform();
+
+    if (descendantTransformDirty) {
+        descendantTransformDirty = false;
+        const size_t& version = getWorldTransformVersion();
+
+        for (auto& child : children) {
+            if (child->needsPropagation(version)) {
+                child->propagateTransform();
+            }
+        }
+    }
+}
+
+void SceneObject::propagateTransform(const size_t& threadCount, JobSystem& jobSystem) const {
+    if (threadCount <= 1) {
+        propagateTransform();
+        return;
+    }
+
+    vector<const SceneObject*> frontier;
+    gatherFrontier(threadCount * 4, frontier);
+
+    parallelFor(frontier.size(), threadCount, [&frontier](const size_t& begin, const size_t& end) {
+        for (size_t i = begin; i < end; i++) {
+            frontier[i]->propagateTransform();
+        }
+    }, jobSystem);
+}
+
+void SceneObject::gatherFrontier(const size_t& width, vector<const SceneObject*>& frontier) const {
+    vector<const SceneObject*> nextFrontier;
+    frontier.assign(1, this);
+
+    while (!frontier.empty() && frontier.size() < width) {
+        nextFrontier.clear();
+
+        for (auto& sceneObject : frontier) {
+            sceneObject->getWorldTransform();
+
+            if (!sceneObject->descendantTransformDirty) {
+                continue;
+            }
+
+            sceneObject->descendantTransformDirty = false;
+            const size_t& version = sceneObject->getWorldTransformVersion();
+
+            for (auto& child : sceneObject->children) {
+                if (child->needsPropagation(version)) {
+                    nextFrontier.push_back(child.get());
+                }
+            }
+        }
+
+        frontier.swap(nextFrontier);
     }
 }
 
 const Transform& SceneObject::getTransform(void) const noexcept {
-    return transform;
+    return getWorldTransform();
+}
+
+const CachedTransform& SceneObject::getWorldTransform(void) const noexcept {
+    if (hierarchy != nullptr) {
+        return hierarchy->getWorldTransform(hierarchyNode);
+    }
+
+    // checking walks up to the first ancestor checked in this epoch, so it is done once per node and edit
+    const size_t epoch = transformEpoch.load(memory_order_relaxed);
+
+    if (checkedTransformEpoch != epoch) {
+        resolveWorldTransform();
+        checkedTransformEpoch = epoch;
+    }
+
+    return worldTransform;
 }
 
 void SceneObject::setTransform(const Transform& transform) noexcept {
-    update(inverse(transform));
-    update(transform);
+    storeLocalTransform(parent != nullptr ? inverse(parent->getTransform()) * transform : transform);
+    invalidateTransform();
+}
+
+const Transform& SceneObject::getLocalTransform(void) const noexcept {
+    return hierarchy != nullptr ? hierarchy->getLocalTransform(hierarchyNode) : localTransform;
+}
+
+void SceneObject::setLocalTransform(const Transform& localTransform) noexcept {
+    storeLocalTransform(localTransform);
+    invalidateTransform();
+}
+
+bool SceneObject::getSubtreeBounds(BoundingSphere& boundingSphere) const noexcept {
+    getWorldTransform();
+
+    if (isSubtreeBoundsDirty()) {
+        refitSubtreeBounds();
+    }
+
+    boundingSphere = subtreeBounds;
+    return subtreeBoundedCount > 0;
+}
+
+size_t SceneObject::getSubtreeBoundedCount(void) const noexcept {
+    getWorldTransform();
+
+    if (isSubtreeBoundsDirty()) {
+        refitSubtreeBounds();
+    }
+
+    return subtreeBoundedCount;
+}
+
+SceneObject* SceneObject::getParent(void) const noexcept {
+    return parent;
 }
 
 const string& SceneObject::getName(void) const noexcept {
@@ -106,6 +465,10 @@ const string& SceneObject::getName(void) const noexcept {
 }
 
 void SceneObject::setName(const string& name) noexcept {
+    if (index != nullptr && name != this->name) {
+        index->rename(this, this->name, name);
+    }
+
     this->name = name;
 }
 
@@ -114,14 +477,51 @@ const vector<shared_ptr<SceneObject>>& SceneObject::getChildren(void) const noex
 }
 
 void SceneObject::appendChild(const shared_ptr<SceneObject>& child) noexcept {
-    children.push_back(child);
+    const shared_ptr<SceneObject> newChild = child;
+
+    if (newChild->parent != nullptr) {
+        newChild->parent->removeChild(newChild);
+    }
+
+    newChild->setParent(this);
+    newChild->childIndex = children.size();
+    children.push_back(newChild);
+
+    if (hierarchy != nullptr) {
+        hierarchy->appendSubtree(newChild, hierarchyNode);
+    }
+
+    if (index != nullptr) {
+        index->insert(newChild);
+    }
 }
 
 bool SceneObject::removeChild(const shared_ptr<SceneObject>& child) noexcept {
     auto it = children.begin();
     for (; it != children.end(); it++) {
         if ((*it) == child) {
-            children.erase(it);
+            if (child->parent == this) {
+                // the subtree leaves the hierarchy before it gets a world transform of its own
+                if (child->hierarchy != nullptr) {
+                    child->hierarchy->removeNode(child->hierarchyNode);
+                }
+
+                child->setParent(nullptr);
+            }
+
+            if (index != nullptr) {
+                index->erase(child);
+            }
+
+            it = children.erase(it);
+
+            for (; it != children.end(); it++) {
+                if ((*it)->parent == this) {
+                    (*it)->childIndex--;
+                }
+            }
+
+            markBoundsDirty();
             return true;
         }
     }
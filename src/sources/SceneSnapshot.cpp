@@ -0,0 +1,276 @@
+#include <SceneSnapshot.hpp>
+#include <BoundingVolumeHierarchy.hpp>
+
+// cpp
+#include <cfloat>
+
+const vector<SceneSnapshot::Entry>& SceneSnapshot::getEntries(void) const noexcept {
+    return entries;
+}
+
+const size_t& SceneSnapshot::getFrame(void) const noexcept {
+    return frame;
+}
+
+const size_t SceneSnapshot::NULL_NODE;
+
+bool SceneSnapshot::query(const Frustum& frustum, vector<size_t>& slots) const {
+    if (!indexed) {
+        return false;
+    }
+
+    if (cullRoot == NULL_NODE) {
+        return true;
+    }
+
+    vector<size_t> stack(1, cullRoot);
+    while (!stack.empty()) {
+        const CullNode& node = cullNodes[stack.back()];
+        stack.pop_back();
+
+        if (!frustum.intersects(node.boundingBox)) {
+            continue;
+        }
+
+        if (node.left == NULL_NODE) {
+            if (node.slot != NULL_NODE) {
+                slots.push_back(node.slot);
+            }
+        } else if (frustum.contains(node.boundingBox)) {
+            // every leaf below a node wholly inside is taken without further tests
+            const size_t begin = stack.size();
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+
+            while (stack.size() > begin) {
+                const CullNode& inside = cullNodes[stack.back()];
+                stack.pop_back();
+
+                if (inside.left != NULL_NODE) {
+                    stack.push_back(inside.left);
+                    stack.push_back(inside.right);
+                } else if (inside.slot != NULL_NODE) {
+                    slots.push_back(inside.slot);
+                }
+            }
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+
+    return true;
+}
+
+const vector<size_t>& SceneSnapshot::getUnboundedSlots(void) const noexcept {
+    return unboundedSlots;
+}
+
+const size_t& SceneSnapshot::getBoundedCount(void) const noexcept {
+    return boundedCount;
+}
+
+SceneSnapshotBuffer::SceneSnapshotBuffer(void):
+    changedCount(0) {
+}
+
+SceneSnapshotBuffer::~SceneSnapshotBuffer(void) {
+    for (auto& sceneObject : sceneObjects) {
+        if (sceneObject != nullptr) {
+            sceneObject->snapshotBuffer = nullptr;
+            sceneObject->observersChanged();
+        }
+    }
+}
+
+void SceneSnapshotBuffer::insert(const shared_ptr<SceneObject>& sceneObject) {
+    if (sceneObject->snapshotBuffer != nullptr) {
+        sceneObject->snapshotBuffer->erase(sceneObject.get());
+    }
+
+    size_t slot = sceneObjects.size();
+
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        sceneObjects.push_back(nullptr);
+        owners.push_back(nullptr);
+        changedFrames.push_back(0);
+        changedSlots.resize(sceneObjects.size());
+        previousChangedSlots.resize(sceneObjects.size());
+    }
+
+    sceneObjects[slot] = sceneObject.get();
+    owners[slot] = sceneObject;
+    sceneObject->snapshotBuffer = this;
+    sceneObject->snapshotSlot = slot;
+    sceneObject->observersChanged();
+    markChanged(slot);
+}
+
+void SceneSnapshotBuffer::erase(SceneObject* sceneObject) noexcept {
+    if (sceneObject->snapshotBuffer != this) {
+        return;
+    }
+
+    // a reused slot is marked changed again, so it may be handed out right away
+    const size_t slot = sceneObject->snapshotSlot;
+    sceneObjects[slot] = nullptr;
+    owners[slot] = nullptr;
+    freeSlots.push_back(slot);
+    markChanged(slot);
+
+    sceneObject->snapshotBuffer = nullptr;
+    sceneObject->observersChanged();
+}
+
+void SceneSnapshotBuffer::markChanged(const size_t& slot) noexcept {
+    // each slot is only marked by the thread rebuilding its object, the list itself is shared
+    if (changedFrames[slot] != frame) {
+        changedFrames[slot] = frame;
+        changedSlots[changedCount.fetch_add(1, memory_order_relaxed)] = slot;
+    }
+}
+
+void SceneSnapshotBuffer::writeEntry(const size_t& slot) {
+    SceneSnapshot::Entry& entry = back->entries[slot];
+    entry.sceneObject = owners[slot];
+
+    if (sceneObjects[slot] != nullptr) {
+        BoundingSphere bounds;
+        entry.worldTransform = sceneObjects[slot]->getWorldTransform();
+        entry.worldBounds = sceneObjects[slot]->getBoundingSphere(bounds) ?
+            bounds.transform(entry.worldTransform) : BoundingSphere(vec3(0.f, 0.f, 0.f), FLT_MAX);
+    }
+}
+
+void SceneSnapshotBuffer::writeCullNode(const BoundingVolumeHierarchy& boundingVolumeHierarchy, const size_t& node) {
+    const BoundingVolumeHierarchy::Node& source = boundingVolumeHierarchy.nodes[node];
+    SceneSnapshot::CullNode& cullNode = back->cullNodes[node];
+    cullNode.boundingBox = source.boundingBox;
+    cullNode.left = source.left;
+    cullNode.right = source.right;
+    cullNode.slot = source.sceneObject != nullptr && source.sceneObject->snapshotBuffer == this ?
+        source.sceneObject->snapshotSlot : SceneSnapshot::NULL_NODE;
+}
+
+void SceneSnapshotBuffer::writeCullNodes(BoundingVolumeHierarchy* boundingVolumeHierarchy) {
+    back->indexed = boundingVolumeHierarchy != nullptr && boundingVolumeHierarchy->tracking;
+
+    if (!back->indexed) {
+        return;
+    }
+
+    const BoundingVolumeHierarchy& source = *boundingVolumeHierarchy;
+    back->cullNodes.resize(source.nodes.size());
+
+    // like the entries, the back copy lacks the changes of the previous frame and of this one
+    for (auto& node : previousChangedNodes) {
+        if (!source.nodes[node].logged) {
+            writeCullNode(source, node);
+        }
+    }
+
+    for (size_t i = 0; i < source.changedCount; i++) {
+        writeCullNode(source, source.changedNodes[i]);
+        boundingVolumeHierarchy->nodes[source.changedNodes[i]].logged = false;
+    }
+
+    previousChangedNodes.assign(source.changedNodes.begin(), source.changedNodes.begin() + source.changedCount);
+    boundingVolumeHierarchy->changedCount = 0;
+
+    back->cullRoot = source.root;
+    back->boundedCount = source.leafCount;
+    back->unboundedSlots.clear();
+
+    for (auto& leaf : source.unboundedLeaves) {
+        const SceneObject* sceneObject = source.nodes[leaf].sceneObject;
+
+        if (sceneObject->snapshotBuffer == this) {
+            back->unboundedSlots.push_back(sceneObject->snapshotSlot);
+        }
+    }
+}
+
+void SceneSnapshotBuffer::publish(BoundingVolumeHierarchy* boundingVolumeHierarchy) {
+    if (back->entries.size() < sceneObjects.size()) {
+        back->entries.resize(sceneObjects.size());
+    }
+
+    // the back snapshot last saw the frame before the previous one
+    copiedCount = 0;
+
+    for (size_t i = 0; i < previousChangedCount; i++) {
+        if (changedFrames[previousChangedSlots[i]] != frame) {
+            writeEntry(previousChangedSlots[i]);
+            copiedCount++;
+        }
+    }
+
+    // writing resolves world transforms, objects rebuilt by that are added and copied in the same pass
+    for (size_t i = 0; i < changedCount.load(memory_order_relaxed); i++) {
+        writeEntry(changedSlots[i]);
+        copiedCount++;
+    }
+
+    writeCullNodes(boundingVolumeHierarchy);
+    back->frame = frame;
+
+    {
+        unique_lock<mutex> lock(swapMutex);
+        released.wait(lock, [this](void) { return !reading; });
+        swap(front, back);
+    }
+
+    previousChangedSlots.swap(changedSlots);
+    previousChangedCount = changedCount.exchange(0, memory_order_relaxed);
+    frame++;
+}
+
+const SceneSnapshot& SceneSnapshotBuffer::acquire(void) {
+    lock_guard<mutex> lock(swapMutex);
+    reading = true;
+    return *front;
+}
+
+void SceneSnapshotBuffer::release(void) {
+    {
+        lock_guard<mutex> lock(swapMutex);
+        reading = false;
+    }
+
+    released.notify_one();
+}
+
+size_t SceneSnapshotBuffer::size(void) const noexcept {
+    return sceneObjects.size() - freeSlots.size();
+}
+
+size_t SceneSnapshotBuffer::getReferenceCount(const SceneObject* sceneObject) const noexcept {
+    if (sceneObject->snapshotBuffer != this) {
+        return 0;
+    }
+
+    const size_t slot = sceneObject->snapshotSlot;
+    size_t count = owners[slot].get() == sceneObject ? 1 : 0;
+
+    for (auto& snapshot : snapshots) {
+        if (slot < snapshot.entries.size() && snapshot.entries[slot].sceneObject.get() == sceneObject) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+const size_t& SceneSnapshotBuffer::getCopiedCount(void) const noexcept {
+    return copiedCount;
+}
+
+ostream& operator<< (ostream& out, const SceneSnapshotBuffer& sceneSnapshotBuffer) {
+    out << "Scene Snapshot Buffer objects: " << sceneSnapshotBuffer.size() << endl;
+    out << "Scene Snapshot Buffer copied by last publish: " << sceneSnapshotBuffer.getCopiedCount() << endl;
+
+    return out;
+}
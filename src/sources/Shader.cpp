@@ -1,6 +1,16 @@
 #include <Shader.hpp>
+#include <GLDeletionQueue.hpp>
 
-Shader::Shader(const string& vertexPath, const string& fragmentPath) {
+#include <cstring>
+#include <chrono>
+
+Shader::Program::~Program(void) {
+    // no GL state is queried here, the queue deletes the program with the next flush
+    GLDeletionQueue::getShared().deleteProgram(id);
+}
+
+Shader::Shader(const string& vertexPath, const string& fragmentPath, const shared_ptr<ProgramCache>& programCache) :
+    program(make_shared<Program>()) {
     // 1. retrieve the vertex/fragment source code from filePath
     std::string vertexCode;
     std::string fragmentCode;
@@ -30,10 +40,31 @@ Shader::Shader(const string& vertexPath, const string& fragmentPath) {
         throw exception("ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ");
     }
 
+    // 2. load the program binary or compile and link the sources
+    program->id = glCreateProgram();
+    const GLuint& id = program->id;
+
+    if (programCache != nullptr) {
+        const vector<string> sources = { vertexCode, fragmentCode };
+
+        if (!programCache->load(sources, id)) {
+            const auto start = chrono::steady_clock::now();
+            glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            compile(vertexCode, fragmentCode);
+            programCache->store(sources, id, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        }
+    } else {
+        compile(vertexCode, fragmentCode);
+    }
+
+    cacheUniformLocations();
+}
+
+void Shader::compile(const string& vertexCode, const string& fragmentCode) {
+    const GLuint& id = program->id;
     const char* vShaderCode = vertexCode.c_str();
     const char * fShaderCode = fragmentCode.c_str();
 
-    // 2. compile shaders
     unsigned int vertex, fragment;
 
     // vertex shader
@@ -49,7 +80,6 @@ Shader::Shader(const string& vertexPath, const string& fragmentPath) {
     checkCompileErrors(fragment, "FRAGMENT");
 
     // shader Program
-    id = glCreateProgram();
     glAttachShader(id, vertex);
     glAttachShader(id, fragment);
     glLinkProgram(id);
@@ -62,25 +92,6 @@ Shader::Shader(const string& vertexPath, const string& fragmentPath) {
     glDeleteShader(fragment);
 }
 
-Shader::Shader(const Shader& shader) :
-    id(shader.id) {}
-
-Shader::Shader(Shader&& shader) :
-    id(shader.id) {}
-
-Shader::~Shader(void) {
-    glUseProgram(0);
-
-    GLint flaggedForDeletion;
-    glGetProgramiv(id, GL_DELETE_STATUS, &flaggedForDeletion);
-
-    if (flaggedForDeletion == GL_FALSE && glIsProgram(id) == GL_TRUE) {
-        glDeleteProgram(id);
-    }
-
-    id = 0;
-}
-
 void Shader::checkCompileErrors(const GLuint& shader, const string& type) const {
     int success;
     char infoLog[1024];
@@ -101,24 +112,95 @@ void Shader::checkCompileErrors(const GLuint& shader, const string& type) const
     }
 }
 
+void Shader::cacheUniformLocations(void) {
+    const GLuint& id = program->id;
+    vector<Uniform>& uniforms = program->uniforms;
+    unordered_map<string, GLint>& uniformHandles = program->uniformHandles;
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    vector<GLchar> nameBuffer(glm::max(maxNameLength, 1));
+
+    for (GLint i = 0; i < uniformCount; i++) {
+        GLsizei nameLength = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(id, (GLuint)i, (GLsizei)nameBuffer.size(), &nameLength, &size, &type, nameBuffer.data());
+
+        string name(nameBuffer.data(), nameLength);
+        Uniform uniform;
+        uniform.location = glGetUniformLocation(id, name.c_str());
+
+        // members of uniform blocks have no location of their own
+        if (uniform.location < 0) {
+            continue;
+        }
+
+        const GLint handle = (GLint)uniforms.size();
+        uniforms.push_back(uniform);
+        uniformHandles.emplace(name, handle);
+
+        // arrays are reported as "name[0]", also accept the bare name
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            uniformHandles.emplace(name.substr(0, name.size() - 3), handle);
+        }
+    }
+}
+
+bool Shader::updateShadow(const GLint& handle, const GLfloat* value, const size_t& count) const noexcept {
+    if (handle < 0 || handle >= (GLint)program->uniforms.size()) {
+        return false;
+    }
+
+    Uniform& uniform = program->uniforms[handle];
+
+    if (uniform.uploaded && memcmp(uniform.value, value, count * sizeof(GLfloat)) == 0) {
+        return false;
+    }
+
+    memcpy(uniform.value, value, count * sizeof(GLfloat));
+    uniform.uploaded = true;
+    return true;
+}
+
 void Shader::use(void) const {
-    glUseProgram(id);
+    glUseProgram(program->id);
 }
 
 const GLuint& Shader::getId(void) const {
-    return id;
+    return program->id;
 }
 
 const GLuint Shader::getUniformBlockIdx(const std::string& uniformBlockName) const {
-    return glGetUniformBlockIndex(id, uniformBlockName.c_str());
+    return glGetUniformBlockIndex(program->id, uniformBlockName.c_str());
+}
+
+GLint Shader::getUniformHandle(const std::string& name) const noexcept {
+    auto it = program->uniformHandles.find(name);
+    return it != program->uniformHandles.end() ? it->second : -1;
 }
 
 void Shader::setVec4(const std::string& name, const GLfloat* vec) const {
-    glUniform4fv(glGetUniformLocation(id, name.c_str()), 1, vec);
+    setVec4(getUniformHandle(name), vec);
+}
+
+void Shader::setVec4(const GLint& handle, const GLfloat* vec) const {
+    // uniform values belong to the program, so the shadow only skips values it already holds
+    if (updateShadow(handle, vec, 4)) {
+        glUniform4fv(program->uniforms[handle].location, 1, vec);
+    }
 }
 
 void Shader::setMat4(const std::string& name, const GLfloat* mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, false, mat);
+    setMat4(getUniformHandle(name), mat);
+}
+
+void Shader::setMat4(const GLint& handle, const GLfloat* mat) const {
+    if (updateShadow(handle, mat, 16)) {
+        glUniformMatrix4fv(program->uniforms[handle].location, 1, false, mat);
+    }
 }
 
 ostream& operator<< (ostream& out, const Shader& shader) {
@@ -45,15 +45,15 @@ Transform Transform::getInverse(void) const noexcept {
 }
 
 vec3 Transform::getXUnitVector(void) const noexcept {
-    return normalize(vec3(getMatrix() * vec4(1.f, 0.f, 0.f, 0.f)));
+    return normalize(vec3(getMatrix()[0]));
 }
 
 vec3 Transform::getYUnitVector(void) const noexcept {
-    return normalize(vec3(getMatrix() * vec4(0.f, 1.f, 0.f, 0.f)));
+    return normalize(vec3(getMatrix()[1]));
 }
 
 vec3 Transform::getZUnitVector(void) const noexcept {
-    return normalize(vec3(getMatrix() * vec4(0.f, 0.f, 1.f, 0.f)));
+    return normalize(vec3(getMatrix()[2]));
 }
 
 const fdualquat& Transform::getTranslationAndRotation(void) const noexcept {
@@ -64,11 +64,45 @@ const vec3& Transform::getScale(void) const noexcept {
     return scale;
 }
 
+CachedTransform::CachedTransform(const Transform& transform):
+    transform(transform),
+    matrix(transform.getMatrix()),
+    inverseMatrix(transform.getInverseMatrix()) {
+}
+
+CachedTransform& CachedTransform::operator=(const Transform& transform) noexcept {
+    this->transform = transform;
+    matrix = transform.getMatrix();
+    inverseMatrix = transform.getInverseMatrix();
+    return *this;
+}
+
+const Transform& CachedTransform::getTransform(void) const noexcept {
+    return transform;
+}
+
+const mat4& CachedTransform::getMatrix(void) const noexcept {
+    return matrix;
+}
+
+const mat4& CachedTransform::getInverseMatrix(void) const noexcept {
+    return inverseMatrix;
+}
+
+CachedTransform::operator const Transform&(void) const noexcept {
+    return transform;
+}
+
 ostream& operator<< (ostream& out, const Transform& transform) noexcept {
     out << transform.getMatrix() << endl;
     return out;
 }
 
+ostream& operator<< (ostream& out, const CachedTransform& cachedTransform) noexcept {
+    out << cachedTransform.getMatrix() << endl;
+    return out;
+}
+
 ostream& operator<< (ostream& out, const mat4& mat) noexcept {
     out << std::fixed << std::setprecision(4) << endl;
     out << mat[0][0] << "\t\t" << mat[1][0] << "\t\t" << mat[2][0] << "\t\t" << mat[3][0] << endl;
@@ -82,4 +116,23 @@ ostream& operator<< (ostream& out, const mat4& mat) noexcept {
 Transform inverse(const Transform& transform) noexcept {
     const vec3& scale = transform.getScale();
     return Transform(inverse(transform.getTranslationAndRotation()), vec3(1.f / scale.x, 1.f / scale.y, 1.f / scale.z));
+}
+
+void packDualQuaternionScale(const fdualquat& translationAndRotation, const vec3& scale, vec4* packed) noexcept {
+    const fquat& real = translationAndRotation.real;
+    const fquat& dual = translationAndRotation.dual;
+
+    packed[0] = vec4(real.x, real.y, real.z, real.w);
+    packed[1] = vec4(dual.x, dual.y, dual.z, dual.w);
+    packed[2] = vec4(scale, 0.f);
+}
+
+void packScaledDualQuaternion(const fdualquat& translationAndRotation, const float& scale, vec4* packed) noexcept {
+    const fquat& real = translationAndRotation.real;
+    const fquat& dual = translationAndRotation.dual;
+    // also renormalizes a real part that drifted from unit length
+    const float factor = sqrt(scale / dot(real, real));
+
+    packed[0] = vec4(real.x, real.y, real.z, real.w) * factor;
+    packed[1] = vec4(dual.x, dual.y, dual.z, dual.w) * factor;
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include <Vertex.hpp>
 
+#include <cstdint>
+#include <cstring>
+
 Vertex::Vertex(const vec3& position, const vec3& normal, const vec3& color, const vec2& texCoord):
     position(position),
     normal(normal),
@@ -37,6 +40,64 @@ Vertex& Vertex::operator=(Vertex&& other) noexcept {
     return *this;
 }
 
+static uint32_t hashVertex(const Vertex& vertex) noexcept {
+    uint32_t words[sizeof(Vertex) / sizeof(uint32_t)];
+    memcpy(words, &vertex, sizeof(Vertex));
+
+    // murmur style mixing of every 32 bit word
+    uint32_t hash = 0;
+    for (auto& word : words) {
+        uint32_t k = word * 0xcc9e2d51u;
+        k = (k << 15) | (k >> 17);
+        hash ^= k * 0x1b873593u;
+        hash = ((hash << 13) | (hash >> 19)) * 5u + 0xe6546b64u;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+void weldVertices(vector<Vertex>& vertices, vector<GLuint>& indices) {
+    static_assert(sizeof(Vertex) % sizeof(uint32_t) == 0, "Vertex must be made of 32 bit words");
+
+    indices.resize(vertices.size());
+
+    // open addressing table of unique vertex slots at most half full, a node based map
+    // would allocate per vertex and dominate load time on large meshes
+    size_t capacity = 1;
+    while (capacity < vertices.size() * 2) {
+        capacity <<= 1;
+    }
+
+    const GLuint EMPTY = ~GLuint(0);
+    vector<GLuint> table(capacity, EMPTY);
+    GLuint uniqueCount = 0;
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        size_t slot = hashVertex(vertices[i]) & (capacity - 1);
+
+        while (table[slot] != EMPTY && memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex)) != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+
+        if (table[slot] == EMPTY) {
+            // unique vertices are compacted towards the front, never past the one being read
+            if (uniqueCount != i) {
+                vertices[uniqueCount] = vertices[i];
+            }
+
+            table[slot] = uniqueCount++;
+        }
+
+        indices[i] = table[slot];
+    }
+
+    vertices.resize(uniqueCount);
+    vertices.shrink_to_fit();
+}
+
 ostream& operator << (ostream& out, const vec2& vector) {
     out << std::fixed << std::setprecision(4) << endl;
     out << vector[0] << "\t\t" << vector[1] << endl;
@@ -0,0 +1,243 @@
+#include <VertexFormat.hpp>
+
+// cpp
+#include <cstring>
+
+#include <glm\gtc\packing.hpp>
+
+VertexFormat::VertexFormat(const PositionEncoding& positionEncoding, const NormalEncoding& normalEncoding, const ColorEncoding& colorEncoding, const TexCoordEncoding& texCoordEncoding):
+    positionEncoding(positionEncoding),
+    normalEncoding(normalEncoding),
+    colorEncoding(colorEncoding),
+    texCoordEncoding(texCoordEncoding) {
+    buildLayout();
+}
+
+VertexFormat VertexFormat::compact(void) {
+    return VertexFormat(POSITION_SNORM16, NORMAL_OCTAHEDRAL_SNORM16, COLOR_RGBA8, TEXCOORD_UNORM16);
+}
+
+void VertexFormat::buildLayout(void) {
+    attributes.clear();
+    stride = 0;
+
+    // every attribute starts on a 4 byte boundary, three 16 bit components take 8 bytes
+    auto addAttribute = [this](const GLuint& location, const GLint& size, const GLenum& type, const GLboolean& normalized, const size_t& bytes) {
+        VertexAttribute attribute;
+        attribute.location = location;
+        attribute.size = size;
+        attribute.type = type;
+        attribute.normalized = normalized;
+        attribute.offset = stride;
+        attributes.push_back(attribute);
+        stride += (bytes + 3) & ~size_t(3);
+    };
+
+    switch (positionEncoding) {
+    case POSITION_FLOAT: addAttribute(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat)); break;
+    case POSITION_HALF: addAttribute(0, 3, GL_HALF_FLOAT, GL_FALSE, 3 * sizeof(GLhalf)); break;
+    case POSITION_SNORM16: addAttribute(0, 3, GL_SHORT, GL_TRUE, 3 * sizeof(GLshort)); break;
+    }
+
+    switch (normalEncoding) {
+    case NORMAL_FLOAT: addAttribute(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat)); break;
+    case NORMAL_OCTAHEDRAL_SNORM16: addAttribute(1, 2, GL_SHORT, GL_TRUE, 2 * sizeof(GLshort)); break;
+    }
+
+    switch (colorEncoding) {
+    case COLOR_FLOAT: addAttribute(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat)); break;
+    case COLOR_RGBA8: addAttribute(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4 * sizeof(GLubyte)); break;
+    }
+
+    switch (texCoordEncoding) {
+    case TEXCOORD_FLOAT: addAttribute(3, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat)); break;
+    case TEXCOORD_HALF: addAttribute(3, 2, GL_HALF_FLOAT, GL_FALSE, 2 * sizeof(GLhalf)); break;
+    case TEXCOORD_UNORM16: addAttribute(3, 2, GL_UNSIGNED_SHORT, GL_TRUE, 2 * sizeof(GLushort)); break;
+    }
+}
+
+void VertexFormat::encode(const vector<Vertex>& vertices, const BoundingSphere& bounds, vector<unsigned char>& buffer) const {
+    buffer.resize(vertices.size() * stride);
+
+    if (isFloat()) {
+        // the full float layout is the Vertex itself
+        if (!vertices.empty()) {
+            memcpy(buffer.data(), vertices.data(), buffer.size());
+        }
+
+        return;
+    }
+
+    const vec3 center = positionEncoding == POSITION_FLOAT ? vec3(0.f, 0.f, 0.f) : bounds.getCenter();
+    const float scale = positionEncoding == POSITION_FLOAT || bounds.getRadius() <= 0.f ? 1.f : 1.f / bounds.getRadius();
+    unsigned char* out = buffer.data();
+
+    for (auto& vertex : vertices) {
+        unsigned char* attribute = out;
+        const vec3 position = (vertex.position - center) * scale;
+
+        switch (positionEncoding) {
+        case POSITION_FLOAT: {
+            memcpy(attribute, &position, sizeof(vec3));
+            attribute += sizeof(vec3);
+            break;
+        }
+        case POSITION_HALF: {
+            const uint64_t packed = packHalf4x16(vec4(position, 1.f));
+            memcpy(attribute, &packed, sizeof(uint64_t));
+            attribute += sizeof(uint64_t);
+            break;
+        }
+        case POSITION_SNORM16: {
+            const uint64_t packed = packSnorm4x16(vec4(position, 1.f));
+            memcpy(attribute, &packed, sizeof(uint64_t));
+            attribute += sizeof(uint64_t);
+            break;
+        }
+        }
+
+        switch (normalEncoding) {
+        case NORMAL_FLOAT: {
+            memcpy(attribute, &vertex.normal, sizeof(vec3));
+            attribute += sizeof(vec3);
+            break;
+        }
+        case NORMAL_OCTAHEDRAL_SNORM16: {
+            const uint32_t packed = packSnorm2x16(encodeOctahedral(vertex.normal));
+            memcpy(attribute, &packed, sizeof(uint32_t));
+            attribute += sizeof(uint32_t);
+            break;
+        }
+        }
+
+        switch (colorEncoding) {
+        case COLOR_FLOAT: {
+            memcpy(attribute, &vertex.color, sizeof(vec3));
+            attribute += sizeof(vec3);
+            break;
+        }
+        case COLOR_RGBA8: {
+            const uint32_t packed = packUnorm4x8(vec4(vertex.color, 1.f));
+            memcpy(attribute, &packed, sizeof(uint32_t));
+            attribute += sizeof(uint32_t);
+            break;
+        }
+        }
+
+        switch (texCoordEncoding) {
+        case TEXCOORD_FLOAT: {
+            memcpy(attribute, &vertex.texCoord, sizeof(vec2));
+            break;
+        }
+        case TEXCOORD_HALF: {
+            const uint32_t packed = packHalf2x16(vertex.texCoord);
+            memcpy(attribute, &packed, sizeof(uint32_t));
+            break;
+        }
+        case TEXCOORD_UNORM16: {
+            const uint32_t packed = packUnorm2x16(vertex.texCoord);
+            memcpy(attribute, &packed, sizeof(uint32_t));
+            break;
+        }
+        }
+
+        out += stride;
+    }
+}
+
+void VertexFormat::apply(void) const noexcept {
+    for (auto& attribute : attributes) {
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized, (GLsizei)stride, (void*)attribute.offset);
+    }
+}
+
+void VertexFormat::applyInstanceModel(void) noexcept {
+    // a mat4 attribute takes four vec4 locations
+    for (GLuint column = 0; column < 4; column++) {
+        glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + column);
+        glVertexAttribPointer(INSTANCE_MODEL_LOCATION + column, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*)(column * sizeof(vec4)));
+        glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + column, 1);
+    }
+}
+
+bool VertexFormat::isFloat(void) const noexcept {
+    return positionEncoding == POSITION_FLOAT && normalEncoding == NORMAL_FLOAT && colorEncoding == COLOR_FLOAT && texCoordEncoding == TEXCOORD_FLOAT;
+}
+
+mat4 VertexFormat::getPositionDecode(const BoundingSphere& bounds) const noexcept {
+    if (positionEncoding == POSITION_FLOAT || bounds.getRadius() <= 0.f) {
+        return mat4(1.f);
+    }
+
+    // uniform scale, so normals transformed by the model matrix keep their direction
+    return glm::scale(glm::translate(mat4(1.f), bounds.getCenter()), vec3(bounds.getRadius()));
+}
+
+const vector<VertexAttribute>& VertexFormat::getAttributes(void) const noexcept {
+    return attributes;
+}
+
+const size_t& VertexFormat::getStride(void) const noexcept {
+    return stride;
+}
+
+const VertexFormat::PositionEncoding& VertexFormat::getPositionEncoding(void) const noexcept {
+    return positionEncoding;
+}
+
+const VertexFormat::NormalEncoding& VertexFormat::getNormalEncoding(void) const noexcept {
+    return normalEncoding;
+}
+
+const VertexFormat::ColorEncoding& VertexFormat::getColorEncoding(void) const noexcept {
+    return colorEncoding;
+}
+
+const VertexFormat::TexCoordEncoding& VertexFormat::getTexCoordEncoding(void) const noexcept {
+    return texCoordEncoding;
+}
+
+vec2 VertexFormat::encodeOctahedral(const vec3& normal) noexcept {
+    const float l1 = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+
+    if (l1 <= 0.f) {
+        return vec2(0.f, 0.f);
+    }
+
+    // project onto the octahedron, then fold the lower half over the diagonals
+    vec2 encoded = vec2(normal.x, normal.y) / l1;
+
+    if (normal.z < 0.f) {
+        const vec2 folded = (1.f - glm::abs(vec2(encoded.y, encoded.x)));
+        encoded = vec2(
+            encoded.x >= 0.f ? folded.x : -folded.x,
+            encoded.y >= 0.f ? folded.y : -folded.y
+        );
+    }
+
+    return encoded;
+}
+
+vec3 VertexFormat::decodeOctahedral(const vec2& encoded) noexcept {
+    vec3 normal = vec3(encoded.x, encoded.y, 1.f - glm::abs(encoded.x) - glm::abs(encoded.y));
+
+    if (normal.z < 0.f) {
+        const vec2 folded = (1.f - glm::abs(vec2(normal.y, normal.x)));
+        normal.x = normal.x >= 0.f ? folded.x : -folded.x;
+        normal.y = normal.y >= 0.f ? folded.y : -folded.y;
+    }
+
+    const float length = glm::length(normal);
+    return length > 0.f ? normal / length : normal;
+}
+
+ostream& operator<< (ostream& out, const VertexFormat& vertexFormat) {
+    out << "Vertex Format stride: " << vertexFormat.getStride() << endl;
+
+    for (auto& attribute : vertexFormat.getAttributes()) {
+        out << "Vertex Format attribute " << attribute.location << ": " << attribute.size << " x 0x" << std::hex << attribute.type << std::dec << " at " << attribute.offset << endl;
+    }
+
+    return out;
+}
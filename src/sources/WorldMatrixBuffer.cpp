@@ -0,0 +1,147 @@
+#include <WorldMatrixBuffer.hpp>
+#include <GLDeletionQueue.hpp>
+
+WorldMatrixBuffer::WorldMatrixBuffer(const size_t& capacity, const Layout& layout):
+    layout(layout) {
+    allocate(capacity);
+}
+
+WorldMatrixBuffer::~WorldMatrixBuffer(void) {
+    deallocate();
+}
+
+void WorldMatrixBuffer::allocate(const size_t& capacity) {
+    // regions of a multiple of 16 objects keep every region offset on a 256 byte storage buffer offset alignment
+    this->capacity = (glm::max(capacity, size_t(1)) + 15) & ~size_t(15);
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr bytes = (GLsizeiptr)(this->capacity * getStride(layout) * REGION_COUNT);
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, bytes, nullptr, flags);
+    mapped = (unsigned char*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, bytes, flags);
+    region = 0;
+}
+
+void WorldMatrixBuffer::deallocate(void) noexcept {
+    // may run on any thread, so nothing waits on the fences here. GL keeps the storage alive until draws
+    // reading it completed, and deleting the buffer releases its mapping as well
+    GLDeletionQueue& deletionQueue = GLDeletionQueue::getShared();
+
+    for (size_t i = 0; i < REGION_COUNT; i++) {
+        if (fences[i] != nullptr) {
+            const GLsync fence = fences[i];
+            deletionQueue.defer([fence](void) { glDeleteSync(fence); });
+            fences[i] = nullptr;
+        }
+    }
+
+    deletionQueue.deleteBuffers(1, &buffer);
+    buffer = 0;
+    mapped = nullptr;
+}
+
+void WorldMatrixBuffer::waitForRegion(const size_t& region) noexcept {
+    if (fences[region] != nullptr) {
+        while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+        }
+
+        glDeleteSync(fences[region]);
+        fences[region] = nullptr;
+    }
+}
+
+void WorldMatrixBuffer::write(const RenderQueue& renderQueue) {
+    if (renderQueue.size() > capacity) {
+        // the old storage may still be read, GL deletes it once the draws reading it completed
+        deallocate();
+        allocate(renderQueue.size() + renderQueue.size() / 2);
+    }
+
+    region = (region + 1) % REGION_COUNT;
+    waitForRegion(region);
+
+    // one sequential pass, the mapping is write combined and never read back
+    const size_t offset = region * capacity * getStride(layout);
+
+    switch (layout) {
+    case MATRIX:
+        renderQueue.writeModelMatrices((mat4*)(mapped + offset));
+        break;
+    case DUAL_QUATERNION_SCALE:
+        renderQueue.writeDualQuaternions((vec4*)(mapped + offset), false);
+        break;
+    case DUAL_QUATERNION_UNIFORM_SCALE:
+        renderQueue.writeDualQuaternions((vec4*)(mapped + offset), true);
+        break;
+    }
+
+    count = renderQueue.size();
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, BINDING, buffer, (GLintptr)offset, (GLsizeiptr)(capacity * getStride(layout)));
+}
+
+void WorldMatrixBuffer::fence(void) {
+    if (fences[region] != nullptr) {
+        glDeleteSync(fences[region]);
+    }
+
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+const WorldMatrixBuffer::Layout& WorldMatrixBuffer::getLayout(void) const noexcept {
+    return layout;
+}
+
+const size_t& WorldMatrixBuffer::getCapacity(void) const noexcept {
+    return capacity;
+}
+
+const size_t& WorldMatrixBuffer::size(void) const noexcept {
+    return count;
+}
+
+size_t WorldMatrixBuffer::getStride(const Layout& layout) noexcept {
+    switch (layout) {
+    case DUAL_QUATERNION_SCALE:
+        return 3 * sizeof(vec4);
+    case DUAL_QUATERNION_UNIFORM_SCALE:
+        return 2 * sizeof(vec4);
+    default:
+        return sizeof(mat4);
+    }
+}
+
+string WorldMatrixBuffer::getShaderSource(const Layout& layout) {
+    if (layout == MATRIX) {
+        return
+            "layout(std430, binding = 0) readonly buffer WorldMatrices { mat4 worldMatrices[]; };\n"
+            "mat4 getWorldMatrix(uint index) { return worldMatrices[index]; }\n";
+    }
+
+    // the rotation is built from the unnormalized real part r, which scales it by dot(r, r). the separate
+    // scale layout divides that back out, the uniform scale layout packed its scale into dot(r, r)
+    const string stride = layout == DUAL_QUATERNION_SCALE ? "3u" : "2u";
+    const string scale = layout == DUAL_QUATERNION_SCALE ? "worldTransforms[index * 3u + 2u].xyz / n" : "vec3(1.0)";
+
+    return
+        "layout(std430, binding = 0) readonly buffer WorldTransforms { vec4 worldTransforms[]; };\n"
+        "mat4 getWorldMatrix(uint index) {\n"
+        "    vec4 r = worldTransforms[index * " + stride + "];\n"
+        "    vec4 d = worldTransforms[index * " + stride + " + 1u];\n"
+        "    float n = dot(r, r);\n"
+        "    vec3 s = " + scale + ";\n"
+        "    vec3 t = 2.0 * (r.w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz)) / n;\n"
+        "    return mat4(\n"
+        "        vec4(r.w * r.w + r.x * r.x - r.y * r.y - r.z * r.z, 2.0 * (r.x * r.y + r.w * r.z), 2.0 * (r.x * r.z - r.w * r.y), 0.0) * s.x,\n"
+        "        vec4(2.0 * (r.x * r.y - r.w * r.z), r.w * r.w - r.x * r.x + r.y * r.y - r.z * r.z, 2.0 * (r.y * r.z + r.w * r.x), 0.0) * s.y,\n"
+        "        vec4(2.0 * (r.x * r.z + r.w * r.y), 2.0 * (r.y * r.z - r.w * r.x), r.w * r.w - r.x * r.x - r.y * r.y + r.z * r.z, 0.0) * s.z,\n"
+        "        vec4(t, 1.0));\n"
+        "}\n";
+}
+
+ostream& operator<< (ostream& out, const WorldMatrixBuffer& worldMatrixBuffer) {
+    out << "World Matrix Buffer objects: " << worldMatrixBuffer.size() << " / " << worldMatrixBuffer.getCapacity() << endl;
+    out << "World Matrix Buffer bytes per object: " << WorldMatrixBuffer::getStride(worldMatrixBuffer.getLayout()) << endl;
+
+    return out;
+}
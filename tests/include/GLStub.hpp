@@ -0,0 +1,40 @@
+#ifndef GL_STUB_HPP
+#define GL_STUB_HPP
+
+// cpp
+#include <map>
+#include <string>
+#include <vector>
+
+#include <GeometryArena.hpp>
+
+using namespace std;
+
+// Stubbed GL function table for running the library headless, without a context.
+// install points the glad function pointers at functions that hand out names, keep buffer contents,
+// record how often each function was called and otherwise do nothing. Programs report the active
+// uniforms set by setActiveUniforms and always compile and link.
+class GLStub {
+public:
+    static void install(void);
+
+    // forgets the recorded calls and indirect commands, names and buffer contents are kept
+    static void reset(void);
+
+    static size_t getCallCount(const string& function) noexcept;
+
+    static const map<string, size_t>& getCalls(void) noexcept;
+
+    // every command read by glMultiDrawElementsIndirect since the last reset, in submission order
+    static const vector<DrawElementsIndirectCommand>& getIndirectCommands(void) noexcept;
+
+    // active uniforms of programs linked from now on, "PVM", "model" and "PV" by default
+    static void setActiveUniforms(const vector<string>& names);
+
+    // shader files the stubbed compiler accepts, written by install
+    static const string& getVertexShaderPath(void) noexcept;
+
+    static const string& getFragmentShaderPath(void) noexcept;
+};
+
+#endif // !GL_STUB_HPP
@@ -0,0 +1,45 @@
+#ifndef TEST_HPP
+#define TEST_HPP
+
+// cpp
+#include <functional>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Checks shared by the tests. The tests run the library against the stubbed GL function table,
+// every failed check prints one line and makes the run fail.
+class Test {
+private:
+    static size_t checkCount;
+    static size_t failureCount;
+
+public:
+    static void check(const bool& condition, const string& description);
+
+    static const size_t& getCheckCount(void) noexcept;
+
+    static const size_t& getFailureCount(void) noexcept;
+};
+
+// one entry point per test source, run in this order by main
+void testCulling(void);
+
+void testUniforms(void);
+
+void testRenderQueue(void);
+
+void testInstancing(void);
+
+void testVertexFormats(void);
+
+void testIndirect(void);
+
+void testDualQuaternions(void);
+
+void testJobSystem(void);
+
+void testDestroy(void);
+
+#endif // !TEST_HPP
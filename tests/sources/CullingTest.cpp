@@ -0,0 +1,282 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <algorithm>
+#include <vector>
+
+static shared_ptr<Mesh> makeMesh(const shared_ptr<Geometry>& geometry, const shared_ptr<Shader>& shader, const string& name, const vec3& position) {
+    const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, name, Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+    mesh->setShader(shader);
+    return mesh;
+}
+
+// draw calls of any kind recorded by the stub since the last reset
+static size_t getDrawCallCount(void) {
+    size_t count = 0;
+
+    for (auto& call : GLStub::getCalls()) {
+        if (call.first.compare(0, 6, "glDraw") == 0 || call.first.compare(0, 11, "glMultiDraw") == 0) {
+            count += call.second;
+        }
+    }
+
+    return count;
+}
+
+static void checkCounts(const string& name, const SceneGraph& sceneGraph, const size_t& visibleCount, const size_t& culledCount) {
+    Test::check(sceneGraph.getVisibleCount() == visibleCount, name + ": visible count");
+    Test::check(sceneGraph.getCulledCount() == culledCount, name + ": culled count");
+}
+
+// assigning a mesh of the same transform but geometry in front of the camera changes only its bounds
+static void testAssignedGeometry(const shared_ptr<Geometry>& geometry, const mat4& ProjectionViewMatrix, const bool& boundingVolumeHierarchy) {
+    const string name = boundingVolumeHierarchy ? "bounding volume hierarchy" : "pointer tree";
+    const Transform transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(0.f, 0.f, 20.f)));
+    const shared_ptr<Geometry> shiftedGeometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, -40.f)), Vertex(vec3(1.f, 0.f, -40.f)), Vertex(vec3(0.f, 1.f, -40.f)) }));
+
+    SceneGraph sceneGraph;
+    const shared_ptr<SceneObject> group = make_shared<SceneObject>("group");
+    const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "behind", transform);
+    sceneGraph.getRoot()->appendChild(group);
+    group->appendChild(mesh);
+
+    if (boundingVolumeHierarchy) {
+        sceneGraph.buildBoundingVolumeHierarchy();
+    }
+
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts(name + ", before assigning", sceneGraph, 0, 1);
+
+    const Mesh shifted(shiftedGeometry, "shifted", transform);
+    *mesh = shifted;
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts(name + ", geometry copied in", sceneGraph, 1, 0);
+
+    *mesh = Mesh(geometry, "behind", transform);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts(name + ", geometry moved in", sceneGraph, 0, 1);
+}
+
+// a row of meshes 5 apart along x, half of them built in bulk and half inserted one by one afterwards
+static void testQueries(const shared_ptr<Geometry>& geometry) {
+    SceneGraph sceneGraph;
+    vector<shared_ptr<Mesh>> meshes;
+
+    for (size_t i = 0; i < 20; i++) {
+        meshes.push_back(make_shared<Mesh>(geometry, "row", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i * 5.f, 0.f, 0.f)))));
+
+        if (i == 10) {
+            sceneGraph.buildBoundingVolumeHierarchy();
+        }
+
+        sceneGraph.getRoot()->appendChild(meshes.back());
+    }
+
+    sceneGraph.propagateTransforms();
+    const BoundingVolumeHierarchy& boundingVolumeHierarchy = *sceneGraph.getBoundingVolumeHierarchy();
+    Test::check(boundingVolumeHierarchy.size() == 20, "queries: every mesh has a leaf");
+
+    vector<const SceneObject*> found;
+    boundingVolumeHierarchy.query(BoundingBox(vec3(9.f, -1.f, -1.f), vec3(21.f, 1.f, 1.f)), found);
+    Test::check(
+        found.size() == 3 &&
+        count(found.begin(), found.end(), meshes[2].get()) == 1 &&
+        count(found.begin(), found.end(), meshes[3].get()) == 1 &&
+        count(found.begin(), found.end(), meshes[4].get()) == 1,
+        "queries: a box overlaps the meshes inside it"
+    );
+
+    found.clear();
+    boundingVolumeHierarchy.query(BoundingBox(vec3(9.f, 10.f, -1.f), vec3(21.f, 12.f, 1.f)), found);
+    Test::check(found.empty(), "queries: a box above the row overlaps nothing");
+
+    // rays run through the middle of the bounding spheres
+    BoundingSphere bounds;
+    meshes[0]->getBoundingSphere(bounds);
+    const vec3 center = bounds.getCenter();
+    float distance = 0.f;
+
+    const SceneObject* hit = boundingVolumeHierarchy.raycast(vec3(-10.f, center.y, center.z), vec3(1.f, 0.f, 0.f), 100.f, distance);
+    Test::check(hit == meshes[0].get(), "queries: a ray along the row hits the first mesh");
+    Test::check(glm::abs(distance - (10.f + center.x - bounds.getRadius())) < 0.001f, "queries: the hit distance is where the ray enters the sphere");
+
+    hit = boundingVolumeHierarchy.raycast(vec3(48.f, center.y, center.z), vec3(-2.f, 0.f, 0.f), 100.f, distance);
+    Test::check(hit == meshes[9].get(), "queries: a ray the other way hits the closest mesh, built in bulk");
+
+    hit = boundingVolumeHierarchy.raycast(vec3(73.f, center.y, center.z), vec3(1.f, 0.f, 0.f), 100.f, distance);
+    Test::check(hit == meshes[15].get(), "queries: a ray hits the closest mesh inserted afterwards");
+
+    Test::check(boundingVolumeHierarchy.raycast(vec3(-10.f, center.y, center.z), vec3(1.f, 0.f, 0.f), 5.f, distance) == nullptr, "queries: a ray stops at its maximum distance");
+    Test::check(boundingVolumeHierarchy.raycast(vec3(-10.f, center.y, center.z), vec3(0.f, 1.f, 0.f), 100.f, distance) == nullptr, "queries: a ray past the row hits nothing");
+
+    // the first mesh leaves the row, its leaf follows once transforms are propagated
+    meshes[0]->translate(0.f, 0.f, 50.f);
+    sceneGraph.propagateTransforms();
+    hit = boundingVolumeHierarchy.raycast(vec3(-10.f, center.y, center.z), vec3(1.f, 0.f, 0.f), 100.f, distance);
+    Test::check(hit == meshes[1].get(), "queries: a moved mesh is no longer hit where it was");
+
+    hit = boundingVolumeHierarchy.raycast(vec3(-10.f, center.y, center.z + 50.f), vec3(1.f, 0.f, 0.f), 100.f, distance);
+    Test::check(hit == meshes[0].get(), "queries: a moved mesh is hit where it went");
+}
+
+// the camera sits at the origin looking down -z, 10 meshes in front of it, 5 behind it and a group of 4 far to the side.
+// objects without bounds are drawn but counted neither as visible nor as culled
+void testCulling(void) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    GLStub::setActiveUniforms({ "PVM", "model" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+
+    SceneGraph sceneGraph;
+    const shared_ptr<SceneObject> unbounded = make_shared<SceneObject>("unbounded");
+    const shared_ptr<SceneObject> far = make_shared<SceneObject>("far", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(1000.f, 0.f, 0.f))));
+    sceneGraph.getRoot()->appendChild(unbounded);
+    sceneGraph.getRoot()->appendChild(far);
+
+    for (size_t i = 0; i < 10; i++) {
+        sceneGraph.getRoot()->appendChild(makeMesh(geometry, shader, "front", vec3((float)i - 5.f, 0.f, -20.f)));
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+        sceneGraph.getRoot()->appendChild(makeMesh(geometry, shader, "behind", vec3((float)i, 0.f, 20.f)));
+    }
+
+    // the marker has no bounds of its own and goes along with the rejected group
+    far->appendChild(make_shared<SceneObject>("marker"));
+
+    for (size_t i = 0; i < 4; i++) {
+        far->appendChild(makeMesh(geometry, shader, "side", vec3(1000.f + (float)i, 0.f, -20.f)));
+    }
+
+    const auto& visible = sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("pointer tree", sceneGraph, 10, 9);
+
+    bool onlyFront = true;
+    bool unboundedDrawn = false;
+
+    for (auto& visibleObject : visible) {
+        BoundingSphere bounds;
+        onlyFront = onlyFront && (visibleObject.first->getName() == "front" || !visibleObject.first->getBoundingSphere(bounds));
+        unboundedDrawn = unboundedDrawn || visibleObject.first == unbounded.get();
+    }
+
+    Test::check(onlyFront, "pointer tree: only meshes in front of the camera are visible");
+    Test::check(unboundedDrawn, "pointer tree: objects without bounds are drawn");
+
+    // the group comes into view through its parent alone, its children are found stale on the next cull
+    far->translate(-1000.f, 0.f, 0.f);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("pointer tree, group moved into view", sceneGraph, 14, 5);
+
+    far->translate(1000.f, 0.f, 0.f);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("pointer tree, group moved out of view", sceneGraph, 10, 9);
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(getDrawCallCount() == 10, "pointer tree: one draw call per visible mesh");
+
+    sceneGraph.flatten();
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("flattened", sceneGraph, 10, 9);
+
+    far->translate(-1000.f, 0.f, 0.f);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("flattened, group moved into view", sceneGraph, 14, 5);
+
+    far->translate(1000.f, 0.f, 0.f);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("flattened, group moved out of view", sceneGraph, 10, 9);
+
+    // children appended to a group that other nodes follow land away from its range, and go along with it all the same
+    const SceneHierarchy& hierarchy = *sceneGraph.getHierarchy();
+    const auto getNode = [&hierarchy](const shared_ptr<SceneObject>& sceneObject) {
+        size_t node = 0;
+
+        while (hierarchy.getSceneObject(node) != sceneObject) {
+            node++;
+        }
+
+        return node;
+    };
+
+    const shared_ptr<SceneObject> appendedMesh = makeMesh(geometry, shader, "side", vec3(1004.f, 0.f, -20.f));
+    const shared_ptr<SceneObject> appendedMarker = make_shared<SceneObject>("marker");
+    far->appendChild(appendedMesh);
+    far->appendChild(appendedMarker);
+    Test::check(hierarchy.getMisplacedCount() == 2, "flattened: children appended to a group in the middle are misplaced");
+    Test::check(hierarchy.isMisplaced(getNode(appendedMesh)), "flattened: a misplaced child starts a range of its own");
+
+    const auto& misplacedVisible = sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("flattened, misplaced children", sceneGraph, 10, 10);
+    Test::check(find_if(misplacedVisible.begin(), misplacedVisible.end(), [&appendedMarker](const auto& visibleObject) {
+        return visibleObject.first == appendedMarker.get();
+    }) == misplacedVisible.end(), "flattened: a misplaced child without bounds goes along with its rejected group");
+
+    sceneGraph.getHierarchy()->compact();
+    const size_t farNode = getNode(far);
+    Test::check(hierarchy.getMisplacedCount() == 0, "flattened: compact moves misplaced children in place");
+    Test::check(getNode(appendedMesh) < farNode + hierarchy.getSubtreeSize(farNode), "flattened: compacted children are in the range of their group");
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("flattened, compacted", sceneGraph, 10, 10);
+
+    far->removeChild(appendedMesh);
+    far->removeChild(appendedMarker);
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(getDrawCallCount() == 10, "flattened: one draw call per visible mesh");
+
+    sceneGraph.createSnapshotBuffer();
+    sceneGraph.publishSnapshot();
+    sceneGraph.cull(sceneGraph.getSnapshotBuffer()->acquire(), ProjectionViewMatrix);
+    sceneGraph.getSnapshotBuffer()->release();
+    checkCounts("snapshot", sceneGraph, 10, 9);
+
+    // the hierarchy tree replaces the traversal in both overloads, objects without bounds come from its own list
+    sceneGraph.buildBoundingVolumeHierarchy();
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("bounding volume hierarchy", sceneGraph, 10, 9);
+
+    far->translate(-1000.f, 0.f, 0.f);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("bounding volume hierarchy, group moved into view", sceneGraph, 14, 5);
+
+    unboundedDrawn = false;
+
+    for (auto& visibleObject : sceneGraph.cull(ProjectionViewMatrix)) {
+        unboundedDrawn = unboundedDrawn || visibleObject.first == unbounded.get();
+    }
+
+    Test::check(unboundedDrawn, "bounding volume hierarchy: objects without bounds are drawn");
+
+    // both snapshots receive the hierarchy copy before the front one is checked against the live tree
+    for (size_t i = 0; i < 2; i++) {
+        sceneGraph.publishSnapshot();
+        sceneGraph.cull(sceneGraph.getSnapshotBuffer()->acquire(), ProjectionViewMatrix);
+        sceneGraph.getSnapshotBuffer()->release();
+        checkCounts("snapshot with hierarchy, group moved into view", sceneGraph, 14, 5);
+    }
+
+    far->translate(1000.f, 0.f, 0.f);
+    sceneGraph.cull(ProjectionViewMatrix);
+    checkCounts("bounding volume hierarchy, group moved out of view", sceneGraph, 10, 9);
+
+    sceneGraph.publishSnapshot();
+    sceneGraph.cull(sceneGraph.getSnapshotBuffer()->acquire(), ProjectionViewMatrix);
+    sceneGraph.getSnapshotBuffer()->release();
+    checkCounts("snapshot with hierarchy, group moved out of view", sceneGraph, 10, 9);
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(getDrawCallCount() == 10, "bounding volume hierarchy: one draw call per visible mesh");
+
+    testAssignedGeometry(geometry, ProjectionViewMatrix, false);
+    testAssignedGeometry(geometry, ProjectionViewMatrix, true);
+    testQueries(geometry);
+}
@@ -0,0 +1,263 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+#include <GLDeletionQueue.hpp>
+
+// cpp
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// counts its destructions, wherever they run
+class TrackedMesh : public Mesh {
+public:
+    static atomic<size_t> destroyedCount;
+
+    TrackedMesh(const shared_ptr<Geometry>& geometry, const string& name, const vec3& position):
+        Mesh(geometry, name, Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position))) {
+    }
+
+    ~TrackedMesh(void) {
+        destroyedCount++;
+    }
+};
+
+atomic<size_t> TrackedMesh::destroyedCount(0);
+
+// releases dropped with a scene graph have no handle left to wait on
+static bool waitForDestroyedCount(const size_t& count) {
+    const auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+
+    while (TrackedMesh::destroyedCount < count && chrono::steady_clock::now() < deadline) {
+        this_thread::yield();
+    }
+
+    return TrackedMesh::destroyedCount == count;
+}
+
+static shared_ptr<Geometry> makeTriangle(void) {
+    return make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+}
+
+enum Structure {
+    POINTER_TREE,
+    FLATTENED,
+    BOUNDING_VOLUME_HIERARCHY
+};
+
+// 10 meshes in front of the camera next to a group of 100 meshes with a geometry of their own, and a namesake
+// of the group behind it. the group is gone for lookups and culling right away, and destroyed once released
+static void testDestroyedSubtree(const shared_ptr<Shader>& shader, const Structure& structure) {
+    const string name = structure == POINTER_TREE ? "pointer tree" : structure == FLATTENED ? "flattened hierarchy" : "bounding volume hierarchy";
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    const shared_ptr<Geometry> geometry = makeTriangle();
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < 10; i++) {
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "front", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i - 5.f, 0.f, -20.f))));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    shared_ptr<SceneObject> group = make_shared<SceneObject>("group");
+    sceneGraph.getRoot()->appendChild(group);
+    shared_ptr<Geometry> groupGeometry = makeTriangle();
+
+    for (size_t i = 0; i < 100; i++) {
+        const shared_ptr<TrackedMesh> mesh = make_shared<TrackedMesh>(groupGeometry, "grouped", vec3((float)(i % 10) - 5.f, (float)(i / 10) - 5.f, -30.f));
+        mesh->setShader(shader);
+        group->appendChild(mesh);
+    }
+
+    groupGeometry = nullptr;
+    const shared_ptr<SceneObject> namesake = make_shared<SceneObject>("group");
+    sceneGraph.getRoot()->appendChild(namesake);
+
+    if (structure == FLATTENED) {
+        sceneGraph.flatten();
+    } else if (structure == BOUNDING_VOLUME_HIERARCHY) {
+        sceneGraph.buildBoundingVolumeHierarchy();
+    }
+
+    sceneGraph.cull(ProjectionViewMatrix);
+    Test::check(sceneGraph.getVisibleCount() == 110, name + ": the group is visible before it is destroyed");
+
+    const size_t destroyed = TrackedMesh::destroyedCount;
+    const size_t pending = GLDeletionQueue::getShared().getPendingCount();
+    sceneGraph.destroySceneObject(std::move(group));
+
+    // whether or not the release already ran
+    Test::check(sceneGraph.getRoot()->getChildren().size() == 11, name + ": the destroyed object leaves its parent right away");
+    Test::check(sceneGraph.getRoot()->getChildren()[10] == namesake, name + ": the last sibling takes its place");
+    Test::check(sceneGraph.getSceneObject("group") == namesake, name + ": lookups pass over the destroyed object right away");
+    Test::check(sceneGraph.getSceneObject("grouped") == nullptr, name + ": lookups pass over its descendants right away");
+    sceneGraph.cull(ProjectionViewMatrix);
+    Test::check(sceneGraph.getVisibleCount() == 10, name + ": culling passes over the destroyed subtree right away");
+
+    // the hierarchy drops the released range on the next propagation, which hands its objects to a worker as well
+    sceneGraph.waitForReleases();
+    sceneGraph.propagateTransforms();
+    sceneGraph.waitForReleases();
+
+    Test::check(TrackedMesh::destroyedCount - destroyed == 100, name + ": the subtree is destroyed once released");
+    Test::check(GLDeletionQueue::getShared().getPendingCount() > pending, name + ": GL objects of the subtree are queued for deletion");
+
+    if (structure == FLATTENED) {
+        const shared_ptr<SceneHierarchy>& hierarchy = sceneGraph.getHierarchy();
+        Test::check(hierarchy->size() == 12 && hierarchy->getReleasedCount() == 0, name + ": the released range is dropped from the flat arrays");
+        Test::check(hierarchy->getSceneObject(hierarchy->findNode("group")) == namesake, name + ": nodes behind the dropped range are found");
+    } else if (structure == BOUNDING_VOLUME_HIERARCHY) {
+        Test::check(sceneGraph.getBoundingVolumeHierarchy()->size() == 10, name + ": released leaves leave the bounding volume hierarchy");
+    }
+
+    // scene graphs of earlier tests may still be queueing their own deletions
+    const size_t freed = GLDeletionQueue::getShared().getFreedCount();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(GLDeletionQueue::getShared().getFreedCount() > freed, name + ": the next draw deletes them");
+    Test::check(sceneGraph.getVisibleCount() == 10, name + ": the rest of the scene is drawn as before");
+}
+
+// a few released nodes stay in the flat arrays, skipped by every pass, until enough of them were released
+static void testReleasedRange(const shared_ptr<Shader>& shader) {
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    const shared_ptr<Geometry> geometry = makeTriangle();
+    SceneGraph sceneGraph;
+    vector<shared_ptr<SceneObject>> groups;
+
+    for (size_t i = 0; i < 10; i++) {
+        groups.push_back(make_shared<SceneObject>("group"));
+        sceneGraph.getRoot()->appendChild(groups.back());
+
+        for (size_t j = 0; j < 3; j++) {
+            const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i - 5.f, (float)j, -20.f))));
+            mesh->setShader(shader);
+            groups.back()->appendChild(mesh);
+        }
+    }
+
+    sceneGraph.flatten();
+    sceneGraph.propagateTransforms(3);
+
+    // a group in the middle, so nodes behind the range are visited after it is skipped
+    sceneGraph.destroySceneObject(std::move(groups[4]));
+    groups[5]->update(Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(0.f, 100.f, 0.f))));
+    sceneGraph.propagateTransforms(3);
+    sceneGraph.waitForReleases();
+
+    const shared_ptr<SceneHierarchy>& hierarchy = sceneGraph.getHierarchy();
+    Test::check(hierarchy->size() == 41 && hierarchy->getReleasedCount() == 4, "released range: a few released nodes stay in place");
+    Test::check(abs(hierarchy->getWorldTransform(hierarchy->findNode("group") + 21).getMatrix()[3].y - 100.f) < 1e-4f, "released range: nodes behind it are propagated");
+
+    sceneGraph.cull(ProjectionViewMatrix);
+    Test::check(sceneGraph.getVisibleCount() == 24, "released range: culling skips it");
+
+    // 4 more groups bring the released nodes past a quarter of the arrays
+    for (size_t i = 6; i < 10; i++) {
+        sceneGraph.destroySceneObject(std::move(groups[i]));
+    }
+
+    sceneGraph.cull(ProjectionViewMatrix);
+    Test::check(hierarchy->size() == 21 && hierarchy->getReleasedCount() == 0, "released range: enough released nodes are dropped at once");
+    Test::check(sceneGraph.getVisibleCount() == 12, "released range: the remaining nodes are drawn as before");
+}
+
+// objects referenced from outside outlive their scene graph where they were, everything else goes with it
+static void testSurvivors(const shared_ptr<Shader>& shader, const bool& flattened) {
+    const string name = flattened ? "survivors, flattened with snapshots" : "survivors, pointer tree";
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    const shared_ptr<Geometry> geometry = makeTriangle();
+    const size_t destroyed = TrackedMesh::destroyedCount;
+    shared_ptr<TrackedMesh> survivor = nullptr;
+
+    {
+        SceneGraph sceneGraph;
+        const shared_ptr<SceneObject> group = make_shared<SceneObject>("group");
+        sceneGraph.getRoot()->appendChild(group);
+
+        for (size_t i = 0; i < 20; i++) {
+            const shared_ptr<TrackedMesh> mesh = make_shared<TrackedMesh>(geometry, "mesh", vec3((float)i, 0.f, -20.f));
+            mesh->setShader(shader);
+            group->appendChild(mesh);
+
+            if (i == 7) {
+                survivor = mesh;
+                survivor->appendChild(make_shared<TrackedMesh>(geometry, "child", vec3((float)i, 1.f, -20.f)));
+            }
+        }
+
+        // moves the survivor along, so its world transform differs from its local one
+        group->update(Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3(5.f, 0.f, 0.f))));
+
+        if (flattened) {
+            sceneGraph.flatten();
+            sceneGraph.buildBoundingVolumeHierarchy();
+            sceneGraph.createSnapshotBuffer();
+            sceneGraph.publishSnapshot();
+            sceneGraph.publishSnapshot();
+        }
+
+        sceneGraph.draw(ProjectionViewMatrix);
+    }
+
+    Test::check(waitForDestroyedCount(destroyed + 19), name + ": objects only the scene graph referred to are destroyed");
+    Test::check(survivor->getParent() == nullptr && survivor->getChildren().size() == 1, name + ": the survivor is detached with its subtree");
+    Test::check(distance(vec3(survivor->getWorldTransform().getMatrix()[3]), vec3(12.f, 0.f, -20.f)) < 1e-4f, name + ": the survivor keeps its world transform");
+    Test::check(distance(vec3(survivor->getChildren()[0]->getWorldTransform().getMatrix()[3]), vec3(12.f, 1.f, -20.f)) < 1e-4f, name + ": its descendants keep theirs");
+
+    // no pointer into the structures of the old scene graph is left
+    SceneGraph sceneGraph;
+    sceneGraph.getRoot()->appendChild(survivor);
+    sceneGraph.buildBoundingVolumeHierarchy();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(sceneGraph.getSceneObject("child") == survivor->getChildren()[0], name + ": the survivor is indexed by the next scene graph");
+    Test::check(sceneGraph.getVisibleCount() == 2 && sceneGraph.getBoundingVolumeHierarchy()->size() == 2, name + ": and drawn by it");
+}
+
+// the buffer of a scene graph released in the background is destroyed on a worker, which has no GL context
+static void testWorldMatrixBufferRelease(const shared_ptr<Shader>& shader) {
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    const shared_ptr<Geometry> geometry = makeTriangle();
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < 10; i++) {
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i - 5.f, 0.f, -20.f))));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    // a fence on every region
+    sceneGraph.createWorldMatrixBuffer(WorldMatrixBuffer::MATRIX);
+    for (size_t i = 0; i < WorldMatrixBuffer::REGION_COUNT; i++) {
+        sceneGraph.draw(ProjectionViewMatrix);
+    }
+
+    shared_ptr<WorldMatrixBuffer> worldMatrixBuffer = sceneGraph.getWorldMatrixBuffer();
+    sceneGraph.createWorldMatrixBuffer(WorldMatrixBuffer::DUAL_QUATERNION_SCALE);
+    GLStub::reset();
+    worldMatrixBuffer = nullptr;
+
+    size_t calls = 0;
+    for (auto& call : GLStub::getCalls()) {
+        calls += call.second;
+    }
+
+    Test::check(calls == 0, "world matrix buffer: destroying it calls no GL function");
+
+    GLDeletionQueue::getShared().flush();
+    Test::check(GLStub::getCallCount("glDeleteSync") == WorldMatrixBuffer::REGION_COUNT, "world matrix buffer: its fences are deleted by the next flush");
+    Test::check(GLStub::getCallCount("glDeleteBuffers") == 1 && GLStub::getCallCount("glClientWaitSync") == 0, "world matrix buffer: and its buffer, without waiting on them");
+}
+
+void testDestroy(void) {
+    GLStub::setActiveUniforms({ "PVM", "model" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+
+    testDestroyedSubtree(shader, POINTER_TREE);
+    testDestroyedSubtree(shader, FLATTENED);
+    testDestroyedSubtree(shader, BOUNDING_VOLUME_HIERARCHY);
+    testReleasedRange(shader);
+    testSurvivors(shader, false);
+    testSurvivors(shader, true);
+    testWorldMatrixBufferRelease(shader);
+}
@@ -0,0 +1,130 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <random>
+#include <vector>
+
+static const size_t TRANSFORM_COUNT = 10000;
+
+// the reconstruction of WorldMatrixBuffer::getShaderSource on the CPU, scale is null for the uniform scale layout
+static mat4 unpack(const vec4& r, const vec4& d, const vec4* scale) {
+    const float n = dot(r, r);
+    const vec3 s = scale != nullptr ? vec3(*scale) / n : vec3(1.f);
+    const vec3 t = 2.f * (r.w * vec3(d) - d.w * vec3(r) + cross(vec3(r), vec3(d))) / n;
+
+    return mat4(
+        vec4(r.w * r.w + r.x * r.x - r.y * r.y - r.z * r.z, 2.f * (r.x * r.y + r.w * r.z), 2.f * (r.x * r.z - r.w * r.y), 0.f) * s.x,
+        vec4(2.f * (r.x * r.y - r.w * r.z), r.w * r.w - r.x * r.x + r.y * r.y - r.z * r.z, 2.f * (r.y * r.z + r.w * r.x), 0.f) * s.y,
+        vec4(2.f * (r.x * r.z + r.w * r.y), 2.f * (r.y * r.z - r.w * r.x), r.w * r.w - r.x * r.x - r.y * r.y + r.z * r.z, 0.f) * s.z,
+        vec4(t, 1.f)
+    );
+}
+
+static float getLargestDifference(const mat4& a, const mat4& b) {
+    float difference = 0.f;
+
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            difference = std::max(difference, abs(a[column][row] - b[column][row]));
+        }
+    }
+
+    return difference;
+}
+
+static fquat makeRotation(mt19937& generator) {
+    uniform_real_distribution<float> unit(-1.f, 1.f);
+    const fquat rotation(unit(generator), unit(generator), unit(generator), unit(generator));
+    return length(rotation) > 0.01f ? normalize(rotation) : fquat(1.f, 0.f, 0.f, 0.f);
+}
+
+// both layouts rebuild the matrix of the transform, including real parts that drifted from unit length
+static void testPacking(void) {
+    mt19937 generator(11);
+    uniform_real_distribution<float> position(-100.f, 100.f);
+    uniform_real_distribution<float> scale(0.1f, 10.f);
+    uniform_real_distribution<float> drift(0.99f, 1.01f);
+    float scaleError = 0.f;
+    float scaledError = 0.f;
+    float driftError = 0.f;
+
+    for (size_t i = 0; i < TRANSFORM_COUNT; i++) {
+        const fdualquat translationAndRotation(makeRotation(generator), vec3(position(generator), position(generator), position(generator)));
+        const vec3 nonUniform(scale(generator), scale(generator), scale(generator));
+        const float uniform = scale(generator);
+        vec4 packed[3];
+
+        // matrix entries reach the translation of up to 100, errors are relative to that
+        const mat4 expected = Transform(translationAndRotation, nonUniform).getMatrix();
+        packDualQuaternionScale(translationAndRotation, nonUniform, packed);
+        scaleError = std::max(scaleError, getLargestDifference(unpack(packed[0], packed[1], &packed[2]), expected) / 100.f);
+
+        const mat4 expectedUniform = Transform(translationAndRotation, vec3(uniform)).getMatrix();
+        packScaledDualQuaternion(translationAndRotation, uniform, packed);
+        scaledError = std::max(scaledError, getLargestDifference(unpack(packed[0], packed[1], nullptr), expectedUniform) / 100.f);
+
+        const float drifted = drift(generator);
+        packScaledDualQuaternion(fdualquat(translationAndRotation.real * drifted, translationAndRotation.dual * drifted), uniform, packed);
+        driftError = std::max(driftError, getLargestDifference(unpack(packed[0], packed[1], nullptr), expectedUniform) / 100.f);
+    }
+
+    Test::check(scaleError < 1e-5f, "dual quaternions: dual quaternion and scale rebuild the matrix");
+    Test::check(scaledError < 1e-5f, "dual quaternions: scaled dual quaternions rebuild the matrix");
+    Test::check(driftError < 1e-5f, "dual quaternions: drifted real parts are renormalized");
+}
+
+// the queue writes the same transforms as dual quaternions as it does as matrices, packet by packet
+static void testQueuedTransforms(void) {
+    mt19937 generator(13);
+    uniform_real_distribution<float> position(-10.f, 10.f);
+    uniform_real_distribution<float> scale(0.5f, 2.f);
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(
+        vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) })
+    );
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+
+    for (const bool uniformScale : { false, true }) {
+        SceneGraph sceneGraph;
+        shared_ptr<SceneObject> parent = sceneGraph.getRoot();
+
+        // nested, so world transforms compose rotations, translations and scales
+        for (size_t i = 0; i < 20; i++) {
+            const float uniform = scale(generator);
+            const vec3 meshScale = uniformScale ? vec3(uniform) : vec3(scale(generator), scale(generator), scale(generator));
+            const vec3 translation(position(generator), position(generator), position(generator) - 40.f);
+            const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(makeRotation(generator), translation), meshScale));
+            mesh->setShader(shader);
+            (i % 4 == 0 ? sceneGraph.getRoot() : parent)->appendChild(mesh);
+            parent = mesh;
+        }
+
+        sceneGraph.draw(perspective(radians(90.f), 1.f, 0.1f, 1000.f));
+        const RenderQueue& renderQueue = sceneGraph.getRenderQueue();
+        vector<mat4> models(renderQueue.size());
+        vector<vec4> packed(renderQueue.size() * 3);
+        renderQueue.writeModelMatrices(models.data());
+        renderQueue.writeDualQuaternions(packed.data(), uniformScale);
+
+        float error = 0.f;
+        float largest = 1.f;
+        for (size_t i = 0; i < models.size(); i++) {
+            const mat4 unpacked = uniformScale ? unpack(packed[i * 2], packed[i * 2 + 1], nullptr) : unpack(packed[i * 3], packed[i * 3 + 1], &packed[i * 3 + 2]);
+            error = std::max(error, getLargestDifference(unpacked, models[i]));
+            largest = std::max(largest, getLargestDifference(models[i], mat4(0.f)));
+        }
+
+        Test::check(
+            models.size() == 21 && error / largest < 1e-5f,
+            uniformScale ? "dual quaternions: scaled packets match their model matrices" : "dual quaternions: packets with scale match their model matrices"
+        );
+    }
+}
+
+void testDualQuaternions(void) {
+    testPacking();
+    testQueuedTransforms();
+}
@@ -0,0 +1,422 @@
+#include <GLStub.hpp>
+
+// cpp
+#include <cstring>
+#include <fstream>
+
+static map<string, size_t> calls;
+static vector<DrawElementsIndirectCommand> indirectCommands;
+static GLuint nextName = 1;
+static vector<string> activeUniforms = { "PVM", "model", "PV" };
+static map<GLuint, vector<string>> programUniforms;
+static map<GLenum, GLuint> boundBuffers;
+static map<GLuint, vector<unsigned char>> bufferContents;
+static const string vertexShaderPath = "GLStub.vert";
+static const string fragmentShaderPath = "GLStub.frag";
+
+static void record(const char* function) {
+    calls[function]++;
+}
+
+static vector<unsigned char>& getBoundContents(const GLenum& target) {
+    return bufferContents[boundBuffers[target]];
+}
+
+static void storeBufferData(const GLenum& target, const GLintptr& offset, const GLsizeiptr& size, const void* data) {
+    vector<unsigned char>& contents = getBoundContents(target);
+
+    if (contents.size() < (size_t)(offset + size)) {
+        contents.resize((size_t)(offset + size), 0);
+    }
+
+    if (data != nullptr && size > 0) {
+        memcpy(contents.data() + offset, data, (size_t)size);
+    }
+}
+
+static GLuint APIENTRY stubCreateShader(GLenum type) {
+    record("glCreateShader");
+    return nextName++;
+}
+
+static void APIENTRY stubShaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* lengths) {
+    record("glShaderSource");
+}
+
+static void APIENTRY stubCompileShader(GLuint shader) {
+    record("glCompileShader");
+}
+
+static void APIENTRY stubGetShaderiv(GLuint shader, GLenum name, GLint* value) {
+    record("glGetShaderiv");
+    *value = GL_TRUE;
+}
+
+static void APIENTRY stubGetShaderInfoLog(GLuint shader, GLsizei size, GLsizei* length, GLchar* log) {
+    record("glGetShaderInfoLog");
+    log[0] = '\0';
+}
+
+static GLuint APIENTRY stubCreateProgram(void) {
+    record("glCreateProgram");
+    programUniforms[nextName] = activeUniforms;
+    return nextName++;
+}
+
+static void APIENTRY stubGetProgramiv(GLuint program, GLenum name, GLint* value) {
+    record("glGetProgramiv");
+    const vector<string>& uniforms = programUniforms[program];
+
+    switch (name) {
+    case GL_ACTIVE_UNIFORMS:
+        *value = (GLint)uniforms.size();
+        break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+        *value = 1;
+        for (auto& uniform : uniforms) {
+            *value = glm::max(*value, (GLint)uniform.size() + 1);
+        }
+        break;
+    case GL_PROGRAM_BINARY_LENGTH:
+        *value = 8;
+        break;
+    case GL_DELETE_STATUS:
+        *value = GL_FALSE;
+        break;
+    default:
+        *value = GL_TRUE;
+        break;
+    }
+}
+
+static void APIENTRY stubGetProgramInfoLog(GLuint program, GLsizei size, GLsizei* length, GLchar* log) {
+    record("glGetProgramInfoLog");
+    log[0] = '\0';
+}
+
+static void APIENTRY stubAttachShader(GLuint program, GLuint shader) {
+    record("glAttachShader");
+}
+
+static void APIENTRY stubDetachShader(GLuint program, GLuint shader) {
+    record("glDetachShader");
+}
+
+static void APIENTRY stubLinkProgram(GLuint program) {
+    record("glLinkProgram");
+}
+
+static void APIENTRY stubDeleteShader(GLuint shader) {
+    record("glDeleteShader");
+}
+
+static void APIENTRY stubDeleteProgram(GLuint program) {
+    record("glDeleteProgram");
+}
+
+static GLboolean APIENTRY stubIsProgram(GLuint program) {
+    record("glIsProgram");
+    return GL_TRUE;
+}
+
+static void APIENTRY stubUseProgram(GLuint program) {
+    record("glUseProgram");
+}
+
+static void APIENTRY stubGetActiveUniform(GLuint program, GLuint index, GLsizei size, GLsizei* length, GLint* count, GLenum* type, GLchar* name) {
+    record("glGetActiveUniform");
+    const string& uniform = programUniforms[program][index];
+
+    *length = (GLsizei)glm::min(uniform.size(), (size_t)size - 1);
+    memcpy(name, uniform.c_str(), *length);
+    name[*length] = '\0';
+    *count = 1;
+    *type = GL_FLOAT_MAT4;
+}
+
+static GLint APIENTRY stubGetUniformLocation(GLuint program, const GLchar* name) {
+    record("glGetUniformLocation");
+    const vector<string>& uniforms = programUniforms[program];
+
+    for (size_t i = 0; i < uniforms.size(); i++) {
+        if (uniforms[i] == name) {
+            return (GLint)i;
+        }
+    }
+
+    return -1;
+}
+
+static GLuint APIENTRY stubGetUniformBlockIndex(GLuint program, const GLchar* name) {
+    record("glGetUniformBlockIndex");
+    return GL_INVALID_INDEX;
+}
+
+static void APIENTRY stubUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    record("glUniformMatrix4fv");
+}
+
+static void APIENTRY stubUniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+    record("glUniform4fv");
+}
+
+static void APIENTRY stubProgramParameteri(GLuint program, GLenum name, GLint value) {
+    record("glProgramParameteri");
+}
+
+static void APIENTRY stubGetProgramBinary(GLuint program, GLsizei size, GLsizei* length, GLenum* format, void* binary) {
+    record("glGetProgramBinary");
+    *length = glm::min(size, 8);
+    *format = 1;
+    memset(binary, 0, *length);
+}
+
+static void APIENTRY stubProgramBinary(GLuint program, GLenum format, const void* binary, GLsizei length) {
+    record("glProgramBinary");
+}
+
+static void APIENTRY stubGenVertexArrays(GLsizei count, GLuint* names) {
+    record("glGenVertexArrays");
+
+    for (GLsizei i = 0; i < count; i++) {
+        names[i] = nextName++;
+    }
+}
+
+static void APIENTRY stubGenBuffers(GLsizei count, GLuint* names) {
+    record("glGenBuffers");
+
+    for (GLsizei i = 0; i < count; i++) {
+        names[i] = nextName++;
+    }
+}
+
+static void APIENTRY stubBindVertexArray(GLuint vertexArray) {
+    record("glBindVertexArray");
+}
+
+static void APIENTRY stubBindBuffer(GLenum target, GLuint buffer) {
+    record("glBindBuffer");
+    boundBuffers[target] = buffer;
+}
+
+static void APIENTRY stubBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    record("glBindBufferBase");
+    boundBuffers[target] = buffer;
+}
+
+static void APIENTRY stubBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    record("glBindBufferRange");
+    boundBuffers[target] = buffer;
+}
+
+static void APIENTRY stubBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    record("glBufferData");
+    getBoundContents(target).clear();
+    storeBufferData(target, 0, size, data);
+}
+
+static void APIENTRY stubBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    record("glBufferSubData");
+    storeBufferData(target, offset, size, data);
+}
+
+static void APIENTRY stubCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+    record("glCopyBufferSubData");
+    const vector<unsigned char> source = getBoundContents(readTarget);
+    storeBufferData(writeTarget, writeOffset, size, source.size() >= (size_t)(readOffset + size) ? source.data() + readOffset : nullptr);
+}
+
+static void APIENTRY stubBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+    record("glBufferStorage");
+    getBoundContents(target).clear();
+    storeBufferData(target, 0, size, data);
+}
+
+static void* APIENTRY stubMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    record("glMapBufferRange");
+    return getBoundContents(target).data() + offset;
+}
+
+static GLboolean APIENTRY stubUnmapBuffer(GLenum target) {
+    record("glUnmapBuffer");
+    return GL_TRUE;
+}
+
+static void APIENTRY stubEnableVertexAttribArray(GLuint index) {
+    record("glEnableVertexAttribArray");
+}
+
+static void APIENTRY stubVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+    record("glVertexAttribPointer");
+}
+
+static void APIENTRY stubVertexAttribDivisor(GLuint index, GLuint divisor) {
+    record("glVertexAttribDivisor");
+}
+
+static void APIENTRY stubDeleteVertexArrays(GLsizei count, const GLuint* names) {
+    record("glDeleteVertexArrays");
+}
+
+static void APIENTRY stubDeleteBuffers(GLsizei count, const GLuint* names) {
+    record("glDeleteBuffers");
+
+    for (GLsizei i = 0; i < count; i++) {
+        bufferContents.erase(names[i]);
+    }
+}
+
+static void APIENTRY stubDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    record("glDrawArrays");
+}
+
+static void APIENTRY stubDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    record("glDrawElements");
+}
+
+static void APIENTRY stubDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex) {
+    record("glDrawElementsBaseVertex");
+}
+
+static void APIENTRY stubDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount) {
+    record("glDrawElementsInstanced");
+}
+
+static void APIENTRY stubDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLint baseVertex) {
+    record("glDrawElementsInstancedBaseVertex");
+}
+
+static void APIENTRY stubDrawElementsInstancedBaseInstance(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLuint baseInstance) {
+    record("glDrawElementsInstancedBaseInstance");
+}
+
+static void APIENTRY stubDrawElementsInstancedBaseVertexBaseInstance(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLint baseVertex, GLuint baseInstance) {
+    record("glDrawElementsInstancedBaseVertexBaseInstance");
+}
+
+static void APIENTRY stubMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride) {
+    record("glMultiDrawElementsIndirect");
+    // commands are read from the bound indirect buffer, the pointer is an offset into it
+    const vector<unsigned char>& contents = getBoundContents(GL_DRAW_INDIRECT_BUFFER);
+    const size_t step = stride != 0 ? (size_t)stride : sizeof(DrawElementsIndirectCommand);
+
+    for (GLsizei i = 0; i < drawCount; i++) {
+        DrawElementsIndirectCommand command;
+        memcpy(&command, contents.data() + (size_t)indirect + i * step, sizeof(DrawElementsIndirectCommand));
+        indirectCommands.push_back(command);
+    }
+}
+
+static GLsync APIENTRY stubFenceSync(GLenum condition, GLbitfield flags) {
+    record("glFenceSync");
+    return (GLsync)(size_t)nextName++;
+}
+
+static GLenum APIENTRY stubClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    record("glClientWaitSync");
+    return GL_ALREADY_SIGNALED;
+}
+
+static void APIENTRY stubDeleteSync(GLsync sync) {
+    record("glDeleteSync");
+}
+
+static const GLubyte* APIENTRY stubGetString(GLenum name) {
+    record("glGetString");
+    return (const GLubyte*)"GLStub";
+}
+
+static void APIENTRY stubGetIntegerv(GLenum name, GLint* value) {
+    record("glGetIntegerv");
+    *value = 1;
+}
+
+void GLStub::install(void) {
+    glad_glCreateShader = stubCreateShader;
+    glad_glShaderSource = stubShaderSource;
+    glad_glCompileShader = stubCompileShader;
+    glad_glGetShaderiv = stubGetShaderiv;
+    glad_glGetShaderInfoLog = stubGetShaderInfoLog;
+    glad_glCreateProgram = stubCreateProgram;
+    glad_glGetProgramiv = stubGetProgramiv;
+    glad_glGetProgramInfoLog = stubGetProgramInfoLog;
+    glad_glAttachShader = stubAttachShader;
+    glad_glDetachShader = stubDetachShader;
+    glad_glLinkProgram = stubLinkProgram;
+    glad_glDeleteShader = stubDeleteShader;
+    glad_glDeleteProgram = stubDeleteProgram;
+    glad_glIsProgram = stubIsProgram;
+    glad_glUseProgram = stubUseProgram;
+    glad_glGetActiveUniform = stubGetActiveUniform;
+    glad_glGetUniformLocation = stubGetUniformLocation;
+    glad_glGetUniformBlockIndex = stubGetUniformBlockIndex;
+    glad_glUniformMatrix4fv = stubUniformMatrix4fv;
+    glad_glUniform4fv = stubUniform4fv;
+    glad_glProgramParameteri = stubProgramParameteri;
+    glad_glGetProgramBinary = stubGetProgramBinary;
+    glad_glProgramBinary = stubProgramBinary;
+    glad_glGenVertexArrays = stubGenVertexArrays;
+    glad_glGenBuffers = stubGenBuffers;
+    glad_glBindVertexArray = stubBindVertexArray;
+    glad_glBindBuffer = stubBindBuffer;
+    glad_glBindBufferBase = stubBindBufferBase;
+    glad_glBindBufferRange = stubBindBufferRange;
+    glad_glBufferData = stubBufferData;
+    glad_glBufferSubData = stubBufferSubData;
+    glad_glCopyBufferSubData = stubCopyBufferSubData;
+    glad_glBufferStorage = stubBufferStorage;
+    glad_glMapBufferRange = stubMapBufferRange;
+    glad_glUnmapBuffer = stubUnmapBuffer;
+    glad_glEnableVertexAttribArray = stubEnableVertexAttribArray;
+    glad_glVertexAttribPointer = stubVertexAttribPointer;
+    glad_glVertexAttribDivisor = stubVertexAttribDivisor;
+    glad_glDeleteVertexArrays = stubDeleteVertexArrays;
+    glad_glDeleteBuffers = stubDeleteBuffers;
+    glad_glDrawArrays = stubDrawArrays;
+    glad_glDrawElements = stubDrawElements;
+    glad_glDrawElementsBaseVertex = stubDrawElementsBaseVertex;
+    glad_glDrawElementsInstanced = stubDrawElementsInstanced;
+    glad_glDrawElementsInstancedBaseVertex = stubDrawElementsInstancedBaseVertex;
+    glad_glDrawElementsInstancedBaseInstance = stubDrawElementsInstancedBaseInstance;
+    glad_glDrawElementsInstancedBaseVertexBaseInstance = stubDrawElementsInstancedBaseVertexBaseInstance;
+    glad_glMultiDrawElementsIndirect = stubMultiDrawElementsIndirect;
+    glad_glFenceSync = stubFenceSync;
+    glad_glClientWaitSync = stubClientWaitSync;
+    glad_glDeleteSync = stubDeleteSync;
+    glad_glGetString = stubGetString;
+    glad_glGetIntegerv = stubGetIntegerv;
+
+    ofstream(vertexShaderPath) << "stub vertex shader" << endl;
+    ofstream(fragmentShaderPath) << "stub fragment shader" << endl;
+}
+
+void GLStub::reset(void) {
+    calls.clear();
+    indirectCommands.clear();
+}
+
+size_t GLStub::getCallCount(const string& function) noexcept {
+    auto entry = calls.find(function);
+    return entry != calls.end() ? entry->second : 0;
+}
+
+const map<string, size_t>& GLStub::getCalls(void) noexcept {
+    return calls;
+}
+
+const vector<DrawElementsIndirectCommand>& GLStub::getIndirectCommands(void) noexcept {
+    return indirectCommands;
+}
+
+void GLStub::setActiveUniforms(const vector<string>& names) {
+    activeUniforms = names;
+}
+
+const string& GLStub::getVertexShaderPath(void) noexcept {
+    return vertexShaderPath;
+}
+
+const string& GLStub::getFragmentShaderPath(void) noexcept {
+    return fragmentShaderPath;
+}
@@ -0,0 +1,145 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+// an arena mesh that still has to be drawn by instancing, as a mesh with its own model per draw would
+class NonIndirectMesh : public Mesh {
+public:
+    NonIndirectMesh(const shared_ptr<Geometry>& geometry, const string& name) : Mesh(geometry, name) {}
+
+    bool getIndirectDraw(const CachedTransform& worldTransform, DrawElementsIndirectCommand& command, mat4& model) const override {
+        return false;
+    }
+};
+
+static shared_ptr<Geometry> makeTriangle(const float& size, const shared_ptr<GeometryArena>& arena) {
+    return make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(size, 0.f, 0.f)), Vertex(vec3(0.f, size, 0.f)) }), arena);
+}
+
+static bool matchesGeometry(const DrawElementsIndirectCommand& command, const Geometry& geometry) {
+    DrawElementsIndirectCommand expected;
+    geometry.getDrawCommand(expected);
+    return command.count == expected.count && command.firstIndex == expected.firstIndex && command.baseVertex == expected.baseVertex;
+}
+
+// meshes of one arena are drawn by a single multi draw, neighbouring meshes of the same geometry as one command
+static void testCommands(const shared_ptr<Shader>& shader) {
+    const shared_ptr<GeometryArena> arena = make_shared<GeometryArena>(VertexFormat(), 1024, 3072);
+    const vector<shared_ptr<Geometry>> geometries = { makeTriangle(1.f, arena), makeTriangle(2.f, arena), makeTriangle(3.f, arena) };
+    const size_t counts[3] = { 4, 3, 2 };
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    SceneGraph sceneGraph;
+
+    // each geometry at its own depth, so sorting front to back keeps them grouped
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < counts[i]; j++) {
+            const vec3 position((float)j - 2.f, 0.f, -10.f * (float)(i + 1));
+            const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometries[i], "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+            mesh->setShader(shader);
+            sceneGraph.getRoot()->appendChild(mesh);
+        }
+    }
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    const vector<DrawElementsIndirectCommand>& commands = GLStub::getIndirectCommands();
+
+    Test::check(GLStub::getCallCount("glMultiDrawElementsIndirect") == 1, "indirect commands: one multi draw for the arena");
+    Test::check(sceneGraph.getRenderQueue().getCommandCount() == 3 && commands.size() == 3, "indirect commands: one command per geometry");
+
+    if (commands.size() == 3) {
+        GLuint baseInstance = 0;
+        bool matching = true;
+
+        for (size_t i = 0; i < 3; i++) {
+            matching = matching && matchesGeometry(commands[i], *geometries[i]);
+            matching = matching && commands[i].instanceCount == counts[i] && commands[i].baseInstance == baseInstance;
+            baseInstance += (GLuint)counts[i];
+        }
+
+        Test::check(matching, "indirect commands: ranges from the arena, instances counted in order");
+    }
+}
+
+// geometry sorts above depth, so meshes of K geometries at interleaved depths still make K commands
+static void testInterleavedDepths(const shared_ptr<Shader>& shader) {
+    const size_t meshCount = 48;
+    const size_t geometryCount = 4;
+    const shared_ptr<GeometryArena> arena = make_shared<GeometryArena>(VertexFormat(), 1024, 3072);
+    vector<shared_ptr<Geometry>> geometries;
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < geometryCount; i++) {
+        geometries.push_back(makeTriangle(1.f + (float)i, arena));
+    }
+
+    // every next mesh a step further away and of the next geometry
+    for (size_t i = 0; i < meshCount; i++) {
+        const vec3 position(0.f, 0.f, -2.f - (float)i);
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometries[i % geometryCount], "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    const vector<DrawElementsIndirectCommand>& commands = GLStub::getIndirectCommands();
+
+    Test::check(GLStub::getCallCount("glMultiDrawElementsIndirect") == 1, "interleaved depths: one multi draw for the arena");
+    Test::check(sceneGraph.getRenderQueue().getCommandCount() == geometryCount && commands.size() == geometryCount, "interleaved depths: one command per geometry");
+
+    bool instanced = commands.size() == geometryCount;
+    for (auto& command : commands) {
+        instanced = instanced && command.instanceCount == meshCount / geometryCount;
+    }
+
+    Test::check(instanced, "interleaved depths: every mesh of a geometry is an instance of its command");
+}
+
+// a packet that cannot be drawn indirectly splits the commands around it and is still drawn
+static void testMixedBatch(const shared_ptr<Shader>& shader) {
+    const shared_ptr<GeometryArena> arena = make_shared<GeometryArena>(VertexFormat(), 1024, 3072);
+    const shared_ptr<Geometry> first = makeTriangle(1.f, arena);
+    const shared_ptr<Geometry> second = makeTriangle(2.f, arena);
+    Mesh firstMesh(first, "first");
+    Mesh secondMesh(first, "second");
+    NonIndirectMesh nonIndirectMesh(first, "non indirect");
+    Mesh lastMesh(second, "last");
+    const vector<Mesh*> meshes = { &firstMesh, &secondMesh, &nonIndirectMesh, &lastMesh };
+    const CachedTransform worldTransform;
+    RenderQueue renderQueue;
+
+    for (auto& mesh : meshes) {
+        mesh->setShader(shader);
+        renderQueue.push(0, mesh, &worldTransform, arena.get(), shader->getId(), first->getVAO());
+    }
+
+    GLStub::reset();
+    renderQueue.submit(mat4(1.f));
+    const vector<DrawElementsIndirectCommand>& commands = GLStub::getIndirectCommands();
+
+    GLuint indirectInstances = 0;
+    for (auto& command : commands) {
+        indirectInstances += command.instanceCount;
+    }
+
+    Test::check(renderQueue.getDrawCount() == 3, "mixed batch: commands before, the packet alone, commands after");
+    Test::check(GLStub::getCallCount("glMultiDrawElementsIndirect") == 2 && commands.size() == 2, "mixed batch: the commands are split at the packet");
+    Test::check(GLStub::getCallCount("glDrawElementsInstancedBaseVertex") == 1, "mixed batch: the packet is drawn by instancing");
+    Test::check(indirectInstances + 1 == meshes.size(), "mixed batch: no packet is dropped");
+    Test::check(commands.size() == 2 && matchesGeometry(commands[1], *second) && commands[1].baseInstance == 0, "mixed batch: later commands start over");
+}
+
+void testIndirect(void) {
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+
+    testCommands(shader);
+    testInterleavedDepths(shader);
+    testMixedBatch(shader);
+}
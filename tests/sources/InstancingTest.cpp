@@ -0,0 +1,79 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static const size_t LARGE_MESH_COUNT = 100000;
+
+static shared_ptr<Geometry> makeTriangle(const float& size) {
+    return make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(size, 0.f, 0.f)), Vertex(vec3(0.f, size, 0.f)) }));
+}
+
+static shared_ptr<Shader> makeShader(const vector<string>& activeUniforms) {
+    GLStub::setActiveUniforms(activeUniforms);
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+    return shader;
+}
+
+static void appendMeshes(SceneGraph& sceneGraph, const shared_ptr<Geometry>& geometry, const shared_ptr<Shader>& shader, const size_t& count) {
+    for (size_t i = 0; i < count; i++) {
+        const vec3 position((float)(i % 100) - 50.f, (float)(i / 100 % 100) - 50.f, -100.f);
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), position)));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+}
+
+static size_t getInstancedDrawCount(void) {
+    return GLStub::getCallCount("glDrawElementsInstanced") + GLStub::getCallCount("glDrawArraysInstanced");
+}
+
+// one instanced draw per geometry and shader pair, shaders without the PV uniform draw every mesh alone
+void testInstancing(void) {
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 1000.f);
+    const shared_ptr<Geometry> first = makeTriangle(1.f);
+    const shared_ptr<Geometry> second = makeTriangle(2.f);
+    const shared_ptr<Shader> instancing = makeShader({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> otherInstancing = makeShader({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> individual = makeShader({ "PVM", "model" });
+
+    {
+        SceneGraph sceneGraph;
+        appendMeshes(sceneGraph, first, instancing, 100);
+        appendMeshes(sceneGraph, second, instancing, 50);
+        appendMeshes(sceneGraph, first, otherInstancing, 20);
+
+        GLStub::reset();
+        sceneGraph.draw(ProjectionViewMatrix);
+        Test::check(getInstancedDrawCount() == 3, "one instanced draw per geometry and shader pair");
+        Test::check(GLStub::getCallCount("glDrawElements") + GLStub::getCallCount("glDrawArrays") == 0, "instanced meshes issue no single draws");
+        Test::check(GLStub::getCallCount("glBufferData") == 3, "one instance upload per batch");
+        Test::check(sceneGraph.getRenderQueue().size() == 171, "one packet per mesh and the root");
+    }
+
+    {
+        SceneGraph sceneGraph;
+        appendMeshes(sceneGraph, first, individual, 100);
+
+        GLStub::reset();
+        sceneGraph.draw(ProjectionViewMatrix);
+        Test::check(getInstancedDrawCount() == 0, "shaders without PV are not instanced");
+        Test::check(GLStub::getCallCount("glDrawElements") + GLStub::getCallCount("glDrawArrays") == 100, "shaders without PV draw every mesh");
+    }
+
+    // a forest of meshes sharing one geometry still ends up as a single draw
+    {
+        SceneGraph sceneGraph;
+        appendMeshes(sceneGraph, first, instancing, LARGE_MESH_COUNT);
+
+        GLStub::reset();
+        sceneGraph.draw(ProjectionViewMatrix);
+        Test::check(sceneGraph.getRenderQueue().size() == LARGE_MESH_COUNT + 1, "100k meshes: one packet per mesh and the root");
+        Test::check(getInstancedDrawCount() == 1, "100k meshes: one instanced draw");
+        Test::check(GLStub::getCallCount("glBufferData") == 1, "100k meshes: one instance upload");
+    }
+}
@@ -0,0 +1,147 @@
+#include <Test.hpp>
+#include <JobSystem.hpp>
+
+// cpp
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// every index is handed to exactly one chunk, whatever the count and chunking
+static void testParallelFor(JobSystem& jobSystem) {
+    for (const size_t count : { (size_t)0, (size_t)1, (size_t)7, (size_t)10000 }) {
+        for (const size_t chunkCount : { (size_t)0, (size_t)1, (size_t)3, (size_t)64 }) {
+            unique_ptr<atomic<unsigned>[]> visits(new atomic<unsigned>[count + 1]);
+            for (size_t i = 0; i < count; i++) {
+                visits[i] = 0;
+            }
+
+            jobSystem.parallelFor(count, [&visits](const size_t& begin, const size_t& end) {
+                for (size_t i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            }, chunkCount);
+
+            bool once = true;
+            for (size_t i = 0; i < count; i++) {
+                once = once && visits[i] == 1;
+            }
+
+            Test::check(once, "job system: parallel for over " + to_string(count) + " in " + to_string(chunkCount) + " chunks visits every index once");
+        }
+    }
+}
+
+// jobs start once all of their dependencies finished, finished dependencies do not hold them back
+static void testDependencies(JobSystem& jobSystem) {
+    atomic<unsigned> step(0);
+    atomic<unsigned> firstStep(0);
+    atomic<unsigned> secondStep(0);
+    atomic<unsigned> joinStep(0);
+
+    const shared_ptr<JobSystem::Job> first = jobSystem.run([&](void) { firstStep = ++step; });
+    const shared_ptr<JobSystem::Job> second = jobSystem.run([&](void) { secondStep = ++step; }, { first });
+    const shared_ptr<JobSystem::Job> third = jobSystem.run([&](void) { ++step; }, { first });
+    const shared_ptr<JobSystem::Job> join = jobSystem.run([&](void) { joinStep = ++step; }, { second, third });
+    jobSystem.wait(join);
+
+    Test::check(first->finished && second->finished && third->finished, "job system: waiting on a job finishes its dependencies");
+    Test::check(firstStep < secondStep && secondStep < joinStep && joinStep == 4, "job system: jobs run after their dependencies");
+
+    const shared_ptr<JobSystem::Job> late = jobSystem.run([&](void) { ++step; }, { join });
+    jobSystem.wait(late);
+    Test::check(step == 5, "job system: finished dependencies do not hold a job back");
+}
+
+// main lane jobs never run on a worker, even when a worker finished their dependency
+static void testMainThreadLane(JobSystem& jobSystem) {
+    const thread::id mainThreadId = this_thread::get_id();
+    thread::id laneThreadId;
+
+    const shared_ptr<JobSystem::Job> worker = jobSystem.run([](void) {});
+    const shared_ptr<JobSystem::Job> lane = jobSystem.run([&](void) { laneThreadId = this_thread::get_id(); }, { worker }, JobSystem::MAIN_THREAD);
+    jobSystem.wait(worker);
+
+    // waiting on the main thread may already have run it, a worker never does
+    Test::check(laneThreadId == thread::id() || laneThreadId == mainThreadId, "job system: workers leave main lane jobs alone");
+    jobSystem.runMainThreadJobs();
+    Test::check(lane->finished && laneThreadId == mainThreadId, "job system: main lane jobs run on the main thread");
+
+    size_t ran = 0;
+    for (size_t i = 0; i < 10; i++) {
+        jobSystem.run([&ran](void) { ran++; }, {}, JobSystem::MAIN_THREAD);
+    }
+
+    Test::check(jobSystem.runMainThreadJobs() == 10 && ran == 10, "job system: runMainThreadJobs runs every queued main lane job");
+}
+
+// jobs spawned from a worker land in its own queue, the other workers and the waiting thread steal them
+static void testNestedJobs(JobSystem& jobSystem) {
+    const size_t executed = jobSystem.getExecutedCount();
+    atomic<size_t> childCount(0);
+
+    const shared_ptr<JobSystem::Job> parent = jobSystem.run([&](void) {
+        vector<shared_ptr<JobSystem::Job>> children;
+
+        for (size_t i = 0; i < 1000; i++) {
+            children.push_back(jobSystem.run([&childCount](void) { childCount++; }));
+        }
+
+        for (auto& child : children) {
+            jobSystem.wait(child);
+        }
+    });
+
+    jobSystem.wait(parent);
+    Test::check(childCount == 1000, "job system: jobs spawned by jobs all run");
+    Test::check(jobSystem.getExecutedCount() - executed == 1001, "job system: every job is counted once");
+}
+
+// jobs submitted from outside the workers are injected wherever they run, only jobs of a worker are stolen
+static void testInjectedJobs(JobSystem& jobSystem) {
+    const size_t executed = jobSystem.getExecutedCount();
+    const size_t stolen = jobSystem.getStolenCount();
+    const size_t injected = jobSystem.getInjectedCount();
+    vector<shared_ptr<JobSystem::Job>> jobs;
+
+    for (size_t i = 0; i < 100; i++) {
+        jobs.push_back(jobSystem.run([](void) {}));
+    }
+
+    for (auto& job : jobs) {
+        jobSystem.wait(job);
+    }
+
+    Test::check(jobSystem.getInjectedCount() - injected == 100, "job system: jobs run from outside the workers are counted as injected");
+    Test::check(jobSystem.getStolenCount() == stolen && jobSystem.getExecutedCount() - executed == 100, "job system: injected jobs are not counted as stolen");
+}
+
+// jobs still queued or held back by dependencies run before the job system is gone
+static void testDrain(void) {
+    atomic<size_t> ranCount(0);
+    thread::id laneThreadId;
+    {
+        JobSystem jobSystem(2);
+        shared_ptr<JobSystem::Job> previous = nullptr;
+
+        for (size_t i = 0; i < 100; i++) {
+            previous = jobSystem.run([&ranCount](void) { ranCount++; }, previous != nullptr ? vector<shared_ptr<JobSystem::Job>>(1, previous) : vector<shared_ptr<JobSystem::Job>>());
+        }
+
+        jobSystem.run([&](void) { laneThreadId = this_thread::get_id(); }, { previous }, JobSystem::MAIN_THREAD);
+    }
+
+    Test::check(ranCount == 100, "job system: the destructor runs queued jobs and their continuations");
+    Test::check(laneThreadId == this_thread::get_id(), "job system: the destructor runs main lane jobs on the destroying thread");
+}
+
+void testJobSystem(void) {
+    // its own instance, so this thread is its main thread
+    JobSystem jobSystem(3);
+
+    testParallelFor(jobSystem);
+    testDependencies(jobSystem);
+    testMainThreadLane(jobSystem);
+    testNestedJobs(jobSystem);
+    testInjectedJobs(jobSystem);
+    testDrain();
+}
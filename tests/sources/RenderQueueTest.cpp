@@ -0,0 +1,83 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+
+// cpp
+#include <vector>
+
+static shared_ptr<Geometry> makeTriangle(const float& size) {
+    return make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(size, 0.f, 0.f)), Vertex(vec3(0.f, size, 0.f)) }));
+}
+
+static shared_ptr<Shader> makeShader(const vector<string>& activeUniforms) {
+    GLStub::setActiveUniforms(activeUniforms);
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+    return shader;
+}
+
+// packets sorted by state bind every program and vertex array once, however the scene interleaves them
+static void testStateChanges(void) {
+    const vector<shared_ptr<Geometry>> geometries = { makeTriangle(1.f), makeTriangle(2.f) };
+    const vector<shared_ptr<Shader>> shaders = { makeShader({ "PVM", "model" }), makeShader({ "PVM", "model" }), makeShader({ "PVM", "model" }) };
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < 30; i++) {
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometries[i % 2], "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i - 15.f, 0.f, -40.f))));
+        mesh->setShader(shaders[i % 3]);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    const RenderQueue& renderQueue = sceneGraph.getRenderQueue();
+
+    // the root is queued as well but draws nothing
+    Test::check(renderQueue.getDrawCount() == 31, "state changes: one draw per packet");
+    Test::check(GLStub::getCallCount("glDrawArrays") + GLStub::getCallCount("glDrawElements") == 30, "state changes: one draw call per mesh");
+    Test::check(renderQueue.getBindCount() == 9, "state changes: one bind per program and per vertex array within it");
+    Test::check(renderQueue.getSkippedBindCount() == 51, "state changes: the other binds of the 60 in tree order are skipped");
+    Test::check(GLStub::getCallCount("glUseProgram") == 3, "state changes: programs bound through GL");
+    // the queue unbinds the vertex array once at the end
+    Test::check(GLStub::getCallCount("glBindVertexArray") == 7, "state changes: vertex arrays bound through GL");
+}
+
+// keys hold dense indices, and programs that still share a key are never drawn as one batch
+static void testAliasing(void) {
+    RenderQueue renderQueue;
+    Test::check(renderQueue.getProgramIndex(1) == 0 && renderQueue.getProgramIndex(1 + 4096) == 1, "aliasing: programs get dense indices");
+    Test::check(renderQueue.getProgramIndex(1) == 0, "aliasing: indices are stable within a frame");
+    Test::check(
+        RenderQueue::makeKey(0, renderQueue.getProgramIndex(1), 0, 0, 0, 1.f) != RenderQueue::makeKey(0, renderQueue.getProgramIndex(1 + 4096), 0, 0, 0, 1.f),
+        "aliasing: programs whose names share the low bits get different keys"
+    );
+
+    renderQueue.clear();
+    Test::check(renderQueue.getProgramIndex(1 + 4096) == 0, "aliasing: clear starts the indices over");
+
+    const shared_ptr<Geometry> geometry = makeTriangle(1.f);
+    const shared_ptr<Shader> first = makeShader({ "PVM", "model", "PV" });
+    const shared_ptr<Shader> second = makeShader({ "PVM", "model", "PV" });
+    Mesh firstMesh(geometry, "first");
+    Mesh secondMesh(geometry, "second");
+    firstMesh.setShader(first);
+    secondMesh.setShader(second);
+    const CachedTransform worldTransform;
+
+    // the same key and batch for both, as wrapped indices would give
+    renderQueue.clear();
+    renderQueue.push(0, &firstMesh, &worldTransform, geometry.get(), first->getId(), geometry->getVAO());
+    renderQueue.push(0, &secondMesh, &worldTransform, geometry.get(), second->getId(), geometry->getVAO());
+
+    GLStub::reset();
+    renderQueue.submit(mat4(1.f));
+    Test::check(renderQueue.getDrawCount() == 2, "aliasing: a shared key does not join different programs");
+    Test::check(GLStub::getCallCount("glUseProgram") == 2, "aliasing: each program is bound for its own draw");
+}
+
+void testRenderQueue(void) {
+    testStateChanges();
+    testAliasing();
+}
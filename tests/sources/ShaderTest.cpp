@@ -0,0 +1,99 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+#include <SceneGraph.hpp>
+#include <Mesh.hpp>
+#include <GLDeletionQueue.hpp>
+
+// cpp
+#include <vector>
+
+static size_t getUniformUploadCount(void) {
+    return GLStub::getCallCount("glUniformMatrix4fv") + GLStub::getCallCount("glUniform4fv");
+}
+
+// a scene of meshes sharing one shader, drawn twice from the same camera
+static void checkFrames(const string& name, const vector<string>& activeUniforms, const size_t& firstUploadCount, const size_t& secondUploadCount) {
+    const shared_ptr<Geometry> geometry = make_shared<Geometry>(vector<Vertex>({ Vertex(vec3(0.f, 0.f, 0.f)), Vertex(vec3(1.f, 0.f, 0.f)), Vertex(vec3(0.f, 1.f, 0.f)) }));
+    GLStub::setActiveUniforms(activeUniforms);
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    GLStub::setActiveUniforms({ "PVM", "model", "PV" });
+
+    const mat4 ProjectionViewMatrix = perspective(radians(90.f), 1.f, 0.1f, 100.f);
+    SceneGraph sceneGraph;
+
+    for (size_t i = 0; i < 10; i++) {
+        const shared_ptr<Mesh> mesh = make_shared<Mesh>(geometry, "mesh", Transform(fdualquat(fquat(1.f, 0.f, 0.f, 0.f), vec3((float)i - 5.f, 0.f, -20.f))));
+        mesh->setShader(shader);
+        sceneGraph.getRoot()->appendChild(mesh);
+    }
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(GLStub::getCallCount("glGetUniformLocation") == 0, name + ": drawing resolves no uniform locations");
+    Test::check(getUniformUploadCount() == firstUploadCount, name + ": uniforms uploaded by the first frame");
+
+    GLStub::reset();
+    sceneGraph.draw(ProjectionViewMatrix);
+    Test::check(getUniformUploadCount() == secondUploadCount, name + ": uniforms uploaded by an unchanged frame");
+}
+
+// copies share the program, so what one of them sent is known to the others, and it is deleted once
+static void testCopies(void) {
+    const mat4 identity(1.f);
+    const mat4 translation = translate(mat4(1.f), vec3(1.f, 2.f, 3.f));
+    GLDeletionQueue::getShared().flush();
+    {
+        const Shader original(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+        const Shader copy(original);
+
+        GLStub::reset();
+        original.setMat4("PVM", value_ptr(identity));
+        copy.setMat4("PVM", value_ptr(identity));
+        Test::check(GLStub::getCallCount("glUniformMatrix4fv") == 1, "copies: a value sent through one copy is not sent again through the other");
+
+        copy.setMat4("PVM", value_ptr(translation));
+        original.setMat4("PVM", value_ptr(identity));
+        Test::check(GLStub::getCallCount("glUniformMatrix4fv") == 3, "copies: a value changed through a copy is sent again through the original");
+    }
+
+    GLStub::reset();
+    GLDeletionQueue::getShared().flush();
+    Test::check(GLStub::getCallCount("glDeleteProgram") == 1, "copies: the program is deleted once");
+}
+
+// locations are resolved once after linking and unchanged values are not sent again
+void testUniforms(void) {
+    const shared_ptr<Shader> shader = make_shared<Shader>(GLStub::getVertexShaderPath(), GLStub::getFragmentShaderPath());
+    Test::check(GLStub::getCallCount("glGetUniformLocation") == 3, "one location query per active uniform");
+    Test::check(shader->getUniformHandle("PVM") >= 0 && shader->getUniformHandle("model") >= 0 && shader->getUniformHandle("PV") >= 0, "active uniforms have handles");
+    Test::check(shader->getUniformHandle("missing") == -1, "unknown names have no handle");
+
+    const mat4 identity(1.f);
+    const mat4 translation = translate(mat4(1.f), vec3(1.f, 2.f, 3.f));
+    const vec4 color(1.f, 0.f, 0.f, 1.f);
+
+    GLStub::reset();
+    shader->setMat4("PVM", value_ptr(identity));
+    shader->setMat4("PVM", value_ptr(identity));
+    shader->setMat4(shader->getUniformHandle("PVM"), value_ptr(identity));
+    Test::check(GLStub::getCallCount("glUniformMatrix4fv") == 1, "an unchanged matrix is sent once");
+    Test::check(GLStub::getCallCount("glGetUniformLocation") == 0, "setting by name resolves no location");
+
+    shader->setMat4("PVM", value_ptr(translation));
+    shader->setMat4("model", value_ptr(translation));
+    Test::check(GLStub::getCallCount("glUniformMatrix4fv") == 3, "changed values and other uniforms are sent");
+
+    shader->setVec4("PV", value_ptr(color));
+    shader->setVec4("PV", value_ptr(color));
+    Test::check(GLStub::getCallCount("glUniform4fv") == 1, "an unchanged vector is sent once");
+
+    shader->setMat4("missing", value_ptr(identity));
+    shader->setMat4(-1, value_ptr(identity));
+    Test::check(getUniformUploadCount() == 4, "unknown uniforms are not sent");
+
+    // drawn one at a time every mesh sends its own matrices, instanced the batch sends the camera once
+    checkFrames("individual draws", { "PVM", "model" }, 20, 20);
+    checkFrames("instanced draws", { "PVM", "model", "PV" }, 1, 0);
+
+    testCopies();
+}
@@ -0,0 +1,21 @@
+#include <Test.hpp>
+
+size_t Test::checkCount = 0;
+size_t Test::failureCount = 0;
+
+void Test::check(const bool& condition, const string& description) {
+    checkCount++;
+
+    if (!condition) {
+        failureCount++;
+        cout << "FAILED: " << description << endl;
+    }
+}
+
+const size_t& Test::getCheckCount(void) noexcept {
+    return checkCount;
+}
+
+const size_t& Test::getFailureCount(void) noexcept {
+    return failureCount;
+}
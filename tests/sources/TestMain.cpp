@@ -0,0 +1,40 @@
+#include <Test.hpp>
+#include <GLStub.hpp>
+
+// cpp
+#include <vector>
+
+int main(int argc, char** argv) {
+    GLStub::install();
+
+    const vector<pair<string, function<void(void)>>> tests = {
+        { "culling", testCulling },
+        { "uniforms", testUniforms },
+        { "render queue", testRenderQueue },
+        { "instancing", testInstancing },
+        { "vertex formats", testVertexFormats },
+        { "indirect", testIndirect },
+        { "dual quaternions", testDualQuaternions },
+        { "job system", testJobSystem },
+        { "destroy", testDestroy }
+    };
+
+    // names given on the command line select which tests run
+    for (auto& test : tests) {
+        bool selected = argc < 2;
+
+        for (int i = 1; i < argc; i++) {
+            selected = selected || test.first == argv[i];
+        }
+
+        if (selected) {
+            cout << "[" << test.first << "]" << endl;
+            GLStub::reset();
+            test.second();
+        }
+    }
+
+    cout << Test::getCheckCount() << " checks, " << Test::getFailureCount() << " failed" << endl;
+
+    return Test::getFailureCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,169 @@
+#include <Test.hpp>
+#include <VertexFormat.hpp>
+
+// cpp
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <glm\gtc\packing.hpp>
+
+static const size_t VERTEX_COUNT = 10000;
+
+// largest error of every attribute after a round trip through a format
+class RoundTripError {
+public:
+    float position = 0.f;
+    // angle between the normals, in degrees
+    float normal = 0.f;
+    float color = 0.f;
+    float texCoord = 0.f;
+};
+
+static vector<Vertex> makeVertices(const vec3& center, const float& radius, const float& texCoordRange) {
+    // a fixed seed, so every run checks the same vertices
+    mt19937 generator(7);
+    uniform_real_distribution<float> unit(-1.f, 1.f);
+    uniform_real_distribution<float> positive(0.f, 1.f);
+    vector<Vertex> vertices;
+
+    while (vertices.size() < VERTEX_COUNT) {
+        const vec3 offset(unit(generator), unit(generator), unit(generator));
+        const vec3 normal(unit(generator), unit(generator), unit(generator));
+
+        if (length(offset) > 1.f || length(normal) < 0.01f) {
+            continue;
+        }
+
+        vertices.push_back(Vertex(
+            center + offset * radius,
+            normalize(normal),
+            vec3(positive(generator), positive(generator), positive(generator)),
+            vec2(positive(generator), positive(generator)) * texCoordRange
+        ));
+    }
+
+    return vertices;
+}
+
+// in degrees. acos loses too much near a cosine of 1 in float
+static float getAngle(const vec3& a, const vec3& b) noexcept {
+    return degrees(atan2(length(cross(a, b)), dot(a, b)));
+}
+
+static float getLargestDifference(const vec3& a, const vec3& b) noexcept {
+    const vec3 difference = glm::abs(a - b);
+    return glm::max(difference.x, glm::max(difference.y, difference.z));
+}
+
+static float getLargestDifference(const vec2& a, const vec2& b) noexcept {
+    const vec2 difference = glm::abs(a - b);
+    return glm::max(difference.x, difference.y);
+}
+
+template <typename T>
+static T read(const unsigned char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+static RoundTripError measureRoundTrip(const VertexFormat& format, const vector<Vertex>& vertices, const BoundingSphere& bounds) {
+    vector<unsigned char> buffer;
+    format.encode(vertices, bounds, buffer);
+
+    const mat4 positionDecode = format.getPositionDecode(bounds);
+    const vector<VertexAttribute>& attributes = format.getAttributes();
+    RoundTripError error;
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const unsigned char* vertex = buffer.data() + i * format.getStride();
+        vec3 position;
+        vec3 normal;
+        vec3 color;
+        vec2 texCoord;
+
+        switch (format.getPositionEncoding()) {
+        case VertexFormat::POSITION_FLOAT: position = read<vec3>(vertex + attributes[0].offset); break;
+        case VertexFormat::POSITION_HALF: position = vec3(unpackHalf4x16(read<uint64_t>(vertex + attributes[0].offset))); break;
+        case VertexFormat::POSITION_SNORM16: position = vec3(unpackSnorm4x16(read<uint64_t>(vertex + attributes[0].offset))); break;
+        }
+
+        switch (format.getNormalEncoding()) {
+        case VertexFormat::NORMAL_FLOAT: normal = read<vec3>(vertex + attributes[1].offset); break;
+        case VertexFormat::NORMAL_OCTAHEDRAL_SNORM16: normal = VertexFormat::decodeOctahedral(unpackSnorm2x16(read<uint32_t>(vertex + attributes[1].offset))); break;
+        }
+
+        switch (format.getColorEncoding()) {
+        case VertexFormat::COLOR_FLOAT: color = read<vec3>(vertex + attributes[2].offset); break;
+        case VertexFormat::COLOR_RGBA8: color = vec3(unpackUnorm4x8(read<uint32_t>(vertex + attributes[2].offset))); break;
+        }
+
+        switch (format.getTexCoordEncoding()) {
+        case VertexFormat::TEXCOORD_FLOAT: texCoord = read<vec2>(vertex + attributes[3].offset); break;
+        case VertexFormat::TEXCOORD_HALF: texCoord = unpackHalf2x16(read<uint32_t>(vertex + attributes[3].offset)); break;
+        case VertexFormat::TEXCOORD_UNORM16: texCoord = unpackUnorm2x16(read<uint32_t>(vertex + attributes[3].offset)); break;
+        }
+
+        position = vec3(positionDecode * vec4(position, 1.f));
+
+        error.position = glm::max(error.position, getLargestDifference(position, vertices[i].position));
+        error.normal = glm::max(error.normal, getAngle(normal, vertices[i].normal));
+        error.color = glm::max(error.color, getLargestDifference(color, vertices[i].color));
+        error.texCoord = glm::max(error.texCoord, getLargestDifference(texCoord, vertices[i].texCoord));
+    }
+
+    return error;
+}
+
+// quantized positions are relative to the bounds, so their error scales with the radius and not with the distance from the origin
+void testVertexFormats(void) {
+    const vec3 center(1000.f, -250.f, 40.f);
+    const float radius = 8.f;
+    const BoundingSphere bounds(center, radius);
+    const vector<Vertex> vertices = makeVertices(center, radius, 1.f);
+
+    Test::check(VertexFormat().getStride() == sizeof(Vertex), "float format: the stride of a Vertex");
+    Test::check(VertexFormat::compact().getStride() == 20, "compact format: 20 bytes per vertex");
+
+    const RoundTripError floatError = measureRoundTrip(VertexFormat(), vertices, bounds);
+    Test::check(floatError.position == 0.f && floatError.color == 0.f && floatError.texCoord == 0.f, "float format: exact round trip");
+
+    // rounding to the nearest step, half a step of each encoding at most
+    const RoundTripError snormError = measureRoundTrip(VertexFormat(VertexFormat::POSITION_SNORM16), vertices, bounds);
+    Test::check(snormError.position <= radius * 0.5f / 32767.f * 1.01f, "snorm16 positions: within half a step of the radius");
+
+    // values below 1 have at least 11 significant bits
+    const RoundTripError halfError = measureRoundTrip(VertexFormat(VertexFormat::POSITION_HALF), vertices, bounds);
+    Test::check(halfError.position <= radius * exp2(-12.f) * 1.01f, "half positions: within half an ulp of the radius");
+    Test::check(halfError.position > 0.f && snormError.position < halfError.position, "snorm16 positions: more precise than half");
+
+    const RoundTripError compactError = measureRoundTrip(VertexFormat::compact(), vertices, bounds);
+    Test::check(compactError.normal <= 0.01f, "octahedral normals: within 0.01 degrees");
+    Test::check(compactError.color <= 0.5f / 255.f * 1.01f, "RGBA8 colors: within half a step");
+    Test::check(compactError.texCoord <= 0.5f / 65535.f * 1.01f, "unorm16 coordinates: within half a step");
+
+    // repeating coordinates need half floats, with the error growing with the range
+    const float texCoordRange = 4.f;
+    const vector<Vertex> repeating = makeVertices(center, radius, texCoordRange);
+    const RoundTripError halfTexCoordError = measureRoundTrip(
+        VertexFormat(VertexFormat::POSITION_FLOAT, VertexFormat::NORMAL_FLOAT, VertexFormat::COLOR_FLOAT, VertexFormat::TEXCOORD_HALF),
+        repeating,
+        bounds
+    );
+    Test::check(halfTexCoordError.texCoord <= texCoordRange * exp2(-12.f) * 1.01f, "half coordinates: within half an ulp of the range");
+
+    // the axes and the folded lower half are where octahedral encodings tend to break
+    const vector<vec3> edgeNormals = {
+        vec3(1.f, 0.f, 0.f), vec3(-1.f, 0.f, 0.f), vec3(0.f, 1.f, 0.f), vec3(0.f, -1.f, 0.f), vec3(0.f, 0.f, 1.f), vec3(0.f, 0.f, -1.f),
+        normalize(vec3(1.f, 1.f, -1.f)), normalize(vec3(-1.f, 1.f, -1.f)), normalize(vec3(1.f, -1.f, -1.f)), normalize(vec3(-1.f, -1.f, -1.f))
+    };
+    float edgeError = 0.f;
+
+    for (auto& normal : edgeNormals) {
+        const vec3 decoded = VertexFormat::decodeOctahedral(unpackSnorm2x16(packSnorm2x16(VertexFormat::encodeOctahedral(normal))));
+        edgeError = glm::max(edgeError, getAngle(decoded, normal));
+    }
+
+    Test::check(edgeError <= 0.01f, "octahedral normals: axes and lower half within 0.01 degrees");
+}